@@ -0,0 +1,138 @@
+// needed for clock_gettime
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <time.h>
+
+#include "bench_grid.h"
+
+/// Najmniejsza długość odcinka kratownicy.
+#define MIN_LENGTH 1
+/// Największa długość odcinka kratownicy.
+#define MAX_LENGTH 100
+/// Najwcześniejszy rok budowy odcinka kratownicy.
+#define MIN_YEAR 1900
+/// Najpóźniejszy rok budowy odcinka kratownicy.
+#define MAX_YEAR 2020
+/// Początkowy stan generatora losującego miasta dróg krajowych.
+#define ROUTES_SEED 0x9e3779b97f4a7c15ULL
+/// Mnożnik sumy kontrolnej (FNV-1a).
+#define FNV_PRIME 0x100000001b3ULL
+
+double benchNow(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec * 1e3 + (double)t.tv_nsec / 1e6;
+}
+
+uint64_t benchRandom(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+void gridCityName(char *name, int x, int y) {
+    snprintf(name, GRID_NAME_LENGTH, "c%d_%d", x, y);
+}
+
+/** @brief Dopisuje odcinek o losowej długości i roku budowy.
+ * @param[in,out] grid      - kratownica z miejscem na kolejny odcinek
+ * @param[in] x1            - numer kolumny pierwszego miasta
+ * @param[in] y1            - numer wiersza pierwszego miasta
+ * @param[in] x2            - numer kolumny drugiego miasta
+ * @param[in] y2            - numer wiersza drugiego miasta
+ * @param[in,out] state     - stan generatora liczb pseudolosowych
+ */
+static void appendRoad(Grid *grid, int x1, int y1, int x2, int y2,
+                       uint64_t *state) {
+    GridRoad *r = &grid->roads[grid->roads_no++];
+    r->x1 = x1;
+    r->y1 = y1;
+    r->x2 = x2;
+    r->y2 = y2;
+    r->length = MIN_LENGTH +
+                (unsigned)(benchRandom(state) % (MAX_LENGTH - MIN_LENGTH + 1));
+    r->year = MIN_YEAR + (int)(benchRandom(state) % (MAX_YEAR - MIN_YEAR + 1));
+}
+
+Status newGrid(Grid *grid, int size, uint64_t *state) {
+    grid->size = size;
+    grid->roads_no = 0;
+    grid->roads = malloc(2 * (size_t)size * (size_t)size * sizeof(GridRoad));
+    CHECK_RET(grid->roads);
+    for (int x = 0; x < size; ++x) {
+        for (int y = 0; y < size; ++y) {
+            if (x + 1 < size) {
+                appendRoad(grid, x, y, x + 1, y, state);
+            }
+            if (y + 1 < size) {
+                appendRoad(grid, x, y, x, y + 1, state);
+            }
+        }
+    }
+    return true;
+}
+
+void deleteGrid(Grid *grid) {
+    free(grid->roads);
+    grid->roads = NULL;
+    grid->roads_no = 0;
+}
+
+void shuffleGrid(Grid *grid, uint64_t *state) {
+    for (size_t i = grid->roads_no; i > 1; --i) {
+        size_t j = (size_t)(benchRandom(state) % i);
+        GridRoad r = grid->roads[i - 1];
+        grid->roads[i - 1] = grid->roads[j];
+        grid->roads[j] = r;
+    }
+}
+
+void randomGridCities(const Grid *grid, uint64_t *state, char *city1,
+                      char *city2) {
+    uint64_t size = (uint64_t)grid->size;
+    int x1, y1, x2, y2;
+    do {
+        x1 = (int)(benchRandom(state) % size);
+        y1 = (int)(benchRandom(state) % size);
+        x2 = (int)(benchRandom(state) % size);
+        y2 = (int)(benchRandom(state) % size);
+    } while (x1 == x2 && y1 == y2);
+    gridCityName(city1, x1, y1);
+    gridCityName(city2, x2, y2);
+}
+
+bool addGridRoads(Map *map, const Grid *grid) {
+    char city1[GRID_NAME_LENGTH], city2[GRID_NAME_LENGTH];
+    for (size_t i = 0; i < grid->roads_no; ++i) {
+        const GridRoad *r = &grid->roads[i];
+        gridCityName(city1, r->x1, r->y1);
+        gridCityName(city2, r->x2, r->y2);
+        CHECK_RET(addRoad(map, city1, city2, r->length, r->year));
+    }
+    return true;
+}
+
+bool runGridRoutes(Map *map, const Grid *grid, unsigned routes,
+                   uint64_t *checksum) {
+    char city1[GRID_NAME_LENGTH], city2[GRID_NAME_LENGTH];
+    uint64_t state = ROUTES_SEED;
+    *checksum = 0;
+    for (unsigned i = 0; i < routes; ++i) {
+        randomGridCities(grid, &state, city1, city2);
+        if (!newRoute(map, 1, city1, city2)) {
+            // Droga nie jest wyznaczona jednoznacznie.
+            *checksum = (*checksum ^ i) * FNV_PRIME;
+            continue;
+        }
+        const char *description = getRouteDescription(map, 1);
+        CHECK_RET(description);
+        for (const char *c = description; *c != '\0'; ++c) {
+            *checksum = (*checksum ^ (uint8_t)*c) * FNV_PRIME;
+        }
+        free((void *)description);
+        CHECK_RET(removeRoute(map, 1));
+    }
+    return true;
+}
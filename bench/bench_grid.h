@@ -0,0 +1,115 @@
+/** @file
+ * Wspólne narzędzia programów pomiarowych: pomiar czasu, generator liczb
+ * pseudolosowych i mapy w kształcie kratownicy.
+ */
+#ifndef __BENCH_GRID_H__
+#define __BENCH_GRID_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "map.h"
+
+/// Największa długość nazwy miasta kratownicy (wraz z bajtem zerowym).
+#define GRID_NAME_LENGTH 32
+
+/**
+ * Odcinek drogowy kratownicy, łączący miasta o podanych współrzędnych.
+ */
+typedef struct GridRoad {
+    /// współrzędne pierwszego miasta
+    int x1, y1;
+    /// współrzędne drugiego miasta
+    int x2, y2;
+    /// długość odcinka
+    unsigned length;
+    /// rok budowy lub ostatniego remontu
+    int year;
+} GridRoad;
+
+/**
+ * Kratownica @p size x @p size miast, w której sąsiednie miasta łączą odcinki
+ * o losowych długościach i latach budowy.
+ */
+typedef struct Grid {
+    /// liczba miast w wierszu i w kolumnie
+    int size;
+    /// odcinki drogowe
+    GridRoad *roads;
+    /// liczba odcinków
+    size_t roads_no;
+} Grid;
+
+/** @brief Zwraca czas monotonicznego zegara.
+ * @return Czas w milisekundach.
+ */
+double benchNow(void);
+
+/** @brief Losuje kolejną liczbę pseudolosową (xorshift64).
+ * @param[in,out] state     - niezerowy stan generatora
+ * @return Liczba pseudolosowa.
+ */
+uint64_t benchRandom(uint64_t *state);
+
+/** @brief Zapisuje nazwę miasta kratownicy.
+ * @param[out] name         - bufor na co najmniej @ref GRID_NAME_LENGTH znaków
+ * @param[in] x             - numer kolumny
+ * @param[in] y             - numer wiersza
+ */
+void gridCityName(char *name, int x, int y);
+
+/** @brief Tworzy kratownicę.
+ * Odcinki są uporządkowane wierszami, więc miasta dodawane w tej kolejności
+ * dostają numery zgodne z układem kratownicy.
+ * @param[out] grid         - tworzona kratownica
+ * @param[in] size          - liczba miast w wierszu i w kolumnie
+ * @param[in,out] state     - stan generatora liczb pseudolosowych
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status newGrid(Grid *grid, int size, uint64_t *state);
+
+/** @brief Zwalnia pamięć zajmowaną przez kratownicę.
+ * @param[in,out] grid      - kratownica
+ */
+void deleteGrid(Grid *grid);
+
+/** @brief Losowo przestawia odcinki kratownicy.
+ * Miasta dodawane w nowej kolejności dostają numery niezwiązane z układem
+ * kratownicy.
+ * @param[in,out] grid      - kratownica
+ * @param[in,out] state     - stan generatora liczb pseudolosowych
+ */
+void shuffleGrid(Grid *grid, uint64_t *state);
+
+/** @brief Losuje dwa różne miasta kratownicy.
+ * @param[in] grid          - kratownica
+ * @param[in,out] state     - stan generatora liczb pseudolosowych
+ * @param[out] city1        - bufor na nazwę pierwszego miasta
+ * @param[out] city2        - bufor na nazwę drugiego miasta
+ */
+void randomGridCities(const Grid *grid, uint64_t *state, char *city1,
+                      char *city2);
+
+/** @brief Dodaje odcinki kratownicy do mapy w kolejności ich zapisania.
+ * @param[in,out] map       - mapa dróg
+ * @param[in] grid          - kratownica
+ * @return Wartość @p true, jeśli dodano wszystkie odcinki, @p false wpp.
+ */
+bool addGridRoads(Map *map, const Grid *grid);
+
+/** @brief Wyznacza drogi krajowe między losowymi miastami kratownicy.
+ * Każda droga jest opisywana i usuwana, zanim zostanie wyznaczona następna.
+ * Pary miast, między którymi droga nie jest wyznaczona jednoznacznie, są
+ * pomijane. Kolejne wywołania wyznaczają te same drogi.
+ * @param[in,out] map       - mapa zawierająca odcinki kratownicy
+ * @param[in] grid          - kratownica
+ * @param[in] routes        - liczba dróg krajowych
+ * @param[out] checksum     - suma kontrolna opisów dróg
+ * @return Wartość @p false, jeśli nastąpił błąd alokacji pamięci, @p true
+ * wpp.
+ */
+bool runGridRoutes(Map *map, const Grid *grid, unsigned routes,
+                   uint64_t *checksum);
+
+#endif /* __BENCH_GRID_H__ */
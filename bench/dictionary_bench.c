@@ -0,0 +1,283 @@
+/** @file
+ * Porównanie słownika (@ref Dictionary) z poprzednią implementacją
+ * z liniowym szukaniem (@ref LegacyDictionary).
+ *
+ * Użycie: dictionary_bench [liczba kluczy]
+ *
+ * Mierzy wstawianie, trafione i chybione wyszukiwania oraz usuwanie
+ * i ponowne wstawianie kluczy dla nazw miast i kluczy odcinków drogowych.
+ * Nazwy miast są skracane wielomianem o podstawie 149, którego używał
+ * program w czasie zmiany implementacji słownika, oraz obecną funkcją
+ * @ref hashString. Wypisuje najkrótszy z pięciu czasów.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "bench_grid.h"
+#include "legacy_dictionary.h"
+#include "utils.h"
+
+/// Liczba powtórzeń każdego pomiaru.
+#define REPEATS 5
+/// Liczba przejść wyszukiwań po wszystkich kluczach.
+#define LOOKUP_ROUNDS 5
+/// Liczba rund usuwania i ponownego wstawiania połowy kluczy.
+#define CHURN_ROUNDS 3
+/// Długość bufora na nazwę miasta.
+#define NAME_LENGTH 32
+
+/**
+ * Operacje badanej implementacji słownika.
+ */
+typedef struct Table {
+    /// nazwa implementacji
+    const char *name;
+    /// tworzy pusty słownik
+    void *(*create)(hash_t (*)(void *), bool (*)(void *, void *));
+    /// usuwa słownik
+    void (*destroy)(void *);
+    /// wstawia element
+    Status (*insert)(void *, void *, void *);
+    /// znajduje element
+    Entry (*get)(void *, void *);
+    /// usuwa element
+    void (*remove)(void *, void *);
+} Table;
+
+/**
+ * Czasy operacji na jednym zbiorze kluczy, w milisekundach.
+ */
+typedef struct Timings {
+    /// wstawienie wszystkich kluczy
+    double insert;
+    /// wyszukiwania obecnych kluczy
+    double hit;
+    /// wyszukiwania nieobecnych kluczy
+    double miss;
+    /// usuwanie i ponowne wstawianie połowy kluczy
+    double churn;
+} Timings;
+
+/**
+ * Zbiór kluczy: obecne i nieobecne w słowniku.
+ */
+typedef struct KeySet {
+    /// opis zbioru
+    const char *name;
+    /// funkcja skrótu
+    hash_t (*hash)(void *);
+    /// funkcja porównująca klucze
+    bool (*equal)(void *, void *);
+    /// klucze wstawiane do słownika
+    void **keys;
+    /// klucze, których nie ma w słowniku
+    void **missing;
+} KeySet;
+
+// Funkcje dostosowujące obie implementacje do wspólnego interfejsu Table.
+
+static void *createDictionary(hash_t (*hash)(void *),
+                              bool (*equal)(void *, void *)) {
+    return newDictionary(hash, equal, empty, empty);
+}
+
+static void destroyDictionary(void *dictionary) {
+    deleteDictionary(dictionary);
+    free(dictionary);
+}
+
+static Status insertIntoDictionary(void *dictionary, void *key, void *val) {
+    return insertDictionary(dictionary, key, val);
+}
+
+static Entry getFromDictionary(void *dictionary, void *key) {
+    return getDictionary(dictionary, key);
+}
+
+static void removeFromDictionary(void *dictionary, void *key) {
+    deleteFromDictionary(dictionary, key);
+}
+
+static void *createLegacy(hash_t (*hash)(void *),
+                          bool (*equal)(void *, void *)) {
+    return newLegacyDictionary(hash, equal);
+}
+
+static void destroyLegacy(void *dictionary) {
+    deleteLegacyDictionary(dictionary);
+}
+
+static Status insertIntoLegacy(void *dictionary, void *key, void *val) {
+    return insertLegacyDictionary(dictionary, key, val);
+}
+
+static Entry getFromLegacy(void *dictionary, void *key) {
+    return getLegacyDictionary(dictionary, key);
+}
+
+static void removeFromLegacy(void *dictionary, void *key) {
+    deleteFromLegacyDictionary(dictionary, key);
+}
+
+/// Badane implementacje: poprzednia i obecna.
+static const Table TABLES[] = {
+    {"old", createLegacy, destroyLegacy, insertIntoLegacy, getFromLegacy,
+     removeFromLegacy},
+    {"new", createDictionary, destroyDictionary, insertIntoDictionary,
+     getFromDictionary, removeFromDictionary}};
+
+/** @brief Skraca napis wielomianem o podstawie 149 (bez ziarna).
+ * @param[in] str           - napis w stylu C
+ * @return Skrót napisu.
+ */
+static hash_t polynomialHash(void *str) {
+    hash_t ret = 0;
+    for (const uint8_t *c = str; *c != '\0'; ++c) {
+        ret = ret * 149 + *c;
+    }
+    return ret;
+}
+
+/** @brief Skraca klucz odcinka drogowego.
+ * @param[in] key           - klucz utworzony przez @ref edgeKey
+ * @return Skrót klucza.
+ */
+static hash_t hashEdgeKey(void *key) { return hashMix((uint64_t)key); }
+
+/** @brief Porównuje klucze odcinków drogowych.
+ * @param[in] a             - pierwszy klucz
+ * @param[in] b             - drugi klucz
+ * @return Wartość @p true, jeśli klucze są równe i nie oznaczają pustej ani
+ * usuniętej komórki, @p false wpp.
+ */
+static bool equalEdgeKeys(void *a, void *b) {
+    if (a == NULL || a == DELETED || b == NULL || b == DELETED) {
+        return false;
+    }
+    return a == b;
+}
+
+/** @brief Mierzy operacje jednej implementacji na jednym zbiorze kluczy.
+ * @param[in] table         - implementacja słownika
+ * @param[in] set           - zbiór kluczy
+ * @param[in] n             - liczba kluczy
+ * @param[out] t            - zmierzone czasy
+ * @param[in,out] sink      - suma odczytanych wartości
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status measure(const Table *table, const KeySet *set, size_t n,
+                      Timings *t, size_t *sink) {
+    void *d = table->create(set->hash, set->equal);
+    CHECK_RET(d);
+    double t0 = benchNow();
+    for (size_t i = 0; i < n; ++i) {
+        if (!table->insert(d, set->keys[i], (void *)(uintptr_t)(i + 1))) {
+            table->destroy(d);
+            return false;
+        }
+    }
+    double t1 = benchNow();
+    for (int r = 0; r < LOOKUP_ROUNDS; ++r) {
+        for (size_t i = 0; i < n; ++i) {
+            *sink += (uintptr_t)table->get(d, set->keys[i]).val;
+        }
+    }
+    double t2 = benchNow();
+    for (int r = 0; r < LOOKUP_ROUNDS; ++r) {
+        for (size_t i = 0; i < n; ++i) {
+            *sink += (uintptr_t)table->get(d, set->missing[i]).val;
+        }
+    }
+    double t3 = benchNow();
+    for (int r = 0; r < CHURN_ROUNDS; ++r) {
+        for (size_t i = 0; i < n; i += 2) {
+            table->remove(d, set->keys[i]);
+        }
+        for (size_t i = 0; i < n; i += 2) {
+            if (!table->insert(d, set->keys[i], (void *)(uintptr_t)(i + 1))) {
+                table->destroy(d);
+                return false;
+            }
+        }
+    }
+    double t4 = benchNow();
+    table->destroy(d);
+    *t = (const Timings){t1 - t0, t2 - t1, t3 - t2, t4 - t3};
+    return true;
+}
+
+/** @brief Mierzy obie implementacje na zbiorze kluczy i wypisuje wyniki.
+ * @param[in] set           - zbiór kluczy
+ * @param[in] n             - liczba kluczy
+ * @param[in,out] sink      - suma odczytanych wartości
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status compare(const KeySet *set, size_t n, size_t *sink) {
+    printf("%s\n", set->name);
+    for (size_t k = 0; k < sizeof(TABLES) / sizeof(TABLES[0]); ++k) {
+        Timings best = {0, 0, 0, 0};
+        for (int r = 0; r < REPEATS; ++r) {
+            Timings t;
+            CHECK_RET(measure(&TABLES[k], set, n, &t, sink));
+            if (r == 0 || t.insert < best.insert) {
+                best.insert = t.insert;
+            }
+            if (r == 0 || t.hit < best.hit) {
+                best.hit = t.hit;
+            }
+            if (r == 0 || t.miss < best.miss) {
+                best.miss = t.miss;
+            }
+            if (r == 0 || t.churn < best.churn) {
+                best.churn = t.churn;
+            }
+        }
+        printf("  %s: insert %7.1f ms  %dx hits %7.1f ms  %dx misses %7.1f ms"
+               "  churn %7.1f ms\n",
+               TABLES[k].name, best.insert, LOOKUP_ROUNDS, best.hit,
+               LOOKUP_ROUNDS, best.miss, best.churn);
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? (size_t)atol(argv[1]) : 200000;
+    seedStringHash();
+
+    char (*names)[NAME_LENGTH] = malloc(2 * n * sizeof(*names));
+    void **keys = malloc(4 * n * sizeof(void *));
+    size_t sink = 0;
+    int ret = 1;
+    if (names == NULL || keys == NULL) {
+        goto CLEANUP;
+    }
+    // Nazwy jak w kratownicy 450 x n/450: c<wiersz>_<kolumna>.
+    for (size_t i = 0; i < n; ++i) {
+        snprintf(names[i], NAME_LENGTH, "c%zu_%zu", i / 450, i % 450);
+        snprintf(names[n + i], NAME_LENGTH, "x%zu_%zu", i / 450, i % 450);
+        keys[i] = names[i];
+        keys[n + i] = names[n + i];
+        keys[2 * n + i] =
+            (void *)(uintptr_t)edgeKey((int)i, (int)(i + 1 + i % 7));
+        keys[3 * n + i] = (void *)(uintptr_t)edgeKey((int)i, (int)(i + 9));
+    }
+
+    KeySet sets[] = {
+        {"city names, polynomial hash", polynomialHash,
+         undereferencing_strcmp, keys, keys + n},
+        {"city names, hashString", hashString, undereferencing_strcmp, keys,
+         keys + n},
+        {"edge keys", hashEdgeKey, equalEdgeKeys, keys + 2 * n, keys + 3 * n}};
+    printf("%zu keys, best of %d\n", n, REPEATS);
+    for (size_t s = 0; s < sizeof(sets) / sizeof(sets[0]); ++s) {
+        if (!compare(&sets[s], n, &sink)) {
+            goto CLEANUP;
+        }
+    }
+    ret = sink == 0;
+
+CLEANUP:
+    free(names);
+    free(keys);
+    return ret;
+}
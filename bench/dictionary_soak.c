@@ -0,0 +1,171 @@
+/** @file
+ * Długotrwały test słownika (@ref Dictionary) przy ciągłym usuwaniu
+ * i wstawianiu elementów.
+ *
+ * Użycie: dictionary_soak [liczba milionów par usunięcie + wstawienie]
+ *
+ * W słowniku jest stale @ref LIVE_KEYS kluczy; w każdej parze losowy klucz
+ * jest usuwany, a w jego miejsce wstawiany nowy. Po każdym milionie par
+ * program szuka wszystkich obecnych i miliona nieobecnych kluczy, a następnie
+ * sprawdza, że wyniki są poprawne, a rozmiar tablicy, najdłuższa ścieżka
+ * szukania obecnego klucza i średnia liczba grup przeglądanych przy
+ * chybionym szukaniu są ograniczone. Na koniec powiększa słownik do miliona
+ * kluczy, usuwa prawie wszystkie i sprawdza, że tablica została zmniejszona.
+ * Kończy się błędem, jeśli któryś z warunków nie jest spełniony.
+ */
+#include <stdio.h>
+
+#include "bench_grid.h"
+#include "dictionary.h"
+#include "hash_group.h"
+#include "utils.h"
+
+/// Liczba kluczy stale obecnych w słowniku.
+#define LIVE_KEYS 50000
+/// Liczba par usunięcie + wstawienie między kolejnymi sprawdzeniami.
+#define EPOCH 1000000
+/// Liczba chybionych wyszukiwań w każdym sprawdzeniu.
+#define MISSES 1000000
+/// Liczba kluczy, do której słownik jest powiększany na koniec.
+#define PEAK_KEYS 1000000
+/// Liczba kluczy pozostawianych po opróżnieniu słownika.
+#define DRAINED_KEYS 1000
+
+/// Najdłuższa dopuszczalna ścieżka szukania obecnego klucza, w grupach.
+#define MAX_PROBE_GROUPS 8
+/// Największa dopuszczalna średnia liczba grup przeglądanych przy chybionym
+/// szukaniu.
+#define MAX_MEAN_MISS_GROUPS 4.0
+/// Tablica może mieć co najwyżej tyle razy więcej komórek niż elementów.
+#define MAX_SLOTS_PER_KEY 8
+
+/** @brief Skraca klucz będący liczbą.
+ * @param[in] key           - klucz
+ * @return Skrót klucza.
+ */
+static hash_t hashKey(void *key) { return hashMix((uint64_t)(uintptr_t)key); }
+
+/** @brief Porównuje klucze będące liczbami.
+ * @param[in] a             - pierwszy klucz
+ * @param[in] b             - drugi klucz
+ * @return Wartość @p true, jeśli klucze są równe i nie oznaczają pustej ani
+ * usuniętej komórki, @p false wpp.
+ */
+static bool equalKeys(void *a, void *b) {
+    if (a == NULL || a == DELETED || b == NULL || b == DELETED) {
+        return false;
+    }
+    return a == b;
+}
+
+/** @brief Wyznacza liczbę grup przeglądanych przy chybionym szukaniu.
+ * @param[in] d             - słownik
+ * @param[in] hash          - skrót nieobecnego klucza
+ * @return Liczba grup do pierwszej grupy z pustą komórką włącznie.
+ */
+static size_t missLength(const Dictionary *d, hash_t hash) {
+    size_t mask = d->table.array_size - 1;
+    size_t pos = H1(hash) & mask;
+    size_t groups = 1;
+    for (size_t stride = GROUP_WIDTH;
+         matchByte(d->table.ctrl + pos, CTRL_EMPTY) == 0;
+         stride += GROUP_WIDTH) {
+        pos = (pos + stride) & mask;
+        groups++;
+    }
+    return groups;
+}
+
+int main(int argc, char *argv[]) {
+    int epochs = argc > 1 ? atoi(argv[1]) : 10;
+    static uintptr_t keys[LIVE_KEYS];
+    uint64_t state = 88172645463325252ULL;
+    // Klucze 0 i 1 oznaczają pustą i usuniętą komórkę.
+    uintptr_t next = 2;
+    size_t sink = 0;
+    bool ok = true;
+
+    Dictionary *d = newDictionary(hashKey, equalKeys, empty, empty);
+    if (d == NULL) {
+        return 1;
+    }
+    const HashTable *table = &d->table;
+    for (int i = 0; i < LIVE_KEYS; ++i) {
+        keys[i] = next++;
+        if (!insertDictionary(d, (void *)keys[i], (void *)1)) {
+            goto OOM;
+        }
+    }
+
+    for (int e = 0; e < epochs; ++e) {
+        double start = benchNow();
+        for (int i = 0; i < EPOCH; ++i) {
+            size_t j = (size_t)(benchRandom(&state) % LIVE_KEYS);
+            deleteFromDictionary(d, (void *)keys[j]);
+            keys[j] = next++;
+            if (!insertDictionary(d, (void *)keys[j], (void *)1)) {
+                goto OOM;
+            }
+        }
+        double mutated = benchNow();
+        for (uintptr_t k = next; k < next + MISSES; ++k) {
+            sink += (uintptr_t)getDictionary(d, (void *)k).val;
+        }
+        double looked_up = benchNow();
+        size_t hits = 0;
+        for (int i = 0; i < LIVE_KEYS; ++i) {
+            hits += getDictionary(d, (void *)keys[i]).val != NULL;
+        }
+        size_t miss_groups = 0;
+        for (uintptr_t k = next; k < next + MISSES; ++k) {
+            miss_groups += missLength(d, hashKey((void *)k));
+        }
+        size_t longest = longestProbeDictionary(d);
+        double mean_miss = (double)miss_groups / MISSES;
+        printf("%2d: %4.0f ms per 1M pairs, %4.0f ms per 1M misses, "
+               "%zu slots, %zu deleted, longest probe %zu groups, "
+               "%.3f groups per miss\n",
+               e + 1, mutated - start, looked_up - mutated, table->array_size,
+               table->deleted, longest, mean_miss);
+        if (table->size != LIVE_KEYS || hits != LIVE_KEYS || sink != 0) {
+            fprintf(stderr, "FAILED: lookups returned wrong results\n");
+            ok = false;
+        }
+        if (table->size + table->deleted > MAX_LOAD(table->array_size) ||
+            table->array_size > MAX_SLOTS_PER_KEY * LIVE_KEYS ||
+            longest > MAX_PROBE_GROUPS || mean_miss > MAX_MEAN_MISS_GROUPS) {
+            fprintf(stderr, "FAILED: table size or probe lengths are not "
+                            "bounded\n");
+            ok = false;
+        }
+    }
+
+    for (uintptr_t k = next; k < next + PEAK_KEYS; ++k) {
+        if (!insertDictionary(d, (void *)k, (void *)1)) {
+            goto OOM;
+        }
+    }
+    size_t peak = table->array_size;
+    for (uintptr_t k = next; k < next + PEAK_KEYS - DRAINED_KEYS; ++k) {
+        deleteFromDictionary(d, (void *)k);
+    }
+    for (int i = 0; i < LIVE_KEYS; ++i) {
+        deleteFromDictionary(d, (void *)keys[i]);
+    }
+    printf("grown to %zu slots, drained to %zu keys in %zu slots, "
+           "%zu deleted\n",
+           peak, table->size, table->array_size, table->deleted);
+    if (table->size != DRAINED_KEYS ||
+        table->array_size > SHRINK_RATIO * DRAINED_KEYS) {
+        fprintf(stderr, "FAILED: drained table was not shrunk\n");
+        ok = false;
+    }
+    deleteDictionary(d);
+    free(d);
+    return ok ? 0 : 1;
+
+OOM:
+    deleteDictionary(d);
+    free(d);
+    return 1;
+}
@@ -0,0 +1,47 @@
+/** @file
+ * Generator wejścia programu map: kratownica, której odcinki są dodawane
+ * w losowej kolejności, i drogi krajowe między losowymi miastami.
+ *
+ * Użycie: grid_input [bok kratownicy] [liczba dróg krajowych] [ziarno]
+ *
+ * Miasta dostają numery niezwiązane z układem kratownicy, więc porównanie
+ * np. `perf stat -e cache-misses ./map < wejście` z `./map --renumber`
+ * pokazuje wpływ numerowania miast na lokalność odwołań do pamięci.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "bench_grid.h"
+
+int main(int argc, char *argv[]) {
+    int size = argc > 1 ? atoi(argv[1]) : 150;
+    unsigned routes = argc > 2 ? (unsigned)atoi(argv[2]) : 1000;
+    uint64_t state = argc > 3 ? strtoull(argv[3], NULL, 10) : 1;
+    if (size < 2 || state == 0) {
+        fprintf(stderr, "grid side must be at least 2, seed must be "
+                        "positive\n");
+        return 1;
+    }
+
+    Grid grid;
+    if (!newGrid(&grid, size, &state)) {
+        return 1;
+    }
+    shuffleGrid(&grid, &state);
+
+    char city1[GRID_NAME_LENGTH], city2[GRID_NAME_LENGTH];
+    for (size_t i = 0; i < grid.roads_no; ++i) {
+        const GridRoad *r = &grid.roads[i];
+        gridCityName(city1, r->x1, r->y1);
+        gridCityName(city2, r->x2, r->y2);
+        printf("addRoad;%s;%s;%u;%d\n", city1, city2, r->length, r->year);
+    }
+    for (unsigned i = 0; i < routes; ++i) {
+        randomGridCities(&grid, &state, city1, city2);
+        printf("newRoute;1;%s;%s\n", city1, city2);
+        printf("getRouteDescription;1\n");
+        printf("removeRoute;1\n");
+    }
+    deleteGrid(&grid);
+    return 0;
+}
@@ -0,0 +1,281 @@
+/** @file
+ * Test odporności tablic haszujących z nazwami miast na złośliwie dobrane
+ * nazwy.
+ *
+ * Wstawia dwa zbiory nazw do tablicy numerów miast (@ref CityIndex) i do
+ * słownika wykrywającego powtórzenia miast w opisie drogi krajowej (klucze
+ * zakończone średnikiem):
+ * - 4096 nazw, które mają ten sam skrót przy dawnej funkcji skrótu (wielomian
+ *   o podstawie 149): bloki ("A", 200) i ("B", "3") dają ten sam skrót, więc
+ *   ciągi 12 takich bloków mają równe skróty;
+ * - 20000 anagramów napisu "abcdefgh", które miały ten sam skrót przy dawnej
+ *   funkcji skrótu parsera (iloczyn bajtów).
+ * Kończy się błędem, jeśli najdłuższa ścieżka szukania w którejś z tablic
+ * przekracza @ref MAX_PROBE_GROUPS grup. Dla porównania wstawia te same nazwy
+ * do słownika z dawną funkcją skrótu i sprawdza, że tam ścieżki są długie,
+ * czyli że zbiory rzeczywiście są złośliwe.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "city_index.h"
+#include "dictionary.h"
+#include "parser.h"
+#include "utils.h"
+
+/// Najdłuższa dopuszczalna ścieżka szukania, w grupach bajtów kontrolnych.
+#define MAX_PROBE_GROUPS 8
+/// Liczba bloków nazwy w zbiorze kolizji dawnego wielomianu.
+#define COLLISION_BLOCKS 12
+/// Liczba nazw w zbiorze kolizji dawnego wielomianu.
+#define COLLISION_NAMES (1 << COLLISION_BLOCKS)
+/// Napis, którego anagramy tworzą drugi zbiór.
+#define ANAGRAM_BASE "abcdefgh"
+/// Liczba anagramów.
+#define ANAGRAM_NAMES 20000
+
+/**
+ * Zbiór nazw miast.
+ */
+typedef struct NameSet {
+    /// opis zbioru
+    const char *name;
+    /// nazwy zakończone bajtem zerowym
+    char **names;
+    /// te same nazwy oddzielone średnikami, jak w opisie drogi krajowej
+    char **terminated;
+    /// liczba nazw
+    size_t count;
+    /// dawna funkcja skrótu, przy której nazwy kolidują
+    hash_t (*old_hash)(void *);
+} NameSet;
+
+/** @brief Dawna funkcja skrótu nazw miast: wielomian o podstawie 149.
+ * @param[in] str           - napis zakończony bajtem zerowym lub średnikiem
+ * @return Skrót napisu.
+ */
+static hash_t oldStringHash(void *str) {
+    hash_t ret = 0;
+    for (const uint8_t *c = str; *c != '\0' && *c != ';'; ++c) {
+        ret = ret * 149 + *c;
+    }
+    return ret;
+}
+
+/** @brief Dawna funkcja skrótu parsera: iloczyn bajtów.
+ * @param[in] str           - napis zakończony bajtem zerowym lub średnikiem
+ * @return Skrót napisu.
+ */
+static hash_t oldParserHash(void *str) {
+    hash_t ret = 1;
+    for (const uint8_t *c = str; *c != '\0' && *c != ';'; ++c) {
+        ret *= *c + 1;
+    }
+    return ret;
+}
+
+/** @brief Przechodzi do następnej permutacji w porządku leksykograficznym.
+ * @param[in,out] s         - permutowany napis
+ * @param[in] n             - długość napisu
+ * @return Wartość @p false, jeśli @p s było ostatnią permutacją, @p true wpp.
+ */
+static bool nextPermutation(char *s, size_t n) {
+    size_t i = n - 1;
+    while (i > 0 && s[i - 1] >= s[i]) {
+        i--;
+    }
+    if (i == 0) {
+        return false;
+    }
+    size_t j = n - 1;
+    while (s[j] <= s[i - 1]) {
+        j--;
+    }
+    char c = s[i - 1];
+    s[i - 1] = s[j];
+    s[j] = c;
+    for (size_t a = i, b = n - 1; a < b; ++a, --b) {
+        c = s[a];
+        s[a] = s[b];
+        s[b] = c;
+    }
+    return true;
+}
+
+/** @brief Przygotowuje zbiór nazw o długości @p length.
+ * Nazwy zapisane są w jednym buforze oddzielone średnikami, jak w opisie
+ * drogi krajowej, a ich kopie zakończone bajtem zerowym w drugim.
+ * @param[out] set          - zbiór
+ * @param[in] count         - liczba nazw
+ * @param[in] length        - długość każdej nazwy
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status allocateNameSet(NameSet *set, size_t count, size_t length) {
+    set->count = count;
+    set->names = malloc(count * sizeof(char *));
+    set->terminated = malloc(count * sizeof(char *));
+    char *plain = malloc(count * (length + 1));
+    char *line = malloc(count * (length + 1));
+    if (set->names == NULL || set->terminated == NULL || plain == NULL ||
+        line == NULL) {
+        free(set->names);
+        free(set->terminated);
+        free(plain);
+        free(line);
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        set->names[i] = plain + i * (length + 1);
+        set->terminated[i] = line + i * (length + 1);
+    }
+    return true;
+}
+
+/** @brief Zwalnia pamięć zajmowaną przez zbiór nazw.
+ * @param[in,out] set       - zbiór
+ */
+static void deleteNameSet(NameSet *set) {
+    free(set->names[0]);
+    free(set->terminated[0]);
+    free(set->names);
+    free(set->terminated);
+}
+
+/** @brief Zapisuje nazwę w obu buforach zbioru.
+ * @param[in,out] set       - zbiór
+ * @param[in] i             - numer nazwy
+ * @param[in] name          - nazwa
+ * @param[in] length        - długość nazwy
+ */
+static void storeName(NameSet *set, size_t i, const char *name,
+                      size_t length) {
+    memcpy(set->names[i], name, length);
+    set->names[i][length] = '\0';
+    memcpy(set->terminated[i], name, length);
+    set->terminated[i][length] = i + 1 < set->count ? ';' : '\0';
+}
+
+/** @brief Tworzy zbiór nazw o równych skrótach przy dawnym wielomianie.
+ * @param[out] set          - zbiór
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status newCollisionSet(NameSet *set) {
+    CHECK_RET(allocateNameSet(set, COLLISION_NAMES, 2 * COLLISION_BLOCKS));
+    set->name = "old-polynomial collisions";
+    set->old_hash = oldStringHash;
+    char name[2 * COLLISION_BLOCKS];
+    for (size_t i = 0; i < COLLISION_NAMES; ++i) {
+        for (int b = 0; b < COLLISION_BLOCKS; ++b) {
+            bool high = (i >> b) & 1;
+            name[2 * b] = high ? 'B' : 'A';
+            name[2 * b + 1] = high ? '3' : (char)200;
+        }
+        storeName(set, i, name, sizeof(name));
+    }
+    return true;
+}
+
+/** @brief Tworzy zbiór anagramów napisu @ref ANAGRAM_BASE.
+ * @param[out] set          - zbiór
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status newAnagramSet(NameSet *set) {
+    size_t length = strlen(ANAGRAM_BASE);
+    CHECK_RET(allocateNameSet(set, ANAGRAM_NAMES, length));
+    set->name = "anagrams";
+    set->old_hash = oldParserHash;
+    char name[] = ANAGRAM_BASE;
+    for (size_t i = 0; i < ANAGRAM_NAMES; ++i) {
+        storeName(set, i, name, length);
+        nextPermutation(name, length);
+    }
+    return true;
+}
+
+/** @brief Wstawia nazwy do tablicy numerów miast.
+ * @param[in] set           - zbiór nazw
+ * @param[out] longest      - najdłuższa ścieżka szukania
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status probeCityIndex(const NameSet *set, size_t *longest) {
+    CityIndex index;
+    CHECK_RET(initCityIndex(&index));
+    for (size_t i = 0; i < set->count; ++i) {
+        if (!insertCityIndex(&index, set->names[i], (int)i)) {
+            deleteCityIndex(&index);
+            return false;
+        }
+    }
+    *longest = longestProbeCityIndex(&index);
+    deleteCityIndex(&index);
+    return true;
+}
+
+/** @brief Wstawia nazwy zakończone średnikami do słownika.
+ * @param[in] keys          - nazwy
+ * @param[in] count         - liczba nazw
+ * @param[in] hash          - funkcja skrótu
+ * @param[out] longest      - najdłuższa ścieżka szukania
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status probeDictionary(char **keys, size_t count,
+                              hash_t (*hash)(void *), size_t *longest) {
+    Dictionary *d =
+        newDictionary(hash, cmpSemicolonTerminated, empty, empty);
+    CHECK_RET(d);
+    bool ok = true;
+    for (size_t i = 0; i < count && ok; ++i) {
+        ok = insertDictionary(d, keys[i], keys[i]);
+    }
+    *longest = longestProbeDictionary(d);
+    deleteDictionary(d);
+    free(d);
+    return ok;
+}
+
+/** @brief Sprawdza oba rodzaje tablic na zbiorze nazw.
+ * @param[in] set           - zbiór nazw
+ * @param[out] passed       - czy ścieżki szukania są krótkie, a przy dawnej
+ * funkcji skrótu - długie
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status checkNameSet(const NameSet *set, bool *passed) {
+    size_t city_index, parser, old;
+    CHECK_RET(probeCityIndex(set, &city_index));
+    CHECK_RET(probeDictionary(set->terminated, set->count,
+                              hashSemicolonTerminated, &parser));
+    CHECK_RET(probeDictionary(set->terminated, set->count, set->old_hash,
+                              &old));
+    printf("%-26s %5zu names: CityIndex %zu, parser dictionary %zu, "
+           "old hash %zu groups\n",
+           set->name, set->count, city_index, parser, old);
+    *passed = city_index <= MAX_PROBE_GROUPS && parser <= MAX_PROBE_GROUPS &&
+              old > MAX_PROBE_GROUPS;
+    return true;
+}
+
+int main(void) {
+    seedStringHash();
+    NameSet collisions, anagrams;
+    if (!newCollisionSet(&collisions)) {
+        return 1;
+    }
+    if (!newAnagramSet(&anagrams)) {
+        deleteNameSet(&collisions);
+        return 1;
+    }
+    bool collisions_passed = false, anagrams_passed = false;
+    bool ok = checkNameSet(&collisions, &collisions_passed) &&
+              checkNameSet(&anagrams, &anagrams_passed);
+    deleteNameSet(&collisions);
+    deleteNameSet(&anagrams);
+    if (!ok) {
+        return 1;
+    }
+    if (!collisions_passed || !anagrams_passed) {
+        fprintf(stderr, "FAILED: longest probe exceeds %d groups\n",
+                MAX_PROBE_GROUPS);
+        return 1;
+    }
+    return 0;
+}
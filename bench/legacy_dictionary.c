@@ -0,0 +1,121 @@
+#include "legacy_dictionary.h"
+#include <stdlib.h>
+
+#define LOAD_FACTOR 0.9
+#define DICTIONARY_INITIAL_SIZE 4
+#define INDEX(key) dictionary->hash((key)) & (dictionary->array_size - 1)
+#define NEXT_INDEX(index)                                                      \
+    {                                                                          \
+        if (++(index) == dictionary->array_size) {                             \
+            (index) = 0;                                                       \
+        }                                                                      \
+    }
+
+LegacyDictionary *newLegacyDictionary(hash_t (*hash)(void *),
+                                      bool (*equal)(void *, void *)) {
+    LegacyDictionary *dictionary = calloc(1, sizeof(LegacyDictionary));
+    if (dictionary == NULL) {
+        return NULL;
+    }
+    dictionary->hash = hash;
+    dictionary->equal = equal;
+    dictionary->size = 0;
+    dictionary->array_size = DICTIONARY_INITIAL_SIZE;
+    dictionary->array = calloc(DICTIONARY_INITIAL_SIZE, sizeof(Entry));
+    if (dictionary->array == NULL) {
+        free(dictionary);
+        return NULL;
+    }
+    return dictionary;
+}
+
+void deleteLegacyDictionary(LegacyDictionary *dictionary) {
+    if (dictionary == NULL) {
+        return;
+    }
+    free(dictionary->array);
+    free(dictionary);
+}
+
+static Status rehashLegacyDictionary(LegacyDictionary *dictionary,
+                                     size_t new_size) {
+    Entry *p = calloc(new_size, sizeof(Entry));
+    if (p == NULL) {
+        return false;
+    }
+    LegacyDictionary copy = *dictionary;
+    dictionary->size = 0;
+    dictionary->array_size = new_size;
+    dictionary->array = p;
+
+    for (size_t i = 0; i < copy.array_size; ++i) {
+        Entry e = copy.array[i];
+        if (NOT_FOUND(e) == false) {
+            if (insertLegacyDictionary(dictionary, e.key, e.val) == false) {
+                free(dictionary->array);
+                *dictionary = copy;
+                return false;
+            }
+        }
+    }
+
+    free(copy.array);
+    return true;
+}
+
+Status insertLegacyDictionary(LegacyDictionary *dictionary, void *key,
+                              void *val) {
+    CHECK_RET(dictionary);
+    CHECK_RET(key);
+    CHECK_RET(val);
+    if (dictionary->size > dictionary->array_size * LOAD_FACTOR ||
+        dictionary->size + 1 >= dictionary->array_size) {
+        CHECK_RET(
+            rehashLegacyDictionary(dictionary, 2 * dictionary->array_size));
+    }
+    hash_t index = INDEX(key);
+    while (dictionary->array[index].key != NULL &&
+           dictionary->array[index].key != DELETED) {
+        if (dictionary->equal(dictionary->array[index].key, key)) {
+            dictionary->size--;
+            break;
+        }
+        NEXT_INDEX(index);
+    }
+    dictionary->array[index].key = key;
+    dictionary->array[index].val = val;
+    dictionary->size++;
+    return true;
+}
+
+Entry getLegacyDictionary(LegacyDictionary *dictionary, void *key) {
+    if (dictionary == NULL || key == NULL) {
+        return (const Entry){NULL, NULL};
+    }
+    hash_t index = INDEX(key);
+    size_t n = 0;
+    while (dictionary->array[index].key != NULL && n < dictionary->array_size) {
+        n++;
+        if (dictionary->equal(dictionary->array[index].key, key)) {
+            return dictionary->array[index];
+        }
+        NEXT_INDEX(index);
+    }
+    return (const Entry){NULL, NULL};
+}
+
+void deleteFromLegacyDictionary(LegacyDictionary *dictionary, void *key) {
+    if (dictionary == NULL || key == NULL) {
+        return;
+    }
+    hash_t index = INDEX(key);
+    while (dictionary->array[index].key != NULL) {
+        if (dictionary->equal(dictionary->array[index].key, key)) {
+            dictionary->array[index].key = DELETED;
+            dictionary->array[index].val = NULL;
+            dictionary->size--;
+            return;
+        }
+        NEXT_INDEX(index);
+    }
+}
@@ -0,0 +1,67 @@
+/** @file
+ * Słownik z adresowaniem otwartym i liniowym szukaniem, zastąpiony przez
+ * tablicę przeglądaną grupami bajtów kontrolnych (@ref Dictionary).
+ * Zachowany jedynie jako punkt odniesienia w pomiarach.
+ */
+#ifndef __LEGACY_DICTIONARY_H__
+#define __LEGACY_DICTIONARY_H__
+
+#include "dictionary.h"
+
+/**
+ * Słownik z liniowym szukaniem. Pusta komórka ma klucz NULL, a komórka,
+ * z której usunięto element - DELETED.
+ */
+typedef struct LegacyDictionary {
+    /// funkcja skrótu używana w słowniku
+    hash_t (*hash)(void *);
+    /// funkcja porównująca klucze na równość
+    bool (*equal)(void *, void *);
+    /// tablica przechowująca pary klucz-wartość
+    Entry *array;
+    /// rozmiar tablicy
+    size_t array_size;
+    /// liczba elementów w słowniku
+    size_t size;
+} LegacyDictionary;
+
+/** @brief Tworzy nowy słownik.
+ * Słownik nie zwalnia pamięci wskazywanej przez klucze i wartości.
+ * @param[in] hash             - funkcja skrótu
+ * @param[in] equal            - funkcja porównująca klucze
+ * @return Wskaźnik na nowy słownik lub NULL, gdy nie udało się zaalokować
+ * pamięci.
+ */
+LegacyDictionary *newLegacyDictionary(hash_t (*hash)(void *),
+                                      bool (*equal)(void *, void *));
+
+/** @brief Usuwa słownik.
+ * @param[in,out] dictionary   - słownik do usunięcia
+ */
+void deleteLegacyDictionary(LegacyDictionary *dictionary);
+
+/** @brief Wstawia wartość do słownika.
+ * Jeśli klucz znajduje się w słowniku, zastępuje starą wartość nową.
+ * @param[in,out] dictionary   - słownik
+ * @param[in] key              - klucz
+ * @param[in] val              - wartość
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status insertLegacyDictionary(LegacyDictionary *dictionary, void *key,
+                              void *val);
+
+/** @brief Znajduje element w słowniku.
+ * @param[in] dictionary       - słownik
+ * @param[in] key              - szukany klucz
+ * @return Element o kluczu @p key lub para dwóch wskaźników NULL, jeśli
+ * klucza nie ma w słowniku.
+ */
+Entry getLegacyDictionary(LegacyDictionary *dictionary, void *key);
+
+/** @brief Usuwa element ze słownika, zostawiając w komórce znacznik DELETED.
+ * @param[in,out] dictionary   - słownik
+ * @param[in] key              - klucz usuwanego elementu
+ */
+void deleteFromLegacyDictionary(LegacyDictionary *dictionary, void *key);
+
+#endif /* __LEGACY_DICTIONARY_H__ */
@@ -0,0 +1,105 @@
+/** @file
+ * Pomiar wpływu numerowania miast na czas wyszukiwań najkrótszych ścieżek.
+ *
+ * Użycie: locality_bench [bok kratownicy] [liczba dróg krajowych]
+ * [plain|renumber]
+ *
+ * Odcinki kratownicy są dodawane w losowej kolejności, więc sąsiednie miasta
+ * mają odległe numery. Program mierzy wyznaczanie dróg krajowych przy tej
+ * numeracji (plain) i po wywołaniu @ref renumberCities (renumber), a bez
+ * trzeciego argumentu - w obu wariantach, sprawdzając, że drogi są takie
+ * same. Wybranie jednego wariantu pozwala porównać liczniki sprzętowe, np.
+ * `perf stat -e cache-misses ./locality_bench 150 1000 renumber`.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "bench_grid.h"
+
+/// Liczba powtórzeń pomiaru w każdym wariancie.
+#define REPEATS 3
+
+/// Ziarno generatora kratownicy.
+#define GRID_SEED 88172645463325252ULL
+
+/** @brief Mierzy wyznaczanie dróg krajowych w jednym wariancie.
+ * @param[in] grid          - kratownica z odcinkami w losowej kolejności
+ * @param[in] routes        - liczba dróg krajowych
+ * @param[in] renumber      - czy numerować miasta od nowa przed pomiarem
+ * @param[out] checksum     - suma kontrolna opisów dróg
+ * @return Wartość @p false, jeśli nastąpił błąd alokacji pamięci, @p true
+ * wpp.
+ */
+static bool measure(const Grid *grid, unsigned routes, bool renumber,
+                    uint64_t *checksum) {
+    Map *map = newMap();
+    CHECK_RET(map);
+    bool ret = false;
+    if (!addGridRoads(map, grid)) {
+        goto CLEANUP;
+    }
+    double start = benchNow();
+    if (renumber && !renumberCities(map)) {
+        goto CLEANUP;
+    }
+    double renumbered = benchNow() - start;
+
+    double best = 0;
+    for (int r = 0; r < REPEATS; ++r) {
+        start = benchNow();
+        if (!runGridRoutes(map, grid, routes, checksum)) {
+            goto CLEANUP;
+        }
+        double elapsed = benchNow() - start;
+        if (r == 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+    printf("%-9s routes %9.1f ms", renumber ? "renumber" : "plain", best);
+    if (renumber) {
+        printf("  (renumbering %.1f ms)", renumbered);
+    }
+    printf("\n");
+    ret = true;
+
+CLEANUP:
+    deleteMap(map);
+    return ret;
+}
+
+int main(int argc, char *argv[]) {
+    int size = argc > 1 ? atoi(argv[1]) : 150;
+    unsigned routes = argc > 2 ? (unsigned)atoi(argv[2]) : 300;
+    bool plain = argc <= 3 || strcmp(argv[3], "plain") == 0;
+    bool renumber = argc <= 3 || strcmp(argv[3], "renumber") == 0;
+    if (size < 2 || (!plain && !renumber)) {
+        fprintf(stderr, "usage: %s [grid side >= 2] [routes] "
+                        "[plain|renumber]\n",
+                argv[0]);
+        return 1;
+    }
+
+    uint64_t state = GRID_SEED;
+    Grid grid;
+    if (!newGrid(&grid, size, &state)) {
+        return 1;
+    }
+    shuffleGrid(&grid, &state);
+
+    printf("shuffled grid %dx%d, %u routes\n", size, size, routes);
+    int ret = 1;
+    uint64_t plain_checksum = 0, renumber_checksum = 0;
+    if ((plain && !measure(&grid, routes, false, &plain_checksum)) ||
+        (renumber && !measure(&grid, routes, true, &renumber_checksum))) {
+        goto CLEANUP;
+    }
+    if (plain && renumber && plain_checksum != renumber_checksum) {
+        fprintf(stderr, "renumbering changed the routes\n");
+        goto CLEANUP;
+    }
+    ret = 0;
+
+CLEANUP:
+    deleteGrid(&grid);
+    return ret;
+}
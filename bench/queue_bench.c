@@ -0,0 +1,82 @@
+/** @file
+ * Porównanie implementacji kolejki priorytetowej wyszukiwań najkrótszych
+ * ścieżek na kratownicy.
+ *
+ * Użycie: queue_bench [bok kratownicy] [liczba dróg krajowych]
+ * [liczba punktów orientacyjnych]
+ *
+ * Dla każdej implementacji wyznacza te same drogi krajowe między losowymi
+ * miastami i wypisuje najkrótszy z trzech czasów. Kończy się błędem, jeśli
+ * implementacje wyznaczyły różne drogi.
+ */
+#include <stdio.h>
+
+#include "bench_grid.h"
+
+/// Liczba powtórzeń pomiaru dla każdej implementacji.
+#define REPEATS 3
+
+/// Badane implementacje kolejki.
+static const QueueKind QUEUES[] = {BINARY_QUEUE, QUATERNARY_QUEUE,
+                                   RADIX_QUEUE};
+
+/// Nazwy badanych implementacji.
+static const char *QUEUE_NAMES[] = {"binary", "quaternary", "radix"};
+
+int main(int argc, char *argv[]) {
+    int size = argc > 1 ? atoi(argv[1]) : 50;
+    unsigned routes = argc > 2 ? (unsigned)atoi(argv[2]) : 2000;
+    size_t landmarks = argc > 3 ? (size_t)atoi(argv[3]) : 0;
+    if (size < 2) {
+        fprintf(stderr, "grid side must be at least 2\n");
+        return 1;
+    }
+
+    uint64_t state = 88172645463325252ULL;
+    Grid grid;
+    Map *map = newMap();
+    if (map == NULL || !newGrid(&grid, size, &state)) {
+        deleteMap(map);
+        return 1;
+    }
+    int ret = 1;
+    if (!addGridRoads(map, &grid) ||
+        (landmarks > 0 && !enableLandmarks(map, landmarks))) {
+        goto CLEANUP;
+    }
+
+    printf("grid %dx%d, %u routes, %zu landmarks\n", size, size, routes,
+           landmarks);
+    uint64_t expected = 0;
+    for (size_t k = 0; k < sizeof(QUEUES) / sizeof(QUEUES[0]); ++k) {
+        if (!selectPriorityQueue(map, QUEUES[k])) {
+            goto CLEANUP;
+        }
+        double best = 0;
+        for (int r = 0; r < REPEATS; ++r) {
+            uint64_t checksum;
+            double start = benchNow();
+            if (!runGridRoutes(map, &grid, routes, &checksum)) {
+                goto CLEANUP;
+            }
+            double elapsed = benchNow() - start;
+            if (k == 0 && r == 0) {
+                expected = checksum;
+            } else if (checksum != expected) {
+                fprintf(stderr, "%s queue found different routes\n",
+                        QUEUE_NAMES[k]);
+                goto CLEANUP;
+            }
+            if (r == 0 || elapsed < best) {
+                best = elapsed;
+            }
+        }
+        printf("%-12s %9.1f ms\n", QUEUE_NAMES[k], best);
+    }
+    ret = 0;
+
+CLEANUP:
+    deleteGrid(&grid);
+    deleteMap(map);
+    return ret;
+}
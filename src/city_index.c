@@ -0,0 +1,23 @@
+#include <string.h>
+
+#include "city_index.h"
+#include "utils.h"
+
+/** @brief Liczy skrót nazwy miasta.
+ * @param[in] name          - nazwa miasta
+ * @return Skrót nazwy.
+ */
+static inline hash_t hashCityName(const char *name) {
+    return nHashString((void *)name, strlen(name));
+}
+
+/** @brief Porównuje nazwy miast.
+ * @param[in] a             - pierwsza nazwa
+ * @param[in] b             - druga nazwa
+ * @return Wartość @p true, jeśli nazwy są równe.
+ */
+static inline bool equalCityNames(const char *a, const char *b) {
+    return strcmp(a, b) == 0;
+}
+
+HASH_MAP_DEFINE(CityIndex, const char *, int, hashCityName, equalCityNames, )
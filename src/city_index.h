@@ -0,0 +1,17 @@
+/** @file
+ * Tablica haszująca przyporządkowująca nazwom miast ich numery.
+ */
+#ifndef __CITY_INDEX_H__
+#define __CITY_INDEX_H__
+
+#include "hash_map.h"
+
+/**
+ * Tablica haszująca nazw miast (napisów w stylu C) w ich numery. Nazwy nie są
+ * kopiowane, więc muszą istnieć tak długo, jak długo są w tablicy.
+ */
+HASH_MAP_TYPE(CityIndex, const char *, int)
+
+HASH_MAP_PROTOTYPES(CityIndex, const char *, int)
+
+#endif /* __CITY_INDEX_H__ */
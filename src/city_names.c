@@ -0,0 +1,64 @@
+#include "city_names.h"
+
+/// Rozmiar bloku nazw; dłuższe nazwy dostają bloki na wyłączność.
+#define NAME_CHUNK_SIZE 16384
+
+/** @brief Wyznacza liczbę bajtów zajmowanych w bloku przez nazwę.
+ * @param[in] length        - długość nazwy
+ * @return Liczba bajtów z długością, bajtem zerowym i wyrównaniem.
+ */
+static size_t entrySize(size_t length) {
+    size_t size = sizeof(uint32_t) + length + 1;
+    return (size + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1);
+}
+
+Status initCityNames(CityNames *names) {
+    *names = (const CityNames){NULL, NULL, 0, 0};
+    return true;
+}
+
+void deleteCityNames(CityNames *names) {
+    while (names->chunks != NULL) {
+        NameChunk *next = names->chunks->next;
+        free(names->chunks);
+        names->chunks = next;
+    }
+    free(names->names);
+    names->names = NULL;
+    names->count = names->capacity = 0;
+}
+
+const char *appendCityName(CityNames *names, const char *name, size_t length) {
+    CHECK_RET(length <= UINT32_MAX);
+    if (names->count == names->capacity) {
+        size_t capacity = 2 * names->capacity + 16;
+        const char **n = realloc(names->names, capacity * sizeof(char *));
+        CHECK_RET(n);
+        names->names = n;
+        names->capacity = capacity;
+    }
+    size_t size = entrySize(length);
+    NameChunk *chunk = names->chunks;
+    if (chunk == NULL || chunk->capacity - chunk->used < size) {
+        size_t capacity = size > NAME_CHUNK_SIZE ? size : NAME_CHUNK_SIZE;
+        chunk = malloc(sizeof(NameChunk) + capacity);
+        CHECK_RET(chunk);
+        chunk->next = names->chunks;
+        chunk->used = 0;
+        chunk->capacity = capacity;
+        names->chunks = chunk;
+    }
+    char *entry = chunk->data + chunk->used;
+    uint32_t prefix = (uint32_t)length;
+    memcpy(entry, &prefix, sizeof(prefix));
+    memcpy(entry + sizeof(prefix), name, length);
+    entry[sizeof(prefix) + length] = '\0';
+    chunk->used += size;
+    names->names[names->count++] = entry + sizeof(prefix);
+    return entry + sizeof(prefix);
+}
+
+void removeLastCityName(CityNames *names) {
+    const char *name = names->names[--names->count];
+    names->chunks->used -= entrySize(cityNameLength(name));
+}
@@ -0,0 +1,81 @@
+/** @file
+ * Zwarta tablica nazw miast, indeksowana numerami miast.
+ */
+#ifndef __CITY_NAMES_H__
+#define __CITY_NAMES_H__
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "status.h"
+
+/**
+ * Blok pamięci, w którym kolejno zapisywane są nazwy miast. Każda nazwa jest
+ * poprzedzona 32-bitową długością, zakończona bajtem zerowym i wyrównana do
+ * 4 bajtów.
+ */
+typedef struct NameChunk {
+    /// poprzednio zaalokowany blok lub NULL
+    struct NameChunk *next;
+    /// liczba zajętych bajtów bloku
+    size_t used;
+    /// rozmiar bloku
+    size_t capacity;
+    /// zapisane nazwy
+    char data[];
+} NameChunk;
+
+/**
+ * Nazwy miast przechowywane w blokach pamięci zamiast osobnych alokacji.
+ * Bloki nie są przenoszone, więc wskaźniki na nazwy pozostają ważne aż do
+ * usunięcia całej tablicy.
+ */
+typedef struct CityNames {
+    /// ostatnio zaalokowany blok lub NULL
+    NameChunk *chunks;
+    /// nazwy kolejnych miast, wskazujące do bloków
+    const char **names;
+    /// liczba miast
+    size_t count;
+    /// liczba miast, dla których zaalokowano @p names
+    size_t capacity;
+} CityNames;
+
+/** @brief Inicjalizuje pustą tablicę nazw.
+ * @param[out] names        - tablica do zainicjalizowania
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status initCityNames(CityNames *names);
+
+/** @brief Zwalnia pamięć zajmowaną przez tablicę nazw.
+ * @param[in,out] names     - tablica nazw
+ */
+void deleteCityNames(CityNames *names);
+
+/** @brief Dopisuje nazwę kolejnego miasta.
+ * Jeśli nie uda się zaalokować pamięci, tablica pozostaje bez zmian.
+ * @param[in,out] names     - tablica nazw
+ * @param[in] name          - nazwa miasta
+ * @param[in] length        - długość nazwy
+ * @return Wskaźnik na zapisaną nazwę lub NULL, gdy nie udało się zaalokować
+ * pamięci.
+ */
+const char *appendCityName(CityNames *names, const char *name, size_t length);
+
+/** @brief Usuwa ostatnio dopisaną nazwę.
+ * @param[in,out] names     - niepusta tablica nazw
+ */
+void removeLastCityName(CityNames *names);
+
+/** @brief Zwraca długość nazwy miasta bez jej przeglądania.
+ * @param[in] name          - nazwa zapisana w tablicy nazw
+ * @return Długość nazwy.
+ */
+static inline size_t cityNameLength(const char *name) {
+    uint32_t length;
+    memcpy(&length, name - sizeof(length), sizeof(length));
+    return length;
+}
+
+#endif /* __CITY_NAMES_H__ */
@@ -0,0 +1,52 @@
+#include "city_order.h"
+#include "road_graph.h"
+
+/** @brief Przeszukuje wszerz spójną składową miasta @p start.
+ * @param[in] map           - mapa dróg
+ * @param[in,out] mark      - znaczniki odwiedzenia miast
+ * @param[in] stamp         - znacznik tego przeszukiwania, różny od
+ * znaczników wszystkich miast
+ * @param[in] start         - miasto początkowe
+ * @param[out] queue        - tutaj zapisywane są odwiedzone miasta
+ * @return Liczba odwiedzonych miast.
+ */
+static size_t breadthFirst(Map *map, unsigned *mark, unsigned stamp,
+                           int start, int *queue) {
+    size_t head = 0;
+    size_t tail = 0;
+    queue[tail++] = start;
+    mark[start] = stamp;
+    while (head < tail) {
+        RoadIterator it = iterateRoads(map->graph, queue[head++]);
+        Road road;
+        while (nextRoad(&it, &road)) {
+            if (mark[road.end] != stamp) {
+                mark[road.end] = stamp;
+                queue[tail++] = road.end;
+            }
+        }
+    }
+    return tail;
+}
+
+Status cityOrder(Map *map, int *order) {
+    size_t cities_no = map->city_to_int.table.size;
+    unsigned *mark = calloc(cities_no + 1, sizeof(unsigned));
+    CHECK_RET(mark);
+
+    size_t placed = 0;
+    unsigned stamp = 0;
+    for (size_t v = 0; v < cities_no; ++v) {
+        if (mark[v] != 0) {
+            continue;
+        }
+        // Pierwsze przeszukiwanie znajduje miasto na obrzeżu składowej, drugie
+        // wyznacza kolejność, nadpisując wynik pierwszego.
+        size_t size =
+            breadthFirst(map, mark, ++stamp, (int)v, order + placed);
+        int far = order[placed + size - 1];
+        placed += breadthFirst(map, mark, ++stamp, far, order + placed);
+    }
+    free(mark);
+    return true;
+}
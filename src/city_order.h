@@ -0,0 +1,23 @@
+/** @file
+ * Kolejność miast zwiększająca lokalność odwołań do pamięci podczas
+ * wyszukiwań najkrótszych ścieżek.
+ */
+#ifndef __CITY_ORDER_H__
+#define __CITY_ORDER_H__
+
+#include "map_struct.h"
+#include "status.h"
+
+/** @brief Wyznacza kolejność miast mapy przeszukiwaniem wszerz.
+ * Każda spójna składowa jest przeglądana od wierzchołka leżącego na jej
+ * obrzeżu (najdalszego od dowolnie wybranego wierzchołka), więc kolejne
+ * poziomy przeszukiwania są wąskie, a sąsiednie miasta otrzymują bliskie
+ * numery.
+ * @param[in] map           - mapa dróg
+ * @param[out] order        - tablica, w której zostaną zapisane wszystkie
+ * miasta w wyznaczonej kolejności
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status cityOrder(Map *map, int *order);
+
+#endif /* __CITY_ORDER_H__ */
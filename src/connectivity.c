@@ -0,0 +1,137 @@
+#include "connectivity.h"
+#include "road_graph.h"
+
+struct Connectivity {
+    /// liczba miast, dla których zaalokowano tablice
+    size_t capacity;
+    /// liczba miast uwzględnionych w składowych; pozostałe są odizolowane
+    size_t size;
+    /// rodzic w drzewie zbiorów rozłącznych (korzeń wskazuje na siebie)
+    int *parent;
+    /// liczba miast w zbiorze (aktualna tylko dla korzeni)
+    size_t *component_size;
+    /// czy składowe trzeba wyznaczyć od nowa
+    bool stale;
+};
+
+Connectivity *newConnectivity(void) {
+    return calloc(1, sizeof(Connectivity));
+}
+
+void deleteConnectivity(Connectivity *c) {
+    if (c == NULL) {
+        return;
+    }
+    free(c->parent);
+    free(c->component_size);
+    free(c);
+}
+
+/** @brief Zapewnia, że struktura obejmuje @p cities_no miast.
+ * Nowe miasta tworzą jednoelementowe zbiory.
+ * @param[in,out] c         - struktura składowych
+ * @param[in] cities_no     - liczba miast
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status reserveCities(Connectivity *c, size_t cities_no) {
+    if (cities_no > c->capacity) {
+        size_t capacity = 2 * c->capacity;
+        if (capacity < cities_no) {
+            capacity = cities_no;
+        }
+        int *parent = realloc(c->parent, capacity * sizeof(int));
+        CHECK_RET(parent);
+        c->parent = parent;
+        size_t *component_size =
+            realloc(c->component_size, capacity * sizeof(size_t));
+        CHECK_RET(component_size);
+        c->component_size = component_size;
+        c->capacity = capacity;
+    }
+    for (; c->size < cities_no; ++c->size) {
+        c->parent[c->size] = (int)c->size;
+        c->component_size[c->size] = 1;
+    }
+    return true;
+}
+
+/** @brief Znajduje reprezentanta zbioru, skracając po drodze ścieżkę.
+ * @param[in,out] c         - struktura składowych
+ * @param[in] v             - miasto uwzględnione w strukturze
+ * @return Korzeń zbioru zawierającego @p v.
+ */
+static int findRoot(Connectivity *c, int v) {
+    while (c->parent[v] != v) {
+        c->parent[v] = c->parent[c->parent[v]];
+        v = c->parent[v];
+    }
+    return v;
+}
+
+/** @brief Łączy zbiory zawierające podane miasta.
+ * Mniejszy zbiór jest podczepiany pod korzeń większego.
+ * @param[in,out] c         - struktura składowych
+ * @param[in] a             - pierwsze miasto
+ * @param[in] b             - drugie miasto
+ */
+static void unite(Connectivity *c, int a, int b) {
+    a = findRoot(c, a);
+    b = findRoot(c, b);
+    if (a == b) {
+        return;
+    }
+    if (c->component_size[a] < c->component_size[b]) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    c->parent[b] = a;
+    c->component_size[a] += c->component_size[b];
+}
+
+/** @brief Wyznacza składowe od nowa na podstawie wszystkich odcinków mapy.
+ * @param[in,out] c         - struktura składowych
+ * @param[in] map           - mapa dróg
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status rebuild(Connectivity *c, Map *map) {
+    c->size = 0;
+    CHECK_RET(reserveCities(c, map->city_to_int.table.size));
+    for (size_t v = 0; v < c->size; ++v) {
+        RoadIterator it = iterateRoads(map->graph, v);
+        Road road;
+        while (nextRoad(&it, &road)) {
+            if (road.start < road.end) {
+                unite(c, road.start, road.end);
+            }
+        }
+    }
+    c->stale = false;
+    return true;
+}
+
+void connectivityAddRoad(Connectivity *c, Map *map, Road road) {
+    if (c->stale) {
+        return;
+    }
+    if (!reserveCities(c, map->city_to_int.table.size)) {
+        c->stale = true;
+        return;
+    }
+    unite(c, road.start, road.end);
+}
+
+void connectivityRemoveRoad(Connectivity *c) { c->stale = true; }
+
+Status connectivityQuery(Connectivity *c, Map *map, int A, int B,
+                         bool *connected) {
+    if (c->stale) {
+        CHECK_RET(rebuild(c, map));
+    }
+    if ((size_t)A >= c->size || (size_t)B >= c->size) {
+        *connected = A == B;
+        return true;
+    }
+    *connected = findRoot(c, A) == findRoot(c, B);
+    return true;
+}
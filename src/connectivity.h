@@ -0,0 +1,56 @@
+/** @file
+ * Spójne składowe mapy, pozwalające odrzucać zapytania o ścieżki między
+ * niepołączonymi miastami bez wyszukiwania.
+ */
+#ifndef __CONNECTIVITY_H__
+#define __CONNECTIVITY_H__
+
+#include "map_struct.h"
+#include "status.h"
+
+/**
+ * Spójne składowe grafu dróg w strukturze zbiorów rozłącznych. Dodanie
+ * odcinka drogowego łączy składowe, a usunięcie odcinka, który mógł
+ * rozspójnić składową, powoduje ich wyznaczenie od nowa przy następnym
+ * zapytaniu.
+ */
+typedef struct Connectivity Connectivity;
+
+/** @brief Tworzy strukturę składowych pustej mapy.
+ * @return Wskaźnik na strukturę lub NULL, gdy nie udało się zaalokować
+ * pamięci.
+ */
+Connectivity *newConnectivity(void);
+
+/** @brief Zwalnia strukturę składowych.
+ * @param[in,out] c         - struktura do zwolnienia
+ */
+void deleteConnectivity(Connectivity *c);
+
+/** @brief Łączy składowe końców nowego odcinka drogowego.
+ * Jeśli nie uda się zaalokować pamięci, składowe zostaną wyznaczone od nowa
+ * przy następnym zapytaniu.
+ * @param[in,out] c         - struktura składowych
+ * @param[in] map           - mapa dróg zawierająca już nowy odcinek
+ * @param[in] road          - nowy odcinek drogowy
+ */
+void connectivityAddRoad(Connectivity *c, Map *map, Road road);
+
+/** @brief Uwzględnia usunięcie odcinka drogowego.
+ * Składowe zostaną wyznaczone od nowa przy następnym zapytaniu.
+ * @param[in,out] c         - struktura składowych
+ */
+void connectivityRemoveRoad(Connectivity *c);
+
+/** @brief Sprawdza, czy między miastami istnieje droga.
+ * @param[in,out] c         - struktura składowych
+ * @param[in] map           - mapa dróg
+ * @param[in] A             - pierwsze miasto
+ * @param[in] B             - drugie miasto
+ * @param[out] connected    - tutaj zapisywane jest, czy miasta są połączone
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status connectivityQuery(Connectivity *c, Map *map, int A, int B,
+                         bool *connected);
+
+#endif /* __CONNECTIVITY_H__ */
@@ -0,0 +1,1370 @@
+#include <limits.h>
+#include <string.h>
+
+#include "contraction.h"
+#include "hash_map.h"
+#include "heap.h"
+#include "road_graph.h"
+#include "utils.h"
+
+/// Długość ścieżki do wierzchołka, do którego nie dotarło wyszukiwanie.
+#define INFINITY UINT64_MAX
+
+/// Dalej liczba ścieżek nie ma znaczenia - wystarczy wiedzieć, że nie jest
+/// jedyna.
+#define MANY_PATHS 2
+
+/// Limit wierzchołków ustalanych przez wyszukiwanie ścieżki-świadka.
+#define WITNESS_SETTLE_LIMIT 256
+
+/// Hierarchia jest budowana od nowa, gdy zwykłe wyszukiwania ustalą
+/// tyle razy więcej wierzchołków, niż jest miast.
+#define REBUILD_WORK_FACTOR 32
+
+/// Największa liczba wykluczonych wierzchołków obsługiwana przez hierarchię.
+#define MAX_EXCLUDED 256
+
+/// Największa liczba krawędzi, dla których wykluczenia wymagają przeliczenia
+/// lat.
+#define MAX_TAINTED 4096
+
+/// Przesunięcie priorytetów ściągania, które mogą być ujemne.
+#define PRIORITY_OFFSET ((int64_t)1 << 40)
+
+/// Początkowa pojemność kopców.
+#define HEAP_INITIAL_CAPACITY 16
+
+/**
+ * Krawędź hierarchii skrótów.
+ */
+typedef struct ChEdge {
+    /// koniec ściągnięty wcześniej
+    int low;
+    /// koniec ściągnięty później
+    int high;
+    /// długość reprezentowanych ścieżek
+    uint64_t length;
+    /// długość odcinka drogowego łączącego końce krawędzi
+    uint64_t original_length;
+    /// rok budowy lub ostatniego remontu tego odcinka
+    int original_year;
+} ChEdge;
+
+/**
+ * Lata najdawniej zbudowanych odcinków ścieżek reprezentowanych przez
+ * krawędź - dwa największe, z powtórzeniami.
+ */
+typedef struct ChYears {
+    /// największy rok
+    int best;
+    /// drugi największy rok (o ile @p count jest równe @ref MANY_PATHS)
+    int second;
+    /// liczba ścieżek, obcięta do @ref MANY_PATHS
+    unsigned char count;
+} ChYears;
+
+/**
+ * Trójkąt - skrót @p edge przechodzący przez ściągnięty wierzchołek
+ * @p middle, złożony z krawędzi @p first i @p second.
+ */
+typedef struct ChTriangle {
+    /// skrót
+    int edge;
+    /// wierzchołek wewnętrzny
+    int middle;
+    /// krawędź z jednego końca skrótu do @p middle
+    int first;
+    /// krawędź z @p middle do drugiego końca skrótu
+    int second;
+} ChTriangle;
+
+/**
+ * Tablica dynamiczna liczb całkowitych.
+ */
+typedef struct IntArray {
+    /// elementy
+    int *array;
+    /// liczba elementów
+    size_t size;
+    /// pojemność tablicy (zaalokowany rozmiar)
+    size_t capacity;
+} IntArray;
+
+/** @brief Funkcja skrótu dla kluczy utworzonych przez @ref edgeKey.
+ * @param[in] key           - klucz
+ * @return Skrót klucza.
+ */
+static inline hash_t hashEdgeKey(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return key;
+}
+
+/** @brief Porównuje klucze krawędzi.
+ * @param[in] a             - pierwszy klucz
+ * @param[in] b             - drugi klucz
+ * @return Wartość @p true, jeśli klucze są równe.
+ */
+static inline bool equalEdgeKeys(uint64_t a, uint64_t b) { return a == b; }
+
+/**
+ * Tablica haszująca numerów krawędzi o kluczach utworzonych przez
+ * @ref edgeKey.
+ */
+HASH_MAP_TYPE(ChEdgeIndex, uint64_t, int)
+
+HASH_MAP_DEFINE(ChEdgeIndex, uint64_t, int, hashEdgeKey, equalEdgeKeys,
+                static inline)
+
+/**
+ * Stan wyszukiwania w górę hierarchii z jednego końca.
+ */
+typedef struct ChSide {
+    /// wierzchołek, z którego prowadzone jest wyszukiwanie
+    int source;
+    /// długości najkrótszych ścieżek
+    uint64_t *dist;
+    /// najpóźniejszy rok najdawniej zbudowanego odcinka
+    int *year;
+    /// ostatnia krawędź optymalnej ścieżki
+    int *pred;
+    /// liczba optymalnych ścieżek, obcięta do @ref MANY_PATHS
+    unsigned char *ways;
+    /// znaczniki pokolenia, w którym wierzchołek otrzymał etykietę
+    unsigned *labelled;
+    /// znaczniki pokolenia, w którym etykieta wierzchołka stała się ostateczna
+    unsigned *settled;
+    /// wierzchołki w kolejności ustalania ich etykiet
+    int *order;
+    /// liczba wierzchołków o ustalonych etykietach
+    size_t settled_count;
+    /// liczba wierzchołków, do których dotarło wyszukiwanie
+    size_t touched_count;
+} ChSide;
+
+struct ContractionHierarchy {
+    /// czy hierarchia odpowiada bieżącej sieci dróg
+    bool valid;
+    /// czy lata na krawędziach wymagają przeliczenia
+    bool needs_customisation;
+    /// liczba wierzchołków ustalonych przez zwykłe wyszukiwania od chwili
+    /// unieważnienia hierarchii
+    uint64_t fallback_work;
+    /// liczba wierzchołków
+    size_t cities_no;
+    /// liczba krawędzi
+    size_t edges_no;
+    /// kolejność ściągnięcia wierzchołków
+    int *rank;
+    /// krawędzie
+    ChEdge *edges;
+    /// lata ścieżek reprezentowanych przez krawędzie
+    ChYears *years;
+    /// krawędzie w górę z wierzchołka v to up_edges[up_start[v]..up_start[v+1])
+    int *up_start;
+    /// krawędzie w górę
+    int *up_edges;
+    /// trójkąty krawędzi e to triangles[tri_start[e]..tri_start[e+1])
+    int *tri_start;
+    /// trójkąty uporządkowane według skrótów
+    ChTriangle *triangles;
+    /// trójkąty przez wierzchołek v to mid_triangles[mid_start[v]..)
+    int *mid_start;
+    /// numery trójkątów uporządkowane według wierzchołków wewnętrznych
+    int *mid_triangles;
+    /// skróty zawierające krawędź e to uses[use_start[e]..use_start[e+1])
+    int *use_start;
+    /// skróty uporządkowane według krawędzi, z których się składają
+    int *uses;
+    /// krawędzie w kolejności ściągania niższych końców
+    int *custom_order;
+    /// pokolenie bieżącego wyszukiwania
+    unsigned epoch;
+    /// wyszukiwania z A i z B
+    ChSide sides[2];
+    /// pokolenie bieżącego zbioru krawędzi z przeliczanymi latami
+    unsigned edge_epoch;
+    /// znaczniki pokolenia, w którym krawędź wymagała przeliczenia lat
+    unsigned *tainted;
+    /// lata krawędzi po uwzględnieniu wykluczeń
+    ChYears *restricted;
+    /// krawędzie wymagające przeliczenia lat
+    int *tainted_list;
+    /// liczba krawędzi wymagających przeliczenia lat
+    size_t tainted_count;
+    /// stos wykorzystywany przy rozwijaniu skrótów
+    IntArray stack;
+    /// krawędzie znalezionej ścieżki
+    IntArray path;
+    /// kopiec wyszukiwań
+    Heap heap;
+};
+
+/**
+ * Parametry zapytania do hierarchii.
+ */
+typedef struct ChQuery {
+    /// obszar roboczy ze zbiorem wykluczonych wierzchołków
+    SearchWorkspace *ws;
+    /// wierzchołek początkowy
+    int A;
+    /// wierzchołek końcowy
+    int B;
+    /// czy uwzględniać wykluczenia
+    bool restricted;
+} ChQuery;
+
+/**
+ * Struktury pomocnicze budowy hierarchii.
+ */
+typedef struct Builder {
+    /// liczba wierzchołków
+    size_t cities_no;
+    /// krawędzie
+    ChEdge *edges;
+    /// liczba krawędzi
+    size_t edges_no;
+    /// pojemność tablicy krawędzi
+    size_t edges_capacity;
+    /// trójkąty
+    ChTriangle *triangles;
+    /// liczba trójkątów
+    size_t triangles_no;
+    /// pojemność tablicy trójkątów
+    size_t triangles_capacity;
+    /// krawędzie łączące wierzchołek z nieściągniętymi sąsiadami
+    IntArray *adj;
+    /// numery krawędzi łączących pary wierzchołków
+    ChEdgeIndex index;
+    /// kolejność ściągnięcia wierzchołków (-1 dla nieściągniętych)
+    int *rank;
+    /// liczba ściągniętych sąsiadów
+    int *deleted;
+    /// poziom wierzchołka - długość najdłuższego ciągu ściągniętych sąsiadów
+    int *level;
+    /// odległości w wyszukiwaniu świadka
+    uint64_t *wdist;
+    /// znaczniki pokolenia wyszukiwania świadka
+    unsigned *wstamp;
+    /// pokolenie wyszukiwania świadka
+    unsigned wepoch;
+    /// kopiec wyszukiwania świadka
+    Heap wheap;
+} Builder;
+
+/** @brief Dodaje liczbę na koniec tablicy.
+ * @param[in,out] a         - tablica
+ * @param[in] x             - dodawana liczba
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status appendInt(IntArray *a, int x) {
+    if (a->size == a->capacity) {
+        size_t capacity = a->capacity > 0 ? 2 * a->capacity : 4;
+        int *n = realloc(a->array, capacity * sizeof(int));
+        CHECK_RET(n);
+        a->array = n;
+        a->capacity = capacity;
+    }
+    a->array[a->size++] = x;
+    return true;
+}
+
+/** @brief Zwraca drugi koniec krawędzi.
+ * @param[in] e             - krawędź
+ * @param[in] v             - jeden z końców krawędzi
+ * @return Drugi koniec krawędzi.
+ */
+static int otherEnd(const ChEdge *e, int v) {
+    return e->low == v ? e->high : e->low;
+}
+
+/** @brief Dodaje rok najdawniej zbudowanego odcinka kolejnej ścieżki.
+ * @param[in,out] y         - lata ścieżek
+ * @param[in] year          - rok dodawanej ścieżki
+ */
+static void addPathYear(ChYears *y, int year) {
+    if (y->count == 0) {
+        y->best = year;
+        y->count = 1;
+    } else if (y->count == 1 || year > y->second) {
+        y->second = year > y->best ? y->best : year;
+        y->best = year > y->best ? year : y->best;
+        y->count = MANY_PATHS;
+    }
+}
+
+/** @brief Dodaje lata ścieżek złożonych ze ścieżek @p a i @p b.
+ * Wystarczy rozważyć złożenia, w których co najwyżej jedna część nie jest
+ * najlepsza - każde inne złożenie jest nie lepsze od nich.
+ * @param[in,out] y         - lata ścieżek
+ * @param[in] a             - lata ścieżek pierwszej części
+ * @param[in] b             - lata ścieżek drugiej części
+ */
+static void addComposedYears(ChYears *y, ChYears a, ChYears b) {
+    addPathYear(y, min(a.best, b.best));
+    if (a.count == MANY_PATHS) {
+        addPathYear(y, min(a.second, b.best));
+    }
+    if (b.count == MANY_PATHS) {
+        addPathYear(y, min(a.best, b.second));
+    }
+}
+
+/** @brief Liczy ścieżki, których odcinki zbudowano nie wcześniej niż
+ * w roku @p threshold.
+ * @param[in] y             - lata ścieżek
+ * @param[in] threshold     - rok
+ * @return Liczba ścieżek, obcięta do @ref MANY_PATHS.
+ */
+static unsigned countAtLeast(ChYears y, int threshold) {
+    unsigned count = 0;
+    if (y.count > 0 && y.best >= threshold) {
+        count++;
+    }
+    if (y.count == MANY_PATHS && y.second >= threshold) {
+        count++;
+    }
+    return count;
+}
+
+/** @brief Zwalnia dane hierarchii, pozostawiając ją nieaktualną.
+ * @param[in,out] ch        - hierarchia
+ */
+static void freeHierarchyData(ContractionHierarchy *ch) {
+    free(ch->rank);
+    free(ch->edges);
+    free(ch->years);
+    free(ch->up_start);
+    free(ch->up_edges);
+    free(ch->tri_start);
+    free(ch->triangles);
+    free(ch->mid_start);
+    free(ch->mid_triangles);
+    free(ch->use_start);
+    free(ch->uses);
+    free(ch->custom_order);
+    free(ch->tainted);
+    free(ch->restricted);
+    free(ch->tainted_list);
+    for (int i = 0; i < 2; ++i) {
+        ChSide *s = &ch->sides[i];
+        free(s->dist);
+        free(s->year);
+        free(s->pred);
+        free(s->ways);
+        free(s->labelled);
+        free(s->settled);
+        free(s->order);
+    }
+    Heap heap = ch->heap;
+    IntArray stack = ch->stack;
+    IntArray path = ch->path;
+    uint64_t fallback_work = ch->fallback_work;
+    memset(ch, 0, sizeof(ContractionHierarchy));
+    ch->heap = heap;
+    ch->stack = stack;
+    ch->path = path;
+    ch->fallback_work = fallback_work;
+}
+
+ContractionHierarchy *newContractionHierarchy(void) {
+    ContractionHierarchy *ch = calloc(1, sizeof(ContractionHierarchy));
+    CHECK_RET(ch);
+    ch->heap = newHeap(HEAP_INITIAL_CAPACITY);
+    if (ch->heap.array == NULL) {
+        free(ch);
+        return NULL;
+    }
+    return ch;
+}
+
+void deleteContractionHierarchy(ContractionHierarchy *ch) {
+    if (ch == NULL) {
+        return;
+    }
+    freeHierarchyData(ch);
+    deleteHeap(&ch->heap);
+    free(ch->stack.array);
+    free(ch->path.array);
+    free(ch);
+}
+
+void invalidateContractionHierarchy(ContractionHierarchy *ch) {
+    if (ch->valid) {
+        ch->valid = false;
+        ch->fallback_work = 0;
+    }
+}
+
+void contractionFallbackWork(ContractionHierarchy *ch, uint64_t settled) {
+    ch->fallback_work += settled;
+}
+
+/** @brief Zwalnia struktury pomocnicze budowy hierarchii.
+ * @param[in,out] b         - struktury pomocnicze
+ */
+static void freeBuilder(Builder *b) {
+    free(b->edges);
+    free(b->triangles);
+    if (b->adj != NULL) {
+        for (size_t i = 0; i < b->cities_no; ++i) {
+            free(b->adj[i].array);
+        }
+    }
+    free(b->adj);
+    deleteChEdgeIndex(&b->index);
+    free(b->rank);
+    free(b->deleted);
+    free(b->level);
+    free(b->wdist);
+    free(b->wstamp);
+    deleteHeap(&b->wheap);
+}
+
+/** @brief Dodaje krawędź do budowanej hierarchii.
+ * @param[in,out] b             - struktury pomocnicze
+ * @param[in] u                 - jeden koniec krawędzi
+ * @param[in] w                 - drugi koniec krawędzi
+ * @param[in] length            - długość krawędzi
+ * @param[in] original_year     - rok budowy odcinka drogowego (jeśli krawędź
+ * jest odcinkiem drogowym)
+ * @param[in] original          - czy krawędź jest odcinkiem drogowym
+ * @return Numer krawędzi lub -1 w przypadku błędu alokacji pamięci.
+ */
+static int addEdge(Builder *b, int u, int w, uint64_t length,
+                   int original_year, bool original) {
+    if (b->edges_no == b->edges_capacity) {
+        size_t capacity = b->edges_capacity > 0 ? 2 * b->edges_capacity : 16;
+        ChEdge *n = realloc(b->edges, capacity * sizeof(ChEdge));
+        if (n == NULL) {
+            return -1;
+        }
+        b->edges = n;
+        b->edges_capacity = capacity;
+    }
+    int id = b->edges_no;
+    b->edges[id] = (const ChEdge){u, w, length, original ? length : 0,
+                                  original_year};
+    if (!insertChEdgeIndex(&b->index, edgeKey(u, w), id) ||
+        !appendInt(&b->adj[u], id) || !appendInt(&b->adj[w], id)) {
+        return -1;
+    }
+    b->edges_no++;
+    return id;
+}
+
+/** @brief Dodaje skrót z @p u do @p w przez ściągany wierzchołek @p v.
+ * Jeśli krawędź z @p u do @p w już istnieje i jest krótsza, nic nie robi;
+ * jeśli jest dłuższa, zostaje skrócona (reprezentowane przez nią dłuższe
+ * ścieżki nie mogą być najkrótsze).
+ * @param[in,out] b         - struktury pomocnicze
+ * @param[in] u             - jeden koniec skrótu
+ * @param[in] w             - drugi koniec skrótu
+ * @param[in] length        - długość skrótu
+ * @param[in] v             - ściągany wierzchołek
+ * @param[in] first         - krawędź z @p u do @p v
+ * @param[in] second        - krawędź z @p v do @p w
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status addShortcut(Builder *b, int u, int w, uint64_t length, int v,
+                          int first, int second) {
+    int *e = getChEdgeIndex(&b->index, edgeKey(u, w));
+    int id;
+    if (e == NULL) {
+        id = addEdge(b, u, w, length, 0, false);
+        CHECK_RET(id != -1);
+    } else {
+        id = *e;
+        if (b->edges[id].length < length) {
+            return true;
+        }
+        b->edges[id].length = length;
+    }
+    if (b->triangles_no == b->triangles_capacity) {
+        size_t capacity =
+            b->triangles_capacity > 0 ? 2 * b->triangles_capacity : 16;
+        ChTriangle *n = realloc(b->triangles, capacity * sizeof(ChTriangle));
+        CHECK_RET(n);
+        b->triangles = n;
+        b->triangles_capacity = capacity;
+    }
+    b->triangles[b->triangles_no++] = (ChTriangle){id, v, first, second};
+    return true;
+}
+
+/** @brief Szuka ścieżek z @p u omijających ściągany wierzchołek @p v.
+ * Wyszukiwanie ogranicza się do nieściągniętych wierzchołków bliższych niż
+ * @p limit i kończy się po ustaleniu @ref WITNESS_SETTLE_LIMIT wierzchołków.
+ * Znalezione odległości są długościami pewnych ścieżek, więc mogą jedynie
+ * zawyżać odległości prawdziwe - wówczas dodawany jest zbędny, ale
+ * nieszkodliwy skrót.
+ * @param[in,out] b         - struktury pomocnicze
+ * @param[in] u             - wierzchołek początkowy
+ * @param[in] v             - ściągany wierzchołek
+ * @param[in] limit         - długość, od której ścieżki nie są potrzebne
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status witnessSearch(Builder *b, int u, int v, uint64_t limit) {
+    if (++b->wepoch == 0) {
+        memset(b->wstamp, 0, b->cities_no * sizeof(unsigned));
+        b->wepoch = 1;
+    }
+    b->wheap.size = 0;
+    b->wstamp[u] = b->wepoch;
+    b->wdist[u] = 0;
+    CHECK_RET(pushHeap(&b->wheap, (HeapEntry){0, 0, 0, u}));
+    size_t settled = 0;
+    while (!isEmptyHeap(&b->wheap) && settled < WITNESS_SETTLE_LIMIT) {
+        HeapEntry top = topHeap(&b->wheap);
+        popHeap(&b->wheap);
+        if (top.dist > b->wdist[top.vertex]) {
+            continue;
+        }
+        if (top.dist >= limit) {
+            break;
+        }
+        settled++;
+        IntArray *adj = &b->adj[top.vertex];
+        for (size_t i = 0; i < adj->size; ++i) {
+            const ChEdge *e = &b->edges[adj->array[i]];
+            int y = otherEnd(e, top.vertex);
+            uint64_t dist = top.dist + e->length;
+            if (y == v || (b->wstamp[y] == b->wepoch && b->wdist[y] <= dist)) {
+                continue;
+            }
+            b->wstamp[y] = b->wepoch;
+            b->wdist[y] = dist;
+            CHECK_RET(pushHeap(&b->wheap, (HeapEntry){dist, dist, 0, y}));
+        }
+    }
+    return true;
+}
+
+/** @brief Ściąga wierzchołek (lub jedynie liczy potrzebne skróty).
+ * Skrót między sąsiadami u i w jest potrzebny, jeśli nie znaleziono ścieżki
+ * z u do w ściśle krótszej niż ścieżka przez @p v - skróty powstają więc
+ * również dla ścieżek równie długich jak inne, co zachowuje wszystkie
+ * najkrótsze ścieżki.
+ * @param[in,out] b         - struktury pomocnicze
+ * @param[in] v             - ściągany wierzchołek
+ * @param[in] simulate      - czy jedynie policzyć skróty
+ * @return Liczba potrzebnych skrótów lub -1 w przypadku błędu alokacji
+ * pamięci.
+ */
+static int contractVertex(Builder *b, int v, bool simulate) {
+    IntArray *adj = &b->adj[v];
+    int shortcuts = 0;
+    for (size_t i = 0; i + 1 < adj->size; ++i) {
+        int e1 = adj->array[i];
+        int u = otherEnd(&b->edges[e1], v);
+        uint64_t len1 = b->edges[e1].length;
+        uint64_t limit = 0;
+        for (size_t j = i + 1; j < adj->size; ++j) {
+            uint64_t len = len1 + b->edges[adj->array[j]].length;
+            limit = len > limit ? len : limit;
+        }
+        if (!witnessSearch(b, u, v, limit)) {
+            return -1;
+        }
+        for (size_t j = i + 1; j < adj->size; ++j) {
+            int e2 = adj->array[j];
+            int w = otherEnd(&b->edges[e2], v);
+            uint64_t length = len1 + b->edges[e2].length;
+            if (b->wstamp[w] == b->wepoch && b->wdist[w] < length) {
+                continue;
+            }
+            shortcuts++;
+            if (!simulate && !addShortcut(b, u, w, length, v, e1, e2)) {
+                return -1;
+            }
+        }
+    }
+    return shortcuts;
+}
+
+/** @brief Wyznacza priorytet ściągnięcia wierzchołka.
+ * Mniejszy priorytet mają wierzchołki, których ściągnięcie dodaje mniej
+ * skrótów, niż usuwa krawędzi, oraz te, których sąsiedzi byli rzadziej
+ * ściągani - dzięki temu hierarchia jest płytka i równomierna.
+ * @param[in,out] b         - struktury pomocnicze
+ * @param[in] v             - wierzchołek
+ * @param[out] key          - priorytet
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status contractionPriority(Builder *b, int v, uint64_t *key) {
+    int shortcuts = contractVertex(b, v, true);
+    CHECK_RET(shortcuts != -1);
+    int64_t priority = (int64_t)shortcuts - (int64_t)b->adj[v].size +
+                       b->deleted[v] + b->level[v];
+    *key = (uint64_t)(priority + PRIORITY_OFFSET);
+    return true;
+}
+
+/** @brief Ściąga kolejno wszystkie wierzchołki.
+ * @param[in,out] b         - struktury pomocnicze z krawędziami mapy
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status contractAll(Builder *b) {
+    Heap queue = newHeap(b->cities_no > 0 ? b->cities_no : 1);
+    CHECK_RET(queue.array);
+    Status ret = false;
+    for (size_t v = 0; v < b->cities_no; ++v) {
+        uint64_t key;
+        if (!contractionPriority(b, v, &key) ||
+            !pushHeap(&queue, (HeapEntry){key, 0, 0, v})) {
+            goto FREE;
+        }
+    }
+    int next_rank = 0;
+    while (!isEmptyHeap(&queue)) {
+        int v = topHeap(&queue).vertex;
+        popHeap(&queue);
+        // leniwe uaktualnianie priorytetów
+        uint64_t key;
+        if (!contractionPriority(b, v, &key)) {
+            goto FREE;
+        }
+        if (!isEmptyHeap(&queue) && key > topHeap(&queue).key) {
+            if (!pushHeap(&queue, (HeapEntry){key, 0, 0, v})) {
+                goto FREE;
+            }
+            continue;
+        }
+        if (contractVertex(b, v, false) == -1) {
+            goto FREE;
+        }
+        b->rank[v] = next_rank++;
+        IntArray *adj = &b->adj[v];
+        for (size_t i = 0; i < adj->size; ++i) {
+            int u = otherEnd(&b->edges[adj->array[i]], v);
+            IntArray *other = &b->adj[u];
+            for (size_t j = 0; j < other->size; ++j) {
+                if (other->array[j] == adj->array[i]) {
+                    other->array[j] = other->array[--other->size];
+                    break;
+                }
+            }
+            b->deleted[u]++;
+            if (b->level[u] < b->level[v] + 1) {
+                b->level[u] = b->level[v] + 1;
+            }
+        }
+        adj->size = 0;
+    }
+    ret = true;
+FREE:
+    deleteHeap(&queue);
+    return ret;
+}
+
+/** @brief Układa elementy w kubełkach według kluczy (sortowanie przez
+ * zliczanie).
+ * @param[in] buckets       - liczba kubełków
+ * @param[in] keys          - klucze elementów 0, ..., @p count - 1
+ * @param[in] count         - liczba elementów
+ * @param[out] start        - elementy kubełka k to items[start[k]..start[k+1])
+ * @param[out] items        - elementy uporządkowane według kluczy
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status bucketSort(size_t buckets, const int *keys, size_t count,
+                         int **start, int **items) {
+    *start = calloc(buckets + 1, sizeof(int));
+    *items = malloc((count > 0 ? count : 1) * sizeof(int));
+    CHECK_RET(*start != NULL && *items != NULL);
+    for (size_t i = 0; i < count; ++i) {
+        (*start)[keys[i] + 1]++;
+    }
+    for (size_t k = 0; k < buckets; ++k) {
+        (*start)[k + 1] += (*start)[k];
+    }
+    for (size_t i = 0; i < count; ++i) {
+        (*items)[(*start)[keys[i]]++] = i;
+    }
+    for (size_t k = buckets; k > 0; --k) {
+        (*start)[k] = (*start)[k - 1];
+    }
+    (*start)[0] = 0;
+    return true;
+}
+
+/** @brief Przelicza lata ścieżek reprezentowanych przez krawędź.
+ * @param[in] ch            - hierarchia
+ * @param[in] q             - zapytanie, którego wykluczenia uwzględniamy, lub
+ * NULL
+ * @param[in] e             - krawędź
+ * @return Lata ścieżek.
+ */
+static ChYears computeYears(ContractionHierarchy *ch, ChQuery *q, int e);
+
+/** @brief Zwraca lata ścieżek reprezentowanych przez krawędź.
+ * @param[in] ch            - hierarchia
+ * @param[in] q             - zapytanie, którego wykluczenia uwzględniamy, lub
+ * NULL
+ * @param[in] e             - krawędź
+ * @return Lata ścieżek (omijających wykluczone wierzchołki).
+ */
+static ChYears edgeYears(ContractionHierarchy *ch, ChQuery *q, int e) {
+    if (q != NULL && q->restricted && ch->tainted[e] == ch->edge_epoch) {
+        return ch->restricted[e];
+    }
+    return ch->years[e];
+}
+
+static ChYears computeYears(ContractionHierarchy *ch, ChQuery *q, int e) {
+    ChYears y = {0, 0, 0};
+    const ChEdge *edge = &ch->edges[e];
+    if (edge->original_length == edge->length) {
+        addPathYear(&y, edge->original_year);
+    }
+    for (int i = ch->tri_start[e]; i < ch->tri_start[e + 1]; ++i) {
+        const ChTriangle *t = &ch->triangles[i];
+        if (q != NULL && q->restricted && isVertexExcluded(q->ws, t->middle)) {
+            continue;
+        }
+        ChYears a = edgeYears(ch, q, t->first);
+        ChYears b = edgeYears(ch, q, t->second);
+        if (a.count > 0 && b.count > 0) {
+            addComposedYears(&y, a, b);
+        }
+    }
+    return y;
+}
+
+/** @brief Przelicza lata wszystkich krawędzi.
+ * Krawędzie są przetwarzane w kolejności ściągania niższych końców, więc
+ * krawędzie tworzące skrót są przeliczone przed nim.
+ * @param[in,out] ch        - hierarchia
+ */
+static void customise(ContractionHierarchy *ch) {
+    for (size_t i = 0; i < ch->edges_no; ++i) {
+        int e = ch->custom_order[i];
+        ch->years[e] = computeYears(ch, NULL, e);
+    }
+    ch->needs_customisation = false;
+}
+
+/** @brief Przygotowuje tablice zapytań.
+ * @param[in,out] ch        - hierarchia
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status allocateQueries(ContractionHierarchy *ch) {
+    size_t n = ch->cities_no > 0 ? ch->cities_no : 1;
+    size_t m = ch->edges_no > 0 ? ch->edges_no : 1;
+    for (int i = 0; i < 2; ++i) {
+        ChSide *s = &ch->sides[i];
+        s->dist = malloc(n * sizeof(uint64_t));
+        s->year = malloc(n * sizeof(int));
+        s->pred = malloc(n * sizeof(int));
+        s->ways = malloc(n * sizeof(unsigned char));
+        s->labelled = calloc(n, sizeof(unsigned));
+        s->settled = calloc(n, sizeof(unsigned));
+        s->order = malloc(n * sizeof(int));
+        CHECK_RET(s->dist && s->year && s->pred && s->ways && s->labelled &&
+                  s->settled && s->order);
+    }
+    ch->tainted = calloc(m, sizeof(unsigned));
+    ch->restricted = malloc(m * sizeof(ChYears));
+    ch->tainted_list = malloc(m * sizeof(int));
+    ch->years = malloc(m * sizeof(ChYears));
+    CHECK_RET(ch->tainted && ch->restricted && ch->tainted_list && ch->years);
+    return true;
+}
+
+/** @brief Przenosi wynik ściągania do hierarchii i buduje jej indeksy.
+ * @param[in,out] ch        - hierarchia
+ * @param[in,out] b         - struktury pomocnicze po ściągnięciu wierzchołków
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status finishHierarchy(ContractionHierarchy *ch, Builder *b) {
+    size_t n = b->cities_no;
+    size_t m = b->edges_no;
+    ch->cities_no = n;
+    ch->edges_no = m;
+    ch->rank = b->rank;
+    b->rank = NULL;
+    ch->edges = b->edges;
+    b->edges = NULL;
+    for (size_t e = 0; e < m; ++e) {
+        ChEdge *edge = &ch->edges[e];
+        if (ch->rank[edge->low] > ch->rank[edge->high]) {
+            int tmp = edge->low;
+            edge->low = edge->high;
+            edge->high = tmp;
+        }
+    }
+
+    // trójkąty skrótów, które później skrócono, nie reprezentują najkrótszych
+    // ścieżek
+    size_t t_no = 0;
+    for (size_t i = 0; i < b->triangles_no; ++i) {
+        ChTriangle t = b->triangles[i];
+        if (ch->edges[t.first].length + ch->edges[t.second].length ==
+            ch->edges[t.edge].length) {
+            b->triangles[t_no++] = t;
+        }
+    }
+
+    Status ret = false;
+    int *keys = malloc((2 * t_no + m + 1) * sizeof(int));
+    int *items = NULL;
+    CHECK_RET(keys);
+
+    for (size_t i = 0; i < t_no; ++i) {
+        keys[i] = b->triangles[i].edge;
+    }
+    if (!bucketSort(m, keys, t_no, &ch->tri_start, &items)) {
+        goto FREE;
+    }
+    ch->triangles = malloc((t_no > 0 ? t_no : 1) * sizeof(ChTriangle));
+    if (ch->triangles == NULL) {
+        goto FREE;
+    }
+    for (size_t i = 0; i < t_no; ++i) {
+        ch->triangles[i] = b->triangles[items[i]];
+    }
+    free(items);
+    items = NULL;
+
+    for (size_t i = 0; i < t_no; ++i) {
+        keys[i] = ch->triangles[i].middle;
+    }
+    if (!bucketSort(n, keys, t_no, &ch->mid_start, &ch->mid_triangles)) {
+        goto FREE;
+    }
+
+    for (size_t i = 0; i < t_no; ++i) {
+        keys[2 * i] = ch->triangles[i].first;
+        keys[2 * i + 1] = ch->triangles[i].second;
+    }
+    if (!bucketSort(m, keys, 2 * t_no, &ch->use_start, &ch->uses)) {
+        goto FREE;
+    }
+    for (size_t i = 0; i < 2 * t_no; ++i) {
+        ch->uses[i] = ch->triangles[ch->uses[i] / 2].edge;
+    }
+
+    for (size_t e = 0; e < m; ++e) {
+        keys[e] = ch->edges[e].low;
+    }
+    if (!bucketSort(n, keys, m, &ch->up_start, &ch->up_edges)) {
+        goto FREE;
+    }
+    for (size_t e = 0; e < m; ++e) {
+        keys[e] = ch->rank[ch->edges[e].low];
+    }
+    if (!bucketSort(n, keys, m, &items, &ch->custom_order)) {
+        goto FREE;
+    }
+    if (!allocateQueries(ch)) {
+        goto FREE;
+    }
+    customise(ch);
+    ret = true;
+FREE:
+    free(items);
+    free(keys);
+    return ret;
+}
+
+/** @brief Ściąga wszystkie wierzchołki mapy.
+ * @param[out] b            - struktury pomocnicze, które należy zwolnić
+ * @ref freeBuilder również w przypadku błędu
+ * @param[in] map           - mapa dróg
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status contractMap(Builder *b, Map *map) {
+    size_t n = map->city_to_int.table.size;
+    *b = (Builder){0};
+    b->cities_no = n;
+    b->wheap = newHeap(HEAP_INITIAL_CAPACITY);
+    b->adj = calloc(n + 1, sizeof(IntArray));
+    b->rank = malloc((n + 1) * sizeof(int));
+    b->deleted = calloc(n + 1, sizeof(int));
+    b->level = calloc(n + 1, sizeof(int));
+    b->wdist = malloc((n + 1) * sizeof(uint64_t));
+    b->wstamp = calloc(n + 1, sizeof(unsigned));
+    CHECK_RET(initChEdgeIndex(&b->index));
+    CHECK_RET(b->wheap.array != NULL && b->adj != NULL &&
+              b->rank != NULL && b->deleted != NULL && b->level != NULL &&
+              b->wdist != NULL && b->wstamp != NULL);
+    for (size_t v = 0; v < n; ++v) {
+        b->rank[v] = -1;
+        RoadIterator it = iterateRoads(map->graph, v);
+        Road road;
+        while (nextRoad(&it, &road)) {
+            if (road.start < road.end &&
+                addEdge(b, road.start, road.end, road.length,
+                        road.builtYear, true) == -1) {
+                return false;
+            }
+        }
+    }
+    return contractAll(b);
+}
+
+/** @brief Buduje hierarchię od nowa.
+ * @param[in,out] ch        - hierarchia
+ * @param[in] map           - mapa dróg
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status buildHierarchy(ContractionHierarchy *ch, Map *map) {
+    freeHierarchyData(ch);
+    Builder b;
+    Status ret = contractMap(&b, map) && finishHierarchy(ch, &b);
+    freeBuilder(&b);
+    if (!ret) {
+        freeHierarchyData(ch);
+        return false;
+    }
+    ch->valid = true;
+    ch->fallback_work = 0;
+    return true;
+}
+
+Status contractionOrder(Map *map, int *order) {
+    Builder b;
+    Status ret = contractMap(&b, map);
+    for (size_t v = 0; ret && v < b.cities_no; ++v) {
+        order[b.cities_no - 1 - b.rank[v]] = v;
+    }
+    freeBuilder(&b);
+    return ret;
+}
+
+Status updateContractionHierarchy(ContractionHierarchy *ch, Map *map) {
+    if (ch->cities_no != map->city_to_int.table.size) {
+        invalidateContractionHierarchy(ch);
+    }
+    if (!ch->valid && ch->fallback_work >=
+                          REBUILD_WORK_FACTOR * map->city_to_int.table.size) {
+        CHECK_RET(buildHierarchy(ch, map));
+    }
+    if (ch->valid && ch->needs_customisation) {
+        customise(ch);
+    }
+    return true;
+}
+
+/** @brief Znajduje krawędź hierarchii łączącą dwa wierzchołki.
+ * @param[in] ch            - hierarchia
+ * @param[in] id1           - jeden koniec krawędzi
+ * @param[in] id2           - drugi koniec krawędzi
+ * @return Numer krawędzi lub -1, jeśli takiej nie ma.
+ */
+static int findEdge(ContractionHierarchy *ch, int id1, int id2) {
+    int low = ch->rank[id1] < ch->rank[id2] ? id1 : id2;
+    int high = low == id1 ? id2 : id1;
+    for (int i = ch->up_start[low]; i < ch->up_start[low + 1]; ++i) {
+        if (ch->edges[ch->up_edges[i]].high == high) {
+            return ch->up_edges[i];
+        }
+    }
+    return -1;
+}
+
+/** @brief Rozpoczyna nowe pokolenie zbioru krawędzi.
+ * @param[in,out] ch        - hierarchia
+ */
+static void beginEdgeEpoch(ContractionHierarchy *ch) {
+    if (++ch->edge_epoch == 0) {
+        memset(ch->tainted, 0, ch->edges_no * sizeof(unsigned));
+        ch->edge_epoch = 1;
+    }
+    ch->tainted_count = 0;
+}
+
+/** @brief Dodaje krawędź do zbioru krawędzi bieżącego pokolenia.
+ * @param[in,out] ch        - hierarchia
+ * @param[in] e             - krawędź
+ */
+static void markEdge(ContractionHierarchy *ch, int e) {
+    if (ch->tainted[e] != ch->edge_epoch) {
+        ch->tainted[e] = ch->edge_epoch;
+        ch->tainted_list[ch->tainted_count++] = e;
+    }
+}
+
+/** @brief Przelicza lata krawędzi ze zbioru bieżącego pokolenia.
+ * Krawędzie są przetwarzane w kolejności ściągania niższych końców. Jeśli
+ * podano zapytanie, wynik trafia do tablicy lat z wykluczeniami.
+ * @param[in,out] ch        - hierarchia
+ * @param[in] q             - zapytanie lub NULL
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status recomputeMarked(ContractionHierarchy *ch, ChQuery *q) {
+    ch->heap.size = 0;
+    for (size_t i = 0; i < ch->tainted_count; ++i) {
+        int e = ch->tainted_list[i];
+        uint64_t key = ch->rank[ch->edges[e].low];
+        CHECK_RET(pushHeap(&ch->heap, (HeapEntry){key, 0, 0, e}));
+    }
+    while (!isEmptyHeap(&ch->heap)) {
+        int e = topHeap(&ch->heap).vertex;
+        popHeap(&ch->heap);
+        if (q != NULL) {
+            ch->restricted[e] = computeYears(ch, q, e);
+        } else {
+            ch->years[e] = computeYears(ch, NULL, e);
+        }
+    }
+    return true;
+}
+
+void contractionRepairRoad(ContractionHierarchy *ch, int id1, int id2,
+                           int year) {
+    if (!ch->valid) {
+        return;
+    }
+    int e = findEdge(ch, id1, id2);
+    if (e == -1 || ch->edges[e].original_length == 0) {
+        ch->needs_customisation = true;
+        return;
+    }
+    ch->edges[e].original_year = year;
+    if (ch->edges[e].original_length != ch->edges[e].length) {
+        return;
+    }
+    // przeliczenie lat wszystkich skrótów zawierających odcinek
+    beginEdgeEpoch(ch);
+    markEdge(ch, e);
+    for (size_t i = 0; i < ch->tainted_count; ++i) {
+        int f = ch->tainted_list[i];
+        for (int j = ch->use_start[f]; j < ch->use_start[f + 1]; ++j) {
+            markEdge(ch, ch->uses[j]);
+        }
+    }
+    if (!recomputeMarked(ch, NULL)) {
+        ch->needs_customisation = true;
+    }
+}
+
+/** @brief Przelicza lata krawędzi, których ścieżki mogą przechodzić przez
+ * wykluczone wierzchołki.
+ * @param[in,out] ch        - hierarchia
+ * @param[in] q             - zapytanie
+ * @param[out] feasible     - czy liczba takich krawędzi nie przekracza
+ * @ref MAX_TAINTED
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status restrictYears(ContractionHierarchy *ch, ChQuery *q,
+                            bool *feasible) {
+    const int *excluded;
+    size_t excluded_no = excludedVertices(q->ws, &excluded);
+    *feasible = excluded_no <= MAX_EXCLUDED;
+    q->restricted = false;
+    if (!*feasible) {
+        return true;
+    }
+    beginEdgeEpoch(ch);
+    for (size_t i = 0; i < excluded_no; ++i) {
+        int x = excluded[i];
+        if (!isVertexExcluded(q->ws, x)) {
+            continue;
+        }
+        q->restricted = true;
+        for (int j = ch->mid_start[x]; j < ch->mid_start[x + 1]; ++j) {
+            markEdge(ch, ch->triangles[ch->mid_triangles[j]].edge);
+        }
+    }
+    for (size_t i = 0; i < ch->tainted_count && *feasible; ++i) {
+        int f = ch->tainted_list[i];
+        for (int j = ch->use_start[f]; j < ch->use_start[f + 1]; ++j) {
+            markEdge(ch, ch->uses[j]);
+        }
+        *feasible = ch->tainted_count <= MAX_TAINTED;
+    }
+    if (!*feasible) {
+        return true;
+    }
+    return recomputeMarked(ch, q);
+}
+
+/** @brief Rozpoczyna nowe pokolenie wyszukiwań w hierarchii.
+ * @param[in,out] ch        - hierarchia
+ */
+static void beginSearchEpoch(ContractionHierarchy *ch) {
+    if (++ch->epoch == 0) {
+        for (int i = 0; i < 2; ++i) {
+            memset(ch->sides[i].labelled, 0, ch->cities_no * sizeof(unsigned));
+            memset(ch->sides[i].settled, 0, ch->cities_no * sizeof(unsigned));
+        }
+        ch->epoch = 1;
+    }
+}
+
+/** @brief Wyszukuje najkrótsze ścieżki w górę hierarchii.
+ * Etykiety (długość, rok) porządkowane są jak w @ref shortestPaths.
+ * @param[in,out] ch        - hierarchia
+ * @param[in] q             - zapytanie
+ * @param[in,out] s         - wyszukiwanie
+ * @param[in] source        - wierzchołek początkowy
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status upwardSearch(ContractionHierarchy *ch, ChQuery *q, ChSide *s,
+                           int source) {
+    s->source = source;
+    s->settled_count = 0;
+    s->touched_count = 1;
+    s->labelled[source] = ch->epoch;
+    s->dist[source] = 0;
+    s->year[source] = INT_MAX;
+    ch->heap.size = 0;
+    CHECK_RET(pushHeap(&ch->heap, (HeapEntry){0, 0, INT_MAX, source}));
+    while (!isEmptyHeap(&ch->heap)) {
+        int x = topHeap(&ch->heap).vertex;
+        popHeap(&ch->heap);
+        if (s->settled[x] == ch->epoch) {
+            continue;
+        }
+        s->settled[x] = ch->epoch;
+        s->order[s->settled_count++] = x;
+        for (int i = ch->up_start[x]; i < ch->up_start[x + 1]; ++i) {
+            int e = ch->up_edges[i];
+            int y = ch->edges[e].high;
+            if (q->restricted && y != q->A && y != q->B &&
+                isVertexExcluded(q->ws, y)) {
+                continue;
+            }
+            ChYears years = edgeYears(ch, q, e);
+            if (years.count == 0) {
+                continue;
+            }
+            uint64_t dist = s->dist[x] + ch->edges[e].length;
+            int year = min(s->year[x], years.best);
+            if (s->labelled[y] == ch->epoch &&
+                (dist > s->dist[y] ||
+                 (dist == s->dist[y] && year <= s->year[y]))) {
+                continue;
+            }
+            if (s->labelled[y] != ch->epoch) {
+                s->labelled[y] = ch->epoch;
+                s->touched_count++;
+            }
+            s->dist[y] = dist;
+            s->year[y] = year;
+            CHECK_RET(pushHeap(&ch->heap, (HeapEntry){dist, dist, year, y}));
+        }
+    }
+    return true;
+}
+
+/** @brief Liczy optymalne ścieżki w górę hierarchii.
+ * Przegląda wierzchołki w kolejności ustalania etykiet, przekazując liczby
+ * ścieżek wzdłuż krawędzi leżących na najkrótszych ścieżkach.
+ * @param[in,out] ch        - hierarchia
+ * @param[in] q             - zapytanie
+ * @param[in,out] s         - zakończone wyszukiwanie
+ * @param[in] threshold     - rok najdawniej zbudowanego odcinka
+ */
+static void countUpwardPaths(ContractionHierarchy *ch, ChQuery *q, ChSide *s,
+                             int threshold) {
+    for (size_t i = 0; i < s->settled_count; ++i) {
+        s->ways[s->order[i]] = 0;
+    }
+    s->ways[s->source] = 1;
+    for (size_t i = 0; i < s->settled_count; ++i) {
+        int x = s->order[i];
+        if (s->ways[x] == 0) {
+            continue;
+        }
+        for (int j = ch->up_start[x]; j < ch->up_start[x + 1]; ++j) {
+            int e = ch->up_edges[j];
+            int y = ch->edges[e].high;
+            if (s->settled[y] != ch->epoch ||
+                s->dist[x] + ch->edges[e].length != s->dist[y]) {
+                continue;
+            }
+            unsigned count = countAtLeast(edgeYears(ch, q, e), threshold);
+            if (count == 0) {
+                continue;
+            }
+            unsigned ways = s->ways[y] + s->ways[x] * count;
+            s->ways[y] = ways < MANY_PATHS ? ways : MANY_PATHS;
+            s->pred[y] = e;
+        }
+    }
+}
+
+/** @brief Wyszukuje w górę hierarchii z obu końców.
+ * @param[in,out] ch        - hierarchia
+ * @param[in] q             - zapytanie
+ * @param[out] d            - długość najkrótszej ścieżki
+ * @param[out] threshold    - rok najdawniej zbudowanego odcinka optymalnej
+ * ścieżki
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status searchBothSides(ContractionHierarchy *ch, ChQuery *q,
+                              uint64_t *d, int *threshold) {
+    beginSearchEpoch(ch);
+    ChSide *fwd = &ch->sides[0];
+    ChSide *bwd = &ch->sides[1];
+    CHECK_RET(upwardSearch(ch, q, fwd, q->A));
+    CHECK_RET(upwardSearch(ch, q, bwd, q->B));
+    *d = INFINITY;
+    *threshold = INT_MIN;
+    for (size_t i = 0; i < fwd->settled_count; ++i) {
+        int x = fwd->order[i];
+        if (bwd->settled[x] != ch->epoch) {
+            continue;
+        }
+        uint64_t dist = fwd->dist[x] + bwd->dist[x];
+        int year = min(fwd->year[x], bwd->year[x]);
+        if (dist < *d || (dist == *d && year > *threshold)) {
+            *d = dist;
+            *threshold = year;
+        }
+    }
+    return true;
+}
+
+/** @brief Dolicza wyszukiwania w hierarchii do liczników obszaru roboczego.
+ * @param[in] ch            - hierarchia
+ * @param[in,out] ws        - obszar roboczy
+ */
+static void accountQuery(ContractionHierarchy *ch, SearchWorkspace *ws) {
+    SearchStats *stats = workspaceStats(ws);
+    for (int i = 0; i < 2; ++i) {
+        stats->settled += ch->sides[i].settled_count;
+        stats->touched += ch->sides[i].touched_count;
+    }
+}
+
+/** @brief Dopisuje do tablicy przodków ścieżkę reprezentowaną przez krawędź.
+ * Wybiera jedyną ścieżkę, której odcinki zbudowano nie wcześniej niż w roku
+ * @p threshold.
+ * @param[in,out] ch        - hierarchia
+ * @param[in] q             - zapytanie
+ * @param[in] e             - krawędź
+ * @param[in] from          - koniec krawędzi, od którego zaczyna się ścieżka
+ * @param[in] threshold     - rok najdawniej zbudowanego odcinka
+ * @param[in,out] prev      - tablica przodków
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status unpackEdge(ContractionHierarchy *ch, ChQuery *q, int e, int from,
+                         int threshold, int *prev) {
+    IntArray *stack = &ch->stack;
+    stack->size = 0;
+    CHECK_RET(appendInt(stack, e));
+    CHECK_RET(appendInt(stack, from));
+    while (stack->size > 0) {
+        int u = stack->array[--stack->size];
+        int f = stack->array[--stack->size];
+        const ChEdge *edge = &ch->edges[f];
+        int w = otherEnd(edge, u);
+        if (edge->original_length == edge->length &&
+            edge->original_year >= threshold) {
+            prev[w] = u;
+            continue;
+        }
+        for (int i = ch->tri_start[f]; i < ch->tri_start[f + 1]; ++i) {
+            const ChTriangle *t = &ch->triangles[i];
+            if (q->restricted && isVertexExcluded(q->ws, t->middle)) {
+                continue;
+            }
+            if (countAtLeast(edgeYears(ch, q, t->first), threshold) > 0 &&
+                countAtLeast(edgeYears(ch, q, t->second), threshold) > 0) {
+                int to_middle = ch->edges[t->first].low == u ||
+                                        ch->edges[t->first].high == u
+                                    ? t->first
+                                    : t->second;
+                int from_middle = to_middle == t->first ? t->second : t->first;
+                CHECK_RET(appendInt(stack, from_middle));
+                CHECK_RET(appendInt(stack, t->middle));
+                CHECK_RET(appendInt(stack, to_middle));
+                CHECK_RET(appendInt(stack, u));
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+/** @brief Zapisuje w tablicy przodków jedyną optymalną ścieżkę.
+ * @param[in,out] ch        - hierarchia
+ * @param[in] q             - zapytanie
+ * @param[in] peak          - najwyższy wierzchołek ścieżki
+ * @param[in] threshold     - rok najdawniej zbudowanego odcinka
+ * @param[in,out] prev      - tablica przodków
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status writePath(ContractionHierarchy *ch, ChQuery *q, int peak,
+                        int threshold, int *prev) {
+    ChSide *fwd = &ch->sides[0];
+    ChSide *bwd = &ch->sides[1];
+    ch->path.size = 0;
+    for (int x = peak; x != q->A;) {
+        CHECK_RET(appendInt(&ch->path, fwd->pred[x]));
+        x = otherEnd(&ch->edges[fwd->pred[x]], x);
+    }
+    prev[q->A] = -1;
+    int x = q->A;
+    while (ch->path.size > 0) {
+        int e = ch->path.array[--ch->path.size];
+        CHECK_RET(unpackEdge(ch, q, e, x, threshold, prev));
+        x = otherEnd(&ch->edges[e], x);
+    }
+    while (x != q->B) {
+        int e = bwd->pred[x];
+        CHECK_RET(unpackEdge(ch, q, e, x, threshold, prev));
+        x = otherEnd(&ch->edges[e], x);
+    }
+    return true;
+}
+
+Status contractionShortestPaths(ContractionHierarchy *ch, SearchWorkspace *ws,
+                                int A, int B, uint64_t *d, int *w,
+                                bool *answered) {
+    *answered = false;
+    if (!ch->valid || A == B || (size_t)(A > B ? A : B) >= ch->cities_no ||
+        isVertexExcluded(ws, A) || isVertexExcluded(ws, B)) {
+        return true;
+    }
+    ChQuery q = {ws, A, B, false};
+    workspaceStats(ws)->searches++;
+
+    // Skróty reprezentują jedynie najkrótsze ścieżki w całym grafie, więc
+    // wynik z wykluczeniami jest dokładny tylko wtedy, gdy wykluczenia nie
+    // wydłużają najkrótszej ścieżki.
+    uint64_t plain = INFINITY;
+    int threshold;
+    CHECK_RET(searchBothSides(ch, &q, &plain, &threshold));
+    accountQuery(ch, ws);
+    bool feasible;
+    CHECK_RET(restrictYears(ch, &q, &feasible));
+    if (!feasible) {
+        return true;
+    }
+    if (q.restricted) {
+        uint64_t dist;
+        CHECK_RET(searchBothSides(ch, &q, &dist, &threshold));
+        accountQuery(ch, ws);
+        if (dist != plain) {
+            return true;
+        }
+    }
+    *answered = true;
+    *d = plain;
+    *w = threshold;
+    if (plain == INFINITY) {
+        return true;
+    }
+
+    ChSide *fwd = &ch->sides[0];
+    ChSide *bwd = &ch->sides[1];
+    countUpwardPaths(ch, &q, fwd, threshold);
+    countUpwardPaths(ch, &q, bwd, threshold);
+    unsigned ways = 0;
+    int peak = -1;
+    for (size_t i = 0; i < fwd->settled_count && ways < MANY_PATHS; ++i) {
+        int x = fwd->order[i];
+        if (bwd->settled[x] == ch->epoch &&
+            fwd->dist[x] + bwd->dist[x] == plain &&
+            fwd->ways[x] * bwd->ways[x] > 0) {
+            ways += fwd->ways[x] * bwd->ways[x];
+            peak = x;
+        }
+    }
+    CHECK_RET(ways == 1);
+    return writePath(ch, &q, peak, threshold, searchPrev(ws));
+}
@@ -0,0 +1,104 @@
+/** @file
+ * Hierarchia skrótów (ang. contraction hierarchy) przyspieszająca
+ * wyszukiwanie najkrótszych ścieżek na rzadko zmienianej mapie.
+ */
+#ifndef __CONTRACTION_H__
+#define __CONTRACTION_H__
+
+#include "map_struct.h"
+#include "shortest_paths.h"
+
+/**
+ * Hierarchia skrótów.
+ * Wierzchołki są kolejno usuwane (ściągane) z grafu, a najkrótsze ścieżki
+ * przechodzące przez usuwany wierzchołek są zastępowane skrótami. Każda
+ * krawędź hierarchii reprezentuje wszystkie najkrótsze ścieżki między swoimi
+ * końcami, których wierzchołki wewnętrzne zostały ściągnięte wcześniej niż
+ * oba końce, wraz z dwoma największymi (z powtórzeniami) latami najdawniej
+ * zbudowanych odcinków tych ścieżek. Każda najkrótsza ścieżka w grafie
+ * odpowiada dokładnie jednej ścieżce w hierarchii, która najpierw wznosi się,
+ * a potem opada - dzięki temu zapytanie rozstrzyga również jednoznaczność
+ * optymalnej ścieżki. Hierarchia przechowuje struktury pomocnicze zapytań,
+ * więc nie może być używana przez kilka wątków jednocześnie.
+ */
+typedef struct ContractionHierarchy ContractionHierarchy;
+
+/** @brief Tworzy pustą (nieaktualną) hierarchię skrótów.
+ * @return Wskaźnik na hierarchię lub NULL, gdy nie udało się zaalokować
+ * pamięci.
+ */
+ContractionHierarchy *newContractionHierarchy(void);
+
+/** @brief Zwalnia hierarchię skrótów.
+ * @param[in,out] ch        - hierarchia do zwolnienia
+ */
+void deleteContractionHierarchy(ContractionHierarchy *ch);
+
+/** @brief Oznacza hierarchię jako nieaktualną po zmianie sieci dróg.
+ * @param[in,out] ch        - hierarchia
+ */
+void invalidateContractionHierarchy(ContractionHierarchy *ch);
+
+/** @brief Przygotowuje hierarchię do odpowiadania na zapytania.
+ * Nieaktualna hierarchia jest budowana od nowa dopiero wtedy, gdy praca
+ * wykonana przez zwykłe wyszukiwania od chwili jej unieważnienia przekroczy
+ * szacowany koszt budowy - dzięki temu częste zmiany sieci dróg nie powodują
+ * ciągłego przebudowywania.
+ * @param[in,out] ch        - hierarchia
+ * @param[in] map           - mapa dróg
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status updateContractionHierarchy(ContractionHierarchy *ch, Map *map);
+
+/** @brief Odnotowuje pracę wykonaną przez zwykłe wyszukiwanie.
+ * @param[in,out] ch        - hierarchia
+ * @param[in] settled       - liczba wierzchołków ustalonych przez wyszukiwanie
+ */
+void contractionFallbackWork(ContractionHierarchy *ch, uint64_t settled);
+
+/** @brief Uwzględnia remont odcinka drogowego.
+ * Długości odcinków się nie zmieniają, więc wystarczy przeliczyć lata
+ * na skrótach zawierających ten odcinek - bez ponownego ściągania
+ * wierzchołków.
+ * @param[in,out] ch        - hierarchia
+ * @param[in] id1           - jeden koniec odcinka
+ * @param[in] id2           - drugi koniec odcinka
+ * @param[in] year          - nowy rok budowy lub ostatniego remontu
+ */
+void contractionRepairRoad(ContractionHierarchy *ch, int id1, int id2,
+                           int year);
+
+/** @brief Wyznacza kolejność ważności wierzchołków mapy.
+ * Wierzchołki ściągane później leżą na większej liczbie najkrótszych ścieżek,
+ * więc kolejność ta przydaje się również innym indeksom odległości.
+ * @param[in] map           - mapa dróg
+ * @param[out] order        - tablica, w której zostaną zapisane wszystkie
+ * wierzchołki, od ściągniętego jako ostatni
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status contractionOrder(Map *map, int *order);
+
+/** @brief Znajduje najkrótsze ścieżki między wierzchołkami A i B w hierarchii.
+ * Uwzględnia wierzchołki wykluczone w obszarze roboczym. Jeśli hierarchia
+ * jest nieaktualna, wykluczonych wierzchołków jest zbyt wiele, albo
+ * wykluczenia zmieniają długość najkrótszej ścieżki (skróty nie
+ * reprezentują wtedy ścieżek omijających wykluczone wierzchołki), zapytanie
+ * nie zostaje rozstrzygnięte i należy przeprowadzić zwykłe wyszukiwanie.
+ * @param[in,out] ch        - hierarchia
+ * @param[in,out] ws        - obszar roboczy ze zbiorem wykluczonych
+ * wierzchołków; w razie powodzenia ścieżkę można odczytać z @ref searchPrev
+ * @param[in] A             - wierzchołek początkowy
+ * @param[in] B             - wierzchołek końcowy
+ * @param[out] d            - długość najkrótszej ścieżki lub UINT64_MAX
+ * @param[out] w            - rok najdawniej zbudowanego odcinka optymalnej
+ * ścieżki
+ * @param[out] answered     - czy zapytanie zostało rozstrzygnięte
+ * @return Wartość logiczna, jak w przypadku @ref shortestPaths - @p false,
+ * jeśli optymalna ścieżka nie jest jedyna lub nie udało się zaalokować
+ * pamięci.
+ */
+Status contractionShortestPaths(ContractionHierarchy *ch, SearchWorkspace *ws,
+                                int A, int B, uint64_t *d, int *w,
+                                bool *answered);
+
+#endif /* __CONTRACTION_H__ */
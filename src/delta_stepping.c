@@ -0,0 +1,612 @@
+// needed for pthread_barrier_t
+#define _XOPEN_SOURCE 700
+
+#include <limits.h>
+#include <pthread.h>
+#include <string.h>
+
+#include "delta_stepping.h"
+#include "heap.h"
+#include "road_graph.h"
+#include "utils.h"
+
+#define INFINITY UINT64_MAX
+
+/**
+ * Propozycja etykiety wierzchołka, przesyłana jego właścicielowi.
+ */
+typedef struct Request {
+    /// długość ścieżki
+    uint64_t dist;
+    /// rok najdawniej zbudowanego odcinka ścieżki
+    int time;
+    /// poprzednik na ścieżce
+    int from;
+    /// wierzchołek, którego dotyczy propozycja
+    int to;
+} Request;
+
+/**
+ * Tablica propozycji wysyłanych do jednego wątku.
+ */
+typedef struct RequestBuffer {
+    /// propozycje
+    Request *array;
+    /// liczba propozycji
+    size_t size;
+    /// pojemność tablicy (zaalokowany rozmiar)
+    size_t capacity;
+} RequestBuffer;
+
+/**
+ * Stan wątku wyszukiwania.
+ */
+typedef struct Worker {
+    /// pula, do której należy wątek
+    struct DeltaStepping *ds;
+    /// numer wątku
+    unsigned id;
+    /// wątek systemowy (nieużywany przez wątek wywołujący)
+    pthread_t thread;
+    /// wierzchołki wątku do przetworzenia, z numerem kubełka jako priorytetem
+    Heap heap;
+    /// wierzchołki rozwijane w bieżącej rundzie
+    int *frontier;
+    /// liczba wierzchołków w @p frontier
+    size_t frontier_size;
+    /// wierzchołki wątku zdjęte z kopca, w kolejności zdejmowania
+    int *settled;
+    /// liczba wierzchołków w @p settled
+    size_t settled_size;
+    /// pojemność tablic @p frontier i @p settled
+    size_t capacity;
+    /// propozycje etykiet dla kolejnych wątków
+    RequestBuffer *out;
+    /// najmniejszy numer kubełka z wierzchołkami wątku lub INFINITY
+    uint64_t min_bucket;
+    /// czy nastąpił błąd alokacji pamięci
+    bool failed;
+} Worker;
+
+struct DeltaStepping {
+    /// liczba wątków
+    unsigned threads;
+    /// stany wątków; wątek 0 to wątek wywołujący wyszukiwania
+    Worker *workers;
+    /// liczba uruchomionych wątków systemowych
+    unsigned started;
+    /// bariera synchronizująca rundy wyszukiwania
+    pthread_barrier_t barrier;
+    /// blokada chroniąca @p generation i @p quit
+    pthread_mutex_t lock;
+    /// zmienna warunkowa budząca wątki
+    pthread_cond_t wake;
+    /// numer ostatniego zleconego wyszukiwania
+    unsigned generation;
+    /// czy wątki mają się zakończyć
+    bool quit;
+
+    /// mapa dróg bieżącego wyszukiwania
+    Map *map;
+    /// obszar roboczy ze zbiorem wykluczonych wierzchołków
+    const SearchWorkspace *ws;
+    /// wierzchołek początkowy
+    int A;
+    /// wierzchołek końcowy
+    int B;
+    /// czy bezpośrednia droga z A do B jest zabroniona
+    bool fixing;
+    /// szerokość kubełka
+    uint64_t delta;
+    /// liczba wierzchołków w chwili wyznaczenia @p delta
+    size_t delta_cities_no;
+
+    /// pojemność tablic indeksowanych wierzchołkami
+    size_t capacity;
+    /// pokolenie bieżącego wyszukiwania
+    unsigned epoch;
+    /// znaczniki pokolenia, w którym wierzchołek otrzymał etykietę
+    unsigned *labelled;
+    /// znaczniki pokolenia, w którym wierzchołek został zdjęty z kopca
+    unsigned *popped;
+    /// długości najkrótszych ścieżek
+    uint64_t *dist;
+    /// lata najdawniej zbudowanych odcinków
+    int *time;
+    /// poprzednicy na najlepszych ścieżkach
+    int *prev;
+
+    /// wynik wyszukiwania
+    DeltaLabel *result;
+    /// pojemność tablicy @p result
+    size_t result_capacity;
+};
+
+/** @brief Zwraca wątek odpowiedzialny za wierzchołek.
+ * @param[in] ds        - pula
+ * @param[in] v         - wierzchołek
+ * @return Stan wątku.
+ */
+static Worker *ownerOf(DeltaStepping *ds, int v) {
+    return &ds->workers[(unsigned)v % ds->threads];
+}
+
+/** @brief Stwierdza, czy wierzchołek ma etykietę w bieżącym wyszukiwaniu.
+ * @param[in] ds        - pula
+ * @param[in] v         - wierzchołek
+ * @return @p true jeśli wyszukiwanie dotarło do @p v.
+ */
+static bool isLabelled(DeltaStepping *ds, int v) {
+    return ds->labelled[v] == ds->epoch;
+}
+
+/** @brief Synchronizuje wszystkie wątki wyszukiwania.
+ * @param[in,out] ds    - pula
+ */
+static void synchronize(DeltaStepping *ds) {
+    pthread_barrier_wait(&ds->barrier);
+}
+
+/** @brief Powiększa tablicę, nie tracąc jej zawartości.
+ * @param[in,out] array     - wskaźnik na tablicę
+ * @param[in] capacity      - nowa liczba elementów
+ * @param[in] size          - rozmiar elementu
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status growArray(void *array, size_t capacity, size_t size) {
+    void **p = array;
+    void *n = realloc(*p, capacity * size);
+    CHECK_RET(n);
+    *p = n;
+    return true;
+}
+
+/** @brief Zapewnia miejsce na kolejny wierzchołek w tablicach wątku.
+ * @param[in,out] w     - wątek
+ * @param[in] size      - liczba wierzchołków w powiększanej tablicy
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status reserveWorker(Worker *w, size_t size) {
+    if (size < w->capacity) {
+        return true;
+    }
+    size_t capacity = w->capacity > 0 ? 2 * w->capacity : 16;
+    CHECK_RET(growArray(&w->frontier, capacity, sizeof(int)));
+    CHECK_RET(growArray(&w->settled, capacity, sizeof(int)));
+    w->capacity = capacity;
+    return true;
+}
+
+/** @brief Dopisuje propozycję etykiety do tablicy.
+ * @param[in,out] b     - tablica propozycji
+ * @param[in] r         - propozycja
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status pushRequest(RequestBuffer *b, Request r) {
+    if (b->size == b->capacity) {
+        size_t capacity = b->capacity > 0 ? 2 * b->capacity : 16;
+        CHECK_RET(growArray(&b->array, capacity, sizeof(Request)));
+        b->capacity = capacity;
+    }
+    b->array[b->size++] = r;
+    return true;
+}
+
+/** @brief Wyznacza najmniejszy numer kubełka z wierzchołkami wątku.
+ * Usuwa przy tym z kopca nieaktualne wpisy.
+ * @param[in,out] w     - wątek
+ * @return Numer kubełka lub INFINITY, jeśli wątek nie ma wierzchołków.
+ */
+static uint64_t minBucket(Worker *w) {
+    DeltaStepping *ds = w->ds;
+    while (!isEmptyHeap(&w->heap)) {
+        HeapEntry e = topHeap(&w->heap);
+        if (e.dist == ds->dist[e.vertex] && e.time == ds->time[e.vertex]) {
+            return e.key;
+        }
+        popHeap(&w->heap);
+    }
+    return INFINITY;
+}
+
+/** @brief Zdejmuje z kopca wierzchołki wątku należące do kubełka.
+ * @param[in,out] w     - wątek
+ * @param[in] bucket    - numer kubełka
+ */
+static void takeBucket(Worker *w, uint64_t bucket) {
+    DeltaStepping *ds = w->ds;
+    w->frontier_size = 0;
+    while (minBucket(w) == bucket) {
+        int v = topHeap(&w->heap).vertex;
+        popHeap(&w->heap);
+        if (!reserveWorker(w, w->frontier_size) ||
+            !reserveWorker(w, w->settled_size)) {
+            w->failed = true;
+            return;
+        }
+        w->frontier[w->frontier_size++] = v;
+        if (ds->popped[v] != ds->epoch) {
+            ds->popped[v] = ds->epoch;
+            w->settled[w->settled_size++] = v;
+        }
+    }
+}
+
+/** @brief Przesyła właścicielom sąsiadów propozycje etykiet.
+ * Wierzchołek B ani wierzchołki wykluczone nie są rozwijane.
+ * @param[in,out] w     - wątek
+ * @param[in] vertices  - rozwijane wierzchołki wątku
+ * @param[in] count     - liczba rozwijanych wierzchołków
+ * @param[in] heavy     - @p false, jeśli rozwijamy odcinki nie dłuższe niż
+ * szerokość kubełka, @p true jeśli pozostałe
+ */
+static void relaxEdges(Worker *w, const int *vertices, size_t count,
+                       bool heavy) {
+    DeltaStepping *ds = w->ds;
+    for (unsigned t = 0; t < ds->threads; ++t) {
+        w->out[t].size = 0;
+    }
+    uint64_t forbidden = edgeKey(ds->A, ds->B);
+    for (size_t i = 0; i < count; ++i) {
+        int x = vertices[i];
+        if (x == ds->B || isVertexExcluded(ds->ws, x)) {
+            continue;
+        }
+        RoadIterator it = iterateRoads(ds->map->graph, x);
+        Road road;
+        while (nextRoad(&it, &road)) {
+            int y = road.end;
+            if ((road.length > ds->delta) != heavy ||
+                (isVertexExcluded(ds->ws, y) && y != ds->B) ||
+                (ds->fixing &&
+                 edgeKey(road.start, road.end) == forbidden)) {
+                continue;
+            }
+            Request r = {ds->dist[x] + road.length,
+                         min(ds->time[x], road.builtYear), x, y};
+            if (!pushRequest(&w->out[ownerOf(ds, y)->id], r)) {
+                w->failed = true;
+                return;
+            }
+        }
+    }
+}
+
+/** @brief Uwzględnia propozycje etykiet wierzchołków wątku.
+ * Etykieta (długość, rok) jest lepsza, jeśli ścieżka jest krótsza, a przy
+ * równych długościach - jeśli rok jest późniejszy. Przy równych etykietach
+ * wybierany jest poprzednik o mniejszym numerze, więc wynik nie zależy od
+ * kolejności nadejścia propozycji.
+ * @param[in,out] w     - wątek
+ */
+static void applyRequests(Worker *w) {
+    DeltaStepping *ds = w->ds;
+    for (unsigned t = 0; t < ds->threads; ++t) {
+        RequestBuffer *b = &ds->workers[t].out[w->id];
+        for (size_t i = 0; i < b->size; ++i) {
+            Request r = b->array[i];
+            int y = r.to;
+            if (isLabelled(ds, y)) {
+                uint64_t old = ds->dist[y];
+                if (r.dist > old || (r.dist == old && r.time < ds->time[y])) {
+                    continue;
+                }
+                if (r.dist == old && r.time == ds->time[y]) {
+                    if (r.from < ds->prev[y]) {
+                        ds->prev[y] = r.from;
+                    }
+                    continue;
+                }
+            }
+            ds->labelled[y] = ds->epoch;
+            ds->dist[y] = r.dist;
+            ds->time[y] = r.time;
+            ds->prev[y] = r.from;
+            HeapEntry e = {r.dist / ds->delta, r.dist, r.time, y};
+            if (!pushHeap(&w->heap, e)) {
+                w->failed = true;
+                return;
+            }
+        }
+    }
+}
+
+/** @brief Stwierdza, czy któryś z wątków napotkał błąd.
+ * Wymaga synchronizacji wątków po ostatniej zmianie znaczników błędu.
+ * @param[in] ds        - pula
+ * @return @p true jeśli wyszukiwanie należy przerwać.
+ */
+static bool anyFailed(DeltaStepping *ds) {
+    for (unsigned t = 0; t < ds->threads; ++t) {
+        if (ds->workers[t].failed) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief Wyznacza kubełek przetwarzany w następnej kolejności.
+ * Wymaga synchronizacji wątków po wyznaczeniu @p min_bucket.
+ * @param[in] ds        - pula
+ * @return Najmniejszy numer niepustego kubełka, lub INFINITY jeśli wszystkie
+ * są puste albo etykiety wierzchołków bliższych niż B są już ostateczne.
+ */
+static uint64_t nextBucket(DeltaStepping *ds) {
+    uint64_t bucket = INFINITY;
+    for (unsigned t = 0; t < ds->threads; ++t) {
+        if (ds->workers[t].min_bucket < bucket) {
+            bucket = ds->workers[t].min_bucket;
+        }
+    }
+    if (isLabelled(ds, ds->B) && bucket > ds->dist[ds->B] / ds->delta) {
+        return INFINITY;
+    }
+    return bucket;
+}
+
+/** @brief Przeprowadza wyszukiwanie w jednym z wątków.
+ * Wszystkie wątki wykonują te same rundy, rozdzielone barierami: w każdej
+ * wątek rozwija swoje wierzchołki, a następnie uwzględnia propozycje
+ * etykiet swoich wierzchołków. Decyzje o kolejnej rundzie zapadają na
+ * podstawie danych opublikowanych przed barierą, więc wszystkie wątki
+ * podejmują je jednakowo.
+ * @param[in,out] w     - wątek
+ */
+static void runWorker(Worker *w) {
+    DeltaStepping *ds = w->ds;
+    w->heap.size = 0;
+    w->settled_size = 0;
+    w->failed = false;
+    for (unsigned t = 0; t < ds->threads; ++t) {
+        w->out[t].size = 0;
+    }
+    if (ownerOf(ds, ds->A) == w) {
+        HeapEntry e = {0, 0, INT_MAX, ds->A};
+        w->failed = !pushHeap(&w->heap, e);
+    }
+    while (true) {
+        w->min_bucket = minBucket(w);
+        synchronize(ds);
+        uint64_t bucket = nextBucket(ds);
+        if (bucket == INFINITY || anyFailed(ds)) {
+            break;
+        }
+        // krótkie odcinki mogą poprawić etykiety w bieżącym kubełku, więc
+        // rozwijamy je aż do ustalenia się etykiet
+        size_t first = w->settled_size;
+        do {
+            takeBucket(w, bucket);
+            relaxEdges(w, w->frontier, w->frontier_size, false);
+            synchronize(ds);
+            applyRequests(w);
+            w->min_bucket = minBucket(w);
+            synchronize(ds);
+        } while (!anyFailed(ds) && nextBucket(ds) == bucket);
+        // długie odcinki prowadzą do dalszych kubełków
+        relaxEdges(w, w->settled + first, w->settled_size - first, true);
+        synchronize(ds);
+        applyRequests(w);
+        // bariera na początku pętli kończy rundę
+    }
+    synchronize(ds);
+}
+
+/** @brief Pętla wątku puli - czeka na zlecone wyszukiwania.
+ * @param[in] arg       - stan wątku
+ * @return NULL
+ */
+static void *workerMain(void *arg) {
+    Worker *w = arg;
+    DeltaStepping *ds = w->ds;
+    unsigned seen = 0;
+    while (true) {
+        pthread_mutex_lock(&ds->lock);
+        while (ds->generation == seen && !ds->quit) {
+            pthread_cond_wait(&ds->wake, &ds->lock);
+        }
+        seen = ds->generation;
+        bool quit = ds->quit;
+        pthread_mutex_unlock(&ds->lock);
+        if (quit) {
+            return NULL;
+        }
+        runWorker(w);
+    }
+}
+
+/** @brief Zatrzymuje uruchomione wątki puli.
+ * @param[in,out] ds    - pula
+ */
+static void stopWorkers(DeltaStepping *ds) {
+    pthread_mutex_lock(&ds->lock);
+    ds->quit = true;
+    pthread_cond_broadcast(&ds->wake);
+    pthread_mutex_unlock(&ds->lock);
+    for (unsigned t = 1; t <= ds->started; ++t) {
+        pthread_join(ds->workers[t].thread, NULL);
+    }
+    ds->started = 0;
+}
+
+DeltaStepping *newDeltaStepping(unsigned threads) {
+    CHECK_RET(threads > 0);
+    DeltaStepping *ds = calloc(1, sizeof(DeltaStepping));
+    CHECK_RET(ds);
+    if (pthread_barrier_init(&ds->barrier, NULL, threads) != 0) {
+        free(ds);
+        return NULL;
+    }
+    pthread_mutex_init(&ds->lock, NULL);
+    pthread_cond_init(&ds->wake, NULL);
+    ds->threads = threads;
+    ds->workers = calloc(threads, sizeof(Worker));
+    if (ds->workers == NULL) {
+        goto DELETE;
+    }
+    for (unsigned t = 0; t < threads; ++t) {
+        Worker *w = &ds->workers[t];
+        w->ds = ds;
+        w->id = t;
+        w->heap = newHeap(16);
+        w->out = calloc(threads, sizeof(RequestBuffer));
+        if (w->heap.array == NULL || w->out == NULL) {
+            goto DELETE;
+        }
+    }
+    for (unsigned t = 1; t < threads; ++t) {
+        if (pthread_create(&ds->workers[t].thread, NULL, workerMain,
+                           &ds->workers[t]) != 0) {
+            goto DELETE;
+        }
+        ds->started = t;
+    }
+    return ds;
+
+DELETE:
+    deleteDeltaStepping(ds);
+    return NULL;
+}
+
+void deleteDeltaStepping(DeltaStepping *ds) {
+    if (ds == NULL) {
+        return;
+    }
+    stopWorkers(ds);
+    pthread_barrier_destroy(&ds->barrier);
+    pthread_cond_destroy(&ds->wake);
+    pthread_mutex_destroy(&ds->lock);
+    for (unsigned t = 0; ds->workers != NULL && t < ds->threads; ++t) {
+        Worker *w = &ds->workers[t];
+        deleteHeap(&w->heap);
+        free(w->frontier);
+        free(w->settled);
+        for (unsigned i = 0; w->out != NULL && i < ds->threads; ++i) {
+            free(w->out[i].array);
+        }
+        free(w->out);
+    }
+    free(ds->workers);
+    free(ds->labelled);
+    free(ds->popped);
+    free(ds->dist);
+    free(ds->time);
+    free(ds->prev);
+    free(ds->result);
+    free(ds);
+}
+
+/** @brief Zapewnia, że tablice puli mieszczą @p cities_no wierzchołków.
+ * @param[in,out] ds        - pula
+ * @param[in] cities_no     - liczba wierzchołków grafu
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status reserveDeltaStepping(DeltaStepping *ds, size_t cities_no) {
+    if (cities_no <= ds->capacity) {
+        return true;
+    }
+    size_t capacity = 2 * ds->capacity;
+    if (capacity < cities_no) {
+        capacity = cities_no;
+    }
+    CHECK_RET(growArray(&ds->labelled, capacity, sizeof(unsigned)));
+    CHECK_RET(growArray(&ds->popped, capacity, sizeof(unsigned)));
+    CHECK_RET(growArray(&ds->dist, capacity, sizeof(uint64_t)));
+    CHECK_RET(growArray(&ds->time, capacity, sizeof(int)));
+    CHECK_RET(growArray(&ds->prev, capacity, sizeof(int)));
+    size_t added = capacity - ds->capacity;
+    memset(ds->labelled + ds->capacity, 0, added * sizeof(unsigned));
+    memset(ds->popped + ds->capacity, 0, added * sizeof(unsigned));
+    ds->capacity = capacity;
+    return true;
+}
+
+/** @brief Wyznacza szerokość kubełka - średnią długość odcinka drogowego.
+ * Szerokość jest wyznaczana ponownie, gdy zmieni się liczba miast. Wpływa
+ * ona jedynie na szybkość wyszukiwania.
+ * @param[in,out] ds        - pula
+ * @param[in] map           - mapa dróg
+ */
+static void updateDelta(DeltaStepping *ds, Map *map) {
+    size_t cities_no = map->city_to_int.table.size;
+    if (ds->delta > 0 && ds->delta_cities_no == cities_no) {
+        return;
+    }
+    uint64_t sum = 0;
+    uint64_t roads = 0;
+    for (size_t v = 0; v < cities_no; ++v) {
+        RoadIterator it = iterateRoads(map->graph, v);
+        Road road;
+        while (nextRoad(&it, &road)) {
+            uint64_t length = road.length;
+            sum = sum + length < sum ? UINT64_MAX : sum + length;
+            roads++;
+        }
+    }
+    ds->delta = roads > 0 && sum / roads > 0 ? sum / roads : 1;
+    ds->delta_cities_no = cities_no;
+}
+
+/** @brief Porównuje etykiety według długości ścieżek.
+ * @param[in] a         - pierwsza etykieta
+ * @param[in] b         - druga etykieta
+ * @return Liczba ujemna, zero lub dodatnia, jeśli @p a jest odpowiednio
+ * bliższa, równie odległa lub dalsza od źródła niż @p b.
+ */
+static int cmpLabels(const void *a, const void *b) {
+    const DeltaLabel *x = a;
+    const DeltaLabel *y = b;
+    if (x->dist != y->dist) {
+        return x->dist < y->dist ? -1 : 1;
+    }
+    return (x->vertex > y->vertex) - (x->vertex < y->vertex);
+}
+
+Status deltaStepping(DeltaStepping *ds, Map *map, const SearchWorkspace *ws,
+                     int A, int B, bool fixing, const DeltaLabel **labels,
+                     size_t *count) {
+    CHECK_RET(reserveDeltaStepping(ds, map->city_to_int.table.size));
+    updateDelta(ds, map);
+    if (++ds->epoch == 0) {
+        memset(ds->labelled, 0, ds->capacity * sizeof(unsigned));
+        memset(ds->popped, 0, ds->capacity * sizeof(unsigned));
+        ds->epoch = 1;
+    }
+    ds->map = map;
+    ds->ws = ws;
+    ds->A = A;
+    ds->B = B;
+    ds->fixing = fixing;
+    ds->labelled[A] = ds->epoch;
+    ds->dist[A] = 0;
+    ds->time[A] = INT_MAX;
+    ds->prev[A] = -1;
+
+    pthread_mutex_lock(&ds->lock);
+    ds->generation++;
+    pthread_cond_broadcast(&ds->wake);
+    pthread_mutex_unlock(&ds->lock);
+    runWorker(&ds->workers[0]);
+    CHECK_RET(!anyFailed(ds));
+
+    size_t total = 0;
+    for (unsigned t = 0; t < ds->threads; ++t) {
+        total += ds->workers[t].settled_size;
+    }
+    if (total > ds->result_capacity) {
+        CHECK_RET(growArray(&ds->result, total, sizeof(DeltaLabel)));
+        ds->result_capacity = total;
+    }
+    size_t n = 0;
+    for (unsigned t = 0; t < ds->threads; ++t) {
+        Worker *w = &ds->workers[t];
+        for (size_t i = 0; i < w->settled_size; ++i) {
+            int v = w->settled[i];
+            ds->result[n++] =
+                (const DeltaLabel){ds->dist[v], ds->time[v], ds->prev[v], v};
+        }
+    }
+    qsort(ds->result, n, sizeof(DeltaLabel), cmpLabels);
+    *labels = ds->result;
+    *count = n;
+    return true;
+}
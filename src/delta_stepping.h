@@ -0,0 +1,72 @@
+/** @file
+ * Równoległe wyszukiwanie najkrótszych ścieżek z jednego źródła metodą
+ * delta-stepping.
+ */
+#ifndef __DELTA_STEPPING_H__
+#define __DELTA_STEPPING_H__
+
+#include "shortest_paths.h"
+
+/**
+ * Pula wątków wyszukiwania delta-stepping wraz z jego tablicami pomocniczymi.
+ * Wierzchołki są rozdzielone między wątki (wierzchołek v należy do wątku
+ * v mod liczba wątków) i tylko właściciel zmienia etykietę wierzchołka -
+ * pozostałe wątki przesyłają mu propozycje etykiet. Dzięki temu wątki nie
+ * potrzebują blokad, a wynik nie zależy od przeplotu.
+ */
+typedef struct DeltaStepping DeltaStepping;
+
+/**
+ * Ostateczna etykieta wierzchołka wyznaczona przez wyszukiwanie.
+ */
+typedef struct DeltaLabel {
+    /// długość najkrótszej ścieżki
+    uint64_t dist;
+    /// najpóźniejszy możliwy rok najdawniej zbudowanego odcinka na
+    /// najkrótszej ścieżce
+    int time;
+    /// poprzednik na najlepszej ścieżce (-1 dla źródła)
+    int prev;
+    /// wierzchołek
+    int vertex;
+} DeltaLabel;
+
+/** @brief Tworzy pulę wątków wyszukiwania.
+ * @param[in] threads       - liczba wątków (łącznie z wątkiem wywołującym
+ * wyszukiwania), co najmniej 1
+ * @return Wskaźnik na pulę lub NULL, gdy nie udało się zaalokować pamięci lub
+ * uruchomić wątków.
+ */
+DeltaStepping *newDeltaStepping(unsigned threads);
+
+/** @brief Zatrzymuje wątki i zwalnia pulę.
+ * @param[in,out] ds        - pula do zwolnienia
+ */
+void deleteDeltaStepping(DeltaStepping *ds);
+
+/** @brief Wyznacza etykiety wierzchołków nie dalszych od B niż A.
+ * Wierzchołki są przetwarzane kubełkami odległości o szerokości równej
+ * średniej długości odcinka drogowego; etykiety wierzchołków jednego kubełka
+ * są poprawiane równolegle aż do ustalenia się. Etykiety, przodkowie i
+ * wykluczenia są takie same jak w @ref shortestPaths: przez wierzchołki
+ * wykluczone w obszarze roboczym (poza B) ani przez B nie wolno przechodzić,
+ * a przy równych długościach i latach wybierany jest poprzednik o mniejszym
+ * numerze.
+ * @param[in,out] ds        - pula wątków
+ * @param[in] map           - mapa dróg (nie może być zmieniana w trakcie)
+ * @param[in] ws            - obszar roboczy ze zbiorem wykluczonych
+ * wierzchołków
+ * @param[in] A             - wierzchołek początkowy
+ * @param[in] B             - wierzchołek końcowy
+ * @param[in] fixing        - czy bezpośrednia droga z A do B jest zabroniona
+ * @param[out] labels       - tutaj zapisywany jest wskaźnik na etykiety
+ * wierzchołków przetworzonych przez wyszukiwanie, uporządkowane według
+ * długości ścieżek (ważny do kolejnego wyszukiwania)
+ * @param[out] count        - tutaj zapisywana jest liczba etykiet
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status deltaStepping(DeltaStepping *ds, Map *map, const SearchWorkspace *ws,
+                     int A, int B, bool fixing, const DeltaLabel **labels,
+                     size_t *count);
+
+#endif /* __DELTA_STEPPING_H__ */
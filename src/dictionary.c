@@ -1,28 +1,60 @@
 #include "dictionary.h"
+#include "hash_group.h"
 #include <stdlib.h>
 
-#define LOAD_FACTOR 0.9
-#define DICTIONARY_INITIAL_SIZE 4
-#define INDEX(key) dictionary->hash((key)) & (dictionary->array_size - 1)
-#define NEXT_INDEX(index)                                                      \
-    {                                                                          \
-        if (++(index) == dictionary->array_size) {                             \
-            (index) = 0;                                                       \
-        }                                                                      \
-    }
+/** @brief Skraca klucz elementu zapisanego w komórce słownika.
+ * @param[in] dictionary       - słownik
+ * @param[in] slot             - zajęta komórka
+ * @return Skrót klucza.
+ */
+static inline hash_t hashEntry(const void *dictionary, const void *slot) {
+    const Dictionary *d = dictionary;
+    return d->hash(((const Entry *)slot)->key);
+}
+
+/** @brief Porównuje klucz elementu zapisanego w komórce słownika z kluczem.
+ * @param[in] dictionary       - słownik
+ * @param[in] slot             - zajęta komórka
+ * @param[in] key              - wskaźnik na szukany klucz
+ * @return Wartość @p true, jeśli klucze są równe, @p false wpp.
+ */
+static inline bool matchEntry(const void *dictionary, const void *slot,
+                              const void *key) {
+    const Dictionary *d = dictionary;
+    return d->equal(((const Entry *)slot)->key, *(void *const *)key);
+}
+
+/** @brief Znajduje komórkę z kluczem @p key.
+ * @param[in] dictionary       - słownik
+ * @param[in] key              - szukany klucz
+ * @return Indeks komórki lub SIZE_MAX, jeśli klucza nie ma w słowniku.
+ */
+static size_t findSlot(const Dictionary *dictionary, void *key) {
+    return findInHashTable(&dictionary->table, sizeof(Entry),
+                           dictionary->hash(key), matchEntry, dictionary,
+                           &key);
+}
+
+/** @brief Zwraca komórkę słownika.
+ * @param[in] dictionary       - słownik
+ * @param[in] index            - indeks komórki
+ * @return Wskaźnik na komórkę.
+ */
+static inline Entry *entryAt(const Dictionary *dictionary, size_t index) {
+    return (Entry *)dictionary->table.slots + index;
+}
 
 void deleteDictionary(Dictionary *dictionary) {
     if (dictionary == NULL) {
         return;
     }
-    for (size_t i = 0; i < dictionary->array_size; ++i) {
-        dictionary->free_key(dictionary->array[i].key);
-        dictionary->free_val(dictionary->array[i].val);
+    for (size_t i = 0; i < dictionary->table.array_size; ++i) {
+        if (IS_FULL_CTRL(dictionary->table.ctrl[i])) {
+            dictionary->free_key(entryAt(dictionary, i)->key);
+            dictionary->free_val(entryAt(dictionary, i)->val);
+        }
     }
-    free(dictionary->array);
-    dictionary->size = 0;
-    dictionary->array_size = 0;
-    dictionary->array = NULL;
+    freeHashTable(&dictionary->table);
 }
 
 Dictionary *newDictionary(hash_t (*hash)(void *), bool (*equal)(void *, void *),
@@ -33,66 +65,34 @@ Dictionary *newDictionary(hash_t (*hash)(void *), bool (*equal)(void *, void *),
     }
     dictionary->hash = hash;
     dictionary->equal = equal;
-    dictionary->size = 0;
-    dictionary->array_size = DICTIONARY_INITIAL_SIZE;
-    dictionary->array = calloc(DICTIONARY_INITIAL_SIZE, sizeof(Entry));
     dictionary->free_key = free_key;
     dictionary->free_val = free_val;
-    if (dictionary->array == NULL) {
+    if (!allocateHashTable(&dictionary->table, sizeof(Entry),
+                           HASH_TABLE_INITIAL_SIZE)) {
         free(dictionary);
         return NULL;
     }
     return dictionary;
 }
 
-static Status rehashDictionary(Dictionary *dictionary, size_t new_size) {
-    CHECK_RET(dictionary);
-    Entry *p = calloc(new_size, sizeof(Entry));
-    if (p == NULL) {
-        return false;
-    }
-    Dictionary copy = *dictionary;
-    dictionary->size = 0;
-    dictionary->array_size = new_size;
-    dictionary->array = p;
-
-    for (size_t i = 0; i < copy.array_size; ++i) {
-        Entry e = copy.array[i];
-        if (NOT_FOUND(e) == false) {
-            if (insertDictionary(dictionary, e.key, e.val) == false) {
-                deleteDictionary(dictionary);
-                *dictionary = copy;
-                return false;
-            }
-        }
-    }
-
-    free(copy.array);
-    return true;
-}
-
 Status insertDictionary(Dictionary *dictionary, void *key, void *val) {
     CHECK_RET(dictionary);
     CHECK_RET(key);
     CHECK_RET(val);
-    if (dictionary->size > dictionary->array_size * LOAD_FACTOR ||
-        dictionary->size + 1 >= dictionary->array_size) {
-        CHECK_RET(rehashDictionary(dictionary, 2 * dictionary->array_size));
-    }
-    hash_t index = INDEX(key);
-    while (dictionary->array[index].key != NULL &&
-           dictionary->array[index].key != DELETED) {
-        if (dictionary->equal(dictionary->array[index].key, key)) {
-            dictionary->free_key(dictionary->array[index].key);
-            dictionary->free_val(dictionary->array[index].val);
-            dictionary->size--;
-            break;
-        }
-        NEXT_INDEX(index);
+    hash_t hash = dictionary->hash(key);
+    size_t index = findInHashTable(&dictionary->table, sizeof(Entry), hash,
+                                   matchEntry, dictionary, &key);
+    if (index != SIZE_MAX) {
+        Entry *e = entryAt(dictionary, index);
+        dictionary->free_key(e->key);
+        dictionary->free_val(e->val);
+        *e = (const Entry){key, val};
+        return true;
     }
-    dictionary->array[index].key = key;
-    dictionary->array[index].val = val;
-    dictionary->size++;
+    Entry *e = claimHashTableSlot(&dictionary->table, sizeof(Entry), hash,
+                                  hashEntry, dictionary);
+    CHECK_RET(e);
+    *e = (const Entry){key, val};
     return true;
 }
 
@@ -100,32 +100,29 @@ Entry getDictionary(Dictionary *dictionary, void *key) {
     if (dictionary == NULL || key == NULL) {
         return (const Entry){NULL, NULL};
     }
-    hash_t index = INDEX(key);
-    size_t n = 0;
-    while (dictionary->array[index].key != NULL && n < dictionary->array_size) {
-        n++;
-        if (dictionary->equal(dictionary->array[index].key, key)) {
-            return dictionary->array[index];
-        }
-        NEXT_INDEX(index);
+    size_t index = findSlot(dictionary, key);
+    if (index == SIZE_MAX) {
+        return (const Entry){NULL, NULL};
     }
-    return (const Entry){NULL, NULL};
+    return *entryAt(dictionary, index);
 }
 
 void deleteFromDictionary(Dictionary *dictionary, void *key) {
     if (dictionary == NULL || key == NULL) {
         return;
     }
-    hash_t index = INDEX(key);
-    while (dictionary->array[index].key != NULL) {
-        if (dictionary->equal(dictionary->array[index].key, key)) {
-            dictionary->free_key(dictionary->array[index].key);
-            dictionary->free_val(dictionary->array[index].val);
-            dictionary->array[index].key = DELETED;
-            dictionary->array[index].val = NULL;
-            dictionary->size--;
-            return;
-        }
-        NEXT_INDEX(index);
+    size_t index = findSlot(dictionary, key);
+    if (index == SIZE_MAX) {
+        return;
     }
+    Entry *e = entryAt(dictionary, index);
+    dictionary->free_key(e->key);
+    dictionary->free_val(e->val);
+    releaseHashTableSlot(&dictionary->table, sizeof(Entry), index, hashEntry,
+                         dictionary);
+}
+
+size_t longestProbeDictionary(const Dictionary *dictionary) {
+    return longestProbeHashTable(&dictionary->table, sizeof(Entry), hashEntry,
+                                 dictionary);
 }
@@ -7,6 +7,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "hash_group.h"
 #include "status.h"
 
 /// Tak oznaczane są wierzchołki, które usuwamy ze słownika.
@@ -16,11 +17,6 @@
 /// znalezione w słowniku).
 #define NOT_FOUND(e) ((e).key == NULL || (e).key == DELETED)
 
-/**
- * @brief Taki typ zwraca każda funkcja skrótu używana w słowniku.
- */
-typedef uint64_t hash_t;
-
 /**
  * Struktura reprezentująca element słownika.
  */
@@ -33,6 +29,13 @@ typedef struct Entry {
 
 /**
  * Struktura reprezentująca słownik.
+ * Tablica z adresowaniem otwartym (@ref HashTable) o komórkach typu
+ * @ref Entry, w której każdej komórce odpowiada bajt kontrolny: pusta,
+ * usunięta lub zajęta wraz z 7 bitami skrótu klucza. Szukanie porównuje
+ * naraz grupę 16 bajtów kontrolnych (instrukcjami SSE2, jeśli są dostępne),
+ * a funkcję @p equal wywołuje tylko dla komórek o zgodnym fragmencie skrótu.
+ * Początek szukania wyznaczają pozostałe bity skrótu, więc powinny one być
+ * dobrze wymieszane.
  */
 typedef struct Dictionary {
     /// funkcja skrótu używana w słowniku
@@ -40,11 +43,7 @@ typedef struct Dictionary {
     /// funkcja porównująca klucze na równość
     bool (*equal)(void *, void *);
     /// tablica przechowująca pary klucz-wartość
-    Entry *array;
-    /// rozmiar tablicy
-    size_t array_size;
-    /// liczba elementów w słowniku
-    size_t size;
+    HashTable table;
     /// funkcja zwalniająca pamięć po kluczach
     void (*free_key)(void *);
     /// funkcja zwalniająca pamięć po wartościach
@@ -98,10 +97,20 @@ Entry getDictionary(Dictionary *dictionary, void *key);
 /** @brief Usuwa element ze słownika.
  * Usuwa element ze słownika o kluczu @p key. Jeśli takiego klucza nie ma,
  * nic nie robi. Zwalnia pamięć przydzieloną na klucz i wartość za pomocą
- * funkcji @p free_key i @p free_val.
+ * funkcji @p free_key i @p free_val. Komórka jest oznaczana jako usunięta
+ * tylko wtedy, gdy mogło przez nią przechodzić szukanie innego klucza, a
+ * tablica jest zmniejszana, gdy elementy zajmują mniej niż 1/8 jej rozmiaru.
  * @param[in,out] dictionary   - słownik, z którego usuwa
  * @param[in] key              - klucz, który chcemy usunąć ze słownika.
  */
 void deleteFromDictionary(Dictionary *dictionary, void *key);
 
+/** @brief Wyznacza najdłuższą ścieżkę szukania elementu słownika.
+ * Służy do badania rozkładu elementów w tablicy.
+ * @param[in] dictionary       - słownik
+ * @return Liczba grup bajtów kontrolnych przeglądanych przy szukaniu
+ * najtrudniej dostępnego elementu lub 0, jeśli słownik jest pusty.
+ */
+size_t longestProbeDictionary(const Dictionary *dictionary);
+
 #endif /* __DICTIONARY_H__ */
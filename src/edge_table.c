@@ -0,0 +1,219 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "edge_table.h"
+
+/** @brief Zwraca tablicę odcinków wychodzących z miasta.
+ * @param[in] c             - odcinki miasta
+ * @return Wskaźnik na pierwszy z @p c->degree odcinków.
+ */
+static EdgeRef *cityRefs(CityEdges *c) {
+    return c->capacity == 0 ? c->local : c->spilled;
+}
+
+Status initEdgeTable(EdgeTable *table) {
+    *table = (const EdgeTable){NULL, 0, 0, -1, 0, NULL, 0};
+    return true;
+}
+
+void deleteEdgeTable(EdgeTable *table) {
+    for (size_t i = 0; i < table->size; ++i) {
+        deleteList(&table->edges[i].routes);
+    }
+    free(table->edges);
+    table->edges = NULL;
+    table->size = table->capacity = table->count = 0;
+    for (size_t v = 0; v < table->cities_capacity; ++v) {
+        if (table->cities[v].capacity != 0) {
+            free(table->cities[v].spilled);
+        }
+    }
+    free(table->cities);
+    table->cities = NULL;
+    table->cities_capacity = 0;
+}
+
+/** @brief Znajduje odcinek wychodzący z miasta @p a do miasta @p b.
+ * @param[in] table         - tablica odcinków
+ * @param[in] a             - pierwsze miasto
+ * @param[in] b             - drugie miasto
+ * @return Pozycja odcinka na liście miasta @p a lub -1.
+ */
+static int findRef(EdgeTable *table, int a, int b) {
+    CityEdges *c = &table->cities[a];
+    EdgeRef *refs = cityRefs(c);
+    for (unsigned i = 0; i < c->degree; ++i) {
+        if (refs[i].city == b) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+Edge *getEdge(EdgeTable *table, int a, int b) {
+    if ((size_t)a >= table->cities_capacity ||
+        (size_t)b >= table->cities_capacity) {
+        return NULL;
+    }
+    if (table->cities[a].degree > table->cities[b].degree) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    int i = findRef(table, a, b);
+    if (i == -1) {
+        return NULL;
+    }
+    return &table->edges[cityRefs(&table->cities[a])[i].edge];
+}
+
+/** @brief Zapewnia miejsce na odcinki miast o indeksach mniejszych niż
+ * @p cities_no.
+ * @param[in,out] table     - tablica odcinków
+ * @param[in] cities_no     - liczba miast
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status reserveCities(EdgeTable *table, size_t cities_no) {
+    if (cities_no <= table->cities_capacity) {
+        return true;
+    }
+    size_t capacity = 2 * table->cities_capacity;
+    if (capacity < cities_no) {
+        capacity = cities_no;
+    }
+    CityEdges *cities = realloc(table->cities, capacity * sizeof(CityEdges));
+    CHECK_RET(cities);
+    memset(cities + table->cities_capacity, 0,
+           (capacity - table->cities_capacity) * sizeof(CityEdges));
+    table->cities = cities;
+    table->cities_capacity = capacity;
+    return true;
+}
+
+/** @brief Zapewnia miejsce na jeszcze jeden odcinek miasta.
+ * Odcinki, które przestają mieścić się w rekordzie miasta, są przenoszone do
+ * osobnej tablicy.
+ * @param[in,out] c         - odcinki miasta
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status reserveRef(CityEdges *c) {
+    unsigned capacity = c->capacity == 0 ? INLINE_EDGES : c->capacity;
+    if (c->degree < capacity) {
+        return true;
+    }
+    EdgeRef *spilled;
+    if (c->capacity == 0) {
+        spilled = malloc(2 * capacity * sizeof(EdgeRef));
+        CHECK_RET(spilled);
+        memcpy(spilled, c->local, c->degree * sizeof(EdgeRef));
+    } else {
+        spilled = realloc(c->spilled, 2 * capacity * sizeof(EdgeRef));
+        CHECK_RET(spilled);
+    }
+    c->spilled = spilled;
+    c->capacity = 2 * capacity;
+    return true;
+}
+
+Status insertEdge(EdgeTable *table, int a, int b, uint64_t length,
+                  int builtYear) {
+    CHECK_RET(reserveCities(table, (size_t)(a < b ? b : a) + 1));
+    CHECK_RET(reserveRef(&table->cities[a]));
+    CHECK_RET(reserveRef(&table->cities[b]));
+    size_t id;
+    if (table->free_edge != -1) {
+        id = table->free_edge;
+    } else {
+        if (table->size == table->capacity) {
+            size_t capacity = 2 * table->capacity + 4;
+            Edge *edges = realloc(table->edges, capacity * sizeof(Edge));
+            CHECK_RET(edges);
+            table->edges = edges;
+            table->capacity = capacity;
+        }
+        id = table->size;
+    }
+    Edge *e = &table->edges[id];
+    if (id == table->size) {
+        table->size++;
+    } else {
+        table->free_edge = e->city2;
+    }
+    *e = (const Edge){length, builtYear, a < b ? a : b, a < b ? b : a,
+                      {NULL, NULL}};
+    CityEdges *ca = &table->cities[a];
+    CityEdges *cb = &table->cities[b];
+    cityRefs(ca)[ca->degree++] = (EdgeRef){b, (int)id};
+    cityRefs(cb)[cb->degree++] = (EdgeRef){a, (int)id};
+    table->count++;
+    return true;
+}
+
+/** @brief Usuwa z listy miasta @p a odcinek prowadzący do miasta @p b.
+ * @param[in,out] table     - tablica odcinków
+ * @param[in] a             - pierwsze miasto
+ * @param[in] b             - drugie miasto
+ */
+static void removeRef(EdgeTable *table, int a, int b) {
+    CityEdges *c = &table->cities[a];
+    int i = findRef(table, a, b);
+    c->degree--;
+    cityRefs(c)[i] = cityRefs(c)[c->degree];
+}
+
+void removeEdge(EdgeTable *table, int a, int b) {
+    Edge *e = getEdge(table, a, b);
+    if (e == NULL) {
+        return;
+    }
+    removeRef(table, a, b);
+    removeRef(table, b, a);
+    deleteList(&e->routes);
+    e->builtYear = 0;
+    e->city2 = table->free_edge;
+    table->free_edge = (int)(e - table->edges);
+    table->count--;
+}
+
+Status renumberEdgeTable(EdgeTable *table, const int *perm, size_t cities_no) {
+    size_t capacity = table->cities_capacity;
+    if (capacity < cities_no) {
+        capacity = cities_no;
+    }
+    CityEdges *cities = calloc(capacity, sizeof(CityEdges));
+    CHECK_RET(cities);
+    for (size_t v = 0; v < table->cities_capacity; ++v) {
+        CityEdges *c = &table->cities[v];
+        if (c->degree == 0 && c->capacity == 0) {
+            continue;
+        }
+        EdgeRef *refs = cityRefs(c);
+        for (unsigned i = 0; i < c->degree; ++i) {
+            refs[i].city = perm[refs[i].city];
+        }
+        cities[perm[v]] = *c;
+    }
+    for (size_t i = 0; i < table->size; ++i) {
+        Edge *e = &table->edges[i];
+        if (e->builtYear != 0) {
+            int a = perm[e->city1];
+            int b = perm[e->city2];
+            e->city1 = a < b ? a : b;
+            e->city2 = a < b ? b : a;
+        }
+    }
+    free(table->cities);
+    table->cities = cities;
+    table->cities_capacity = capacity;
+    return true;
+}
+
+List *edgeRoutes(Edge *e) {
+    if (e->routes.begin == NULL) {
+        List *l = newList();
+        CHECK_RET(l);
+        e->routes = *l;
+        free(l);
+    }
+    return &e->routes;
+}
@@ -0,0 +1,140 @@
+/** @file
+ * Tablica odcinków drogowych mapy: jeden rekord na odcinek, wyszukiwany po
+ * parze miast.
+ */
+#ifndef __EDGE_TABLE_H__
+#define __EDGE_TABLE_H__
+
+#include "list.h"
+#include "status.h"
+
+/// Liczba odcinków miasta przechowywanych bez osobnej alokacji pamięci.
+#define INLINE_EDGES 4
+
+/**
+ * Rekord odcinka drogowego. Odcinek jest nieskierowany, więc miasta są
+ * zapisywane w kolejności rosnących indeksów.
+ */
+typedef struct Edge {
+    /// długość odcinka
+    uint64_t length;
+    /// rok budowy lub ostatniej naprawy; 0 oznacza wolny rekord
+    int builtYear;
+    /// miasto o mniejszym indeksie
+    int city1;
+    /// miasto o większym indeksie (w wolnym rekordzie - następny wolny
+    /// rekord lub -1)
+    int city2;
+    /// drogi krajowe przebiegające przez odcinek; lista jest tworzona przy
+    /// pierwszym użyciu (zob. @ref edgeRoutes)
+    List routes;
+} Edge;
+
+/**
+ * Odcinek wychodzący z miasta.
+ */
+typedef struct EdgeRef {
+    /// sąsiednie miasto
+    int city;
+    /// numer rekordu odcinka
+    int edge;
+} EdgeRef;
+
+/**
+ * Odcinki wychodzące z miasta. Większość miast ma kilku sąsiadów, więc
+ * odcinki są przechowywane w samym rekordzie miasta, a do osobnej tablicy
+ * trafiają dopiero wtedy, gdy się w nim nie mieszczą.
+ */
+typedef struct CityEdges {
+    /// liczba odcinków
+    unsigned degree;
+    /// pojemność tablicy @p spilled lub 0, jeśli odcinki są w @p local
+    unsigned capacity;
+    union {
+        /// odcinki miasta o co najwyżej @ref INLINE_EDGES sąsiadach
+        EdgeRef local[INLINE_EDGES];
+        /// odcinki miasta o większej liczbie sąsiadów
+        EdgeRef *spilled;
+    };
+} CityEdges;
+
+/**
+ * Tablica odcinków drogowych wraz z listami odcinków kolejnych miast.
+ */
+typedef struct EdgeTable {
+    /// rekordy odcinków, w tym wolne
+    Edge *edges;
+    /// liczba używanych kiedykolwiek rekordów
+    size_t size;
+    /// liczba rekordów, dla których zaalokowano pamięć
+    size_t capacity;
+    /// pierwszy wolny rekord lub -1
+    int free_edge;
+    /// liczba odcinków
+    size_t count;
+    /// odcinki wychodzące z kolejnych miast
+    CityEdges *cities;
+    /// liczba miast, dla których zaalokowano @p cities
+    size_t cities_capacity;
+} EdgeTable;
+
+/** @brief Inicjalizuje pustą tablicę odcinków.
+ * @param[out] table        - tablica do zainicjalizowania
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status initEdgeTable(EdgeTable *table);
+
+/** @brief Zwalnia pamięć zajmowaną przez tablicę odcinków i listy dróg
+ * krajowych.
+ * @param[in,out] table     - tablica odcinków
+ */
+void deleteEdgeTable(EdgeTable *table);
+
+/** @brief Znajduje odcinek łączący miasta.
+ * Przegląda odcinki tego z miast, które ma mniej sąsiadów.
+ * Wskaźnik traci ważność przy dodaniu kolejnego odcinka.
+ * @param[in] table         - tablica odcinków
+ * @param[in] a             - pierwsze miasto
+ * @param[in] b             - drugie miasto
+ * @return Wskaźnik na odcinek lub NULL, jeśli miasta nie są połączone
+ * bezpośrednio.
+ */
+Edge *getEdge(EdgeTable *table, int a, int b);
+
+/** @brief Dodaje odcinek łączący nie połączone dotąd miasta.
+ * Jeśli nie uda się zaalokować pamięci, tablica pozostaje bez zmian.
+ * @param[in,out] table     - tablica odcinków
+ * @param[in] a             - pierwsze miasto
+ * @param[in] b             - drugie miasto
+ * @param[in] length        - długość odcinka
+ * @param[in] builtYear     - rok budowy odcinka
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status insertEdge(EdgeTable *table, int a, int b, uint64_t length,
+                  int builtYear);
+
+/** @brief Usuwa odcinek i listę dróg krajowych, które przez niego
+ * przebiegały.
+ * @param[in,out] table     - tablica odcinków
+ * @param[in] a             - pierwsze miasto
+ * @param[in] b             - drugie miasto
+ */
+void removeEdge(EdgeTable *table, int a, int b);
+
+/** @brief Zmienia numerację miast w tablicy odcinków.
+ * Jeśli nie uda się zaalokować pamięci, tablica pozostaje bez zmian.
+ * @param[in,out] table     - tablica odcinków
+ * @param[in] perm          - nowe numery miast, indeksowane starymi
+ * @param[in] cities_no     - liczba miast
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status renumberEdgeTable(EdgeTable *table, const int *perm, size_t cities_no);
+
+/** @brief Zwraca listę dróg krajowych przebiegających przez odcinek,
+ * tworząc ją w razie potrzeby.
+ * @param[in,out] e         - odcinek
+ * @return Wskaźnik na listę lub NULL, gdy nie udało się zaalokować pamięci.
+ */
+List *edgeRoutes(Edge *e);
+
+#endif /* __EDGE_TABLE_H__ */
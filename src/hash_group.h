@@ -0,0 +1,420 @@
+/** @file
+ * Tablice z adresowaniem otwartym, przeglądane grupami bajtów kontrolnych.
+ * Bajty kontrolne i operacje na tablicy (@ref HashTable) są wspólne dla
+ * słownika (@ref Dictionary) i tablic generowanych przez
+ * @ref HASH_MAP_DEFINE, które dostarczają jedynie rozmiar komórki oraz
+ * funkcje skrótu i porównania kluczy.
+ */
+#ifndef __HASH_GROUP_H__
+#define __HASH_GROUP_H__
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "status.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/// Liczba bajtów kontrolnych sprawdzanych jednocześnie.
+#define GROUP_WIDTH 16
+/// Najmniejszy rozmiar tablicy.
+#define HASH_TABLE_INITIAL_SIZE GROUP_WIDTH
+/// Maksymalna liczba zajętych (również przez usunięte elementy) komórek
+/// tablicy o rozmiarze @p size - 7/8 rozmiaru.
+#define MAX_LOAD(size) ((size) - (size) / 8)
+/// Tablica jest zmniejszana, gdy elementy zajmują mniej niż taką jej część.
+#define SHRINK_RATIO 8
+/// Bajt kontrolny pustej komórki.
+#define CTRL_EMPTY 0x80
+/// Bajt kontrolny komórki, z której usunięto element.
+#define CTRL_DELETED 0xfe
+/// Część skrótu wyznaczająca początek szukania.
+#define H1(hash) ((hash) >> 7)
+/// Część skrótu zapisywana w bajcie kontrolnym zajętej komórki.
+#define H2(hash) ((uint8_t)((hash)&0x7f))
+/// Czy bajt kontrolny oznacza zajętą komórkę.
+#define IS_FULL_CTRL(ctrl) (((ctrl)&0x80) == 0)
+
+/**
+ * @brief Taki typ zwraca każda funkcja skrótu używana w słowniku i w tablicach
+ * generowanych przez @ref HASH_MAP_DEFINE.
+ */
+typedef uint64_t hash_t;
+
+/// Maska bitowa komórek grupy; bit i odpowiada i-tej komórce.
+typedef uint32_t GroupMask;
+
+/** @brief Wyznacza komórki grupy o podanym bajcie kontrolnym.
+ * @param[in] group         - pierwszy z @ref GROUP_WIDTH bajtów kontrolnych
+ * @param[in] byte          - szukany bajt
+ * @return Maska komórek, których bajt kontrolny jest równy @p byte.
+ */
+static inline GroupMask matchByte(const uint8_t *group, uint8_t byte) {
+#ifdef __SSE2__
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+    __m128i pattern = _mm_set1_epi8((char)byte);
+    return (GroupMask)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, pattern));
+#else
+    GroupMask mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; ++i) {
+        if (group[i] == byte) {
+            mask |= (GroupMask)1 << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+/** @brief Wyznacza wolne (puste lub usunięte) komórki grupy.
+ * @param[in] group         - pierwszy z @ref GROUP_WIDTH bajtów kontrolnych
+ * @return Maska komórek, których bajt kontrolny ma ustawiony najstarszy bit.
+ */
+static inline GroupMask matchFree(const uint8_t *group) {
+#ifdef __SSE2__
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+    return (GroupMask)_mm_movemask_epi8(ctrl);
+#else
+    GroupMask mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; ++i) {
+        if (group[i] & 0x80) {
+            mask |= (GroupMask)1 << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+/** @brief Alokuje bajty kontrolne pustej tablicy.
+ * @param[in] size          - liczba komórek, potęga dwójki nie mniejsza niż
+ * @ref GROUP_WIDTH
+ * @return Wskaźnik na bajty kontrolne lub NULL, gdy nie udało się zaalokować
+ * pamięci.
+ */
+static inline uint8_t *newCtrlBytes(size_t size) {
+    uint8_t *ctrl = malloc(size + GROUP_WIDTH);
+    if (ctrl != NULL) {
+        memset(ctrl, CTRL_EMPTY, size + GROUP_WIDTH);
+    }
+    return ctrl;
+}
+
+/** @brief Ustawia bajt kontrolny komórki.
+ * Pierwsze @ref GROUP_WIDTH bajtów jest powtórzonych za końcem tablicy, by
+ * grupy zaczynające się blisko końca można było wczytać w całości.
+ * @param[in,out] ctrl      - bajty kontrolne
+ * @param[in] size          - liczba komórek
+ * @param[in] index         - indeks komórki
+ * @param[in] byte          - nowy bajt kontrolny
+ */
+static inline void setCtrl(uint8_t *ctrl, size_t size, size_t index,
+                           uint8_t byte) {
+    ctrl[index] = byte;
+    if (index < GROUP_WIDTH) {
+        ctrl[size + index] = byte;
+    }
+}
+
+/** @brief Znajduje pierwszą wolną komórkę na ścieżce szukania klucza.
+ * @param[in] ctrl          - bajty kontrolne tablicy z co najmniej jedną
+ * pustą komórką
+ * @param[in] size          - liczba komórek
+ * @param[in] hash          - skrót klucza
+ * @return Indeks komórki.
+ */
+static inline size_t findFreeSlot(const uint8_t *ctrl, size_t size,
+                                  hash_t hash) {
+    size_t mask = size - 1;
+    size_t pos = H1(hash) & mask;
+    for (size_t stride = GROUP_WIDTH;; stride += GROUP_WIDTH) {
+        GroupMask m = matchFree(ctrl + pos);
+        if (m != 0) {
+            return (pos + __builtin_ctz(m)) & mask;
+        }
+        pos = (pos + stride) & mask;
+    }
+}
+
+/** @brief Wyznacza liczbę grup przeglądanych przy szukaniu elementu.
+ * Służy do badania rozkładu elementów w tablicy.
+ * @param[in] size          - liczba komórek
+ * @param[in] hash          - skrót klucza elementu
+ * @param[in] index         - indeks komórki zajmowanej przez element
+ * @return Liczba grup na ścieżce szukania klucza, do grupy zawierającej
+ * komórkę @p index włącznie.
+ */
+static inline size_t probeLength(size_t size, hash_t hash, size_t index) {
+    size_t mask = size - 1;
+    size_t pos = H1(hash) & mask;
+    size_t groups = 1;
+    for (size_t stride = GROUP_WIDTH; ((index - pos) & mask) >= GROUP_WIDTH;
+         stride += GROUP_WIDTH) {
+        pos = (pos + stride) & mask;
+        groups++;
+    }
+    return groups;
+}
+
+/** @brief Stwierdza, czy zwalnianą komórkę można oznaczyć jako pustą.
+ * Każde okno @ref GROUP_WIDTH komórek zawierające zwalnianą komórkę ma pustą
+ * komórkę, jeśli ciągi zajętych komórek na prawo (łącznie ze zwalnianą) i na
+ * lewo są razem krótsze niż grupa. Żadne szukanie nie przeszło więc przez tę
+ * komórkę do dalszej grupy.
+ * @param[in] ctrl          - bajty kontrolne
+ * @param[in] size          - liczba komórek
+ * @param[in] index         - indeks zwalnianej komórki
+ * @return Wartość @p true, jeśli komórka może zostać pusta, lub @p false,
+ * jeśli trzeba ją oznaczyć jako usuniętą.
+ */
+static inline bool canEmptySlot(const uint8_t *ctrl, size_t size,
+                                size_t index) {
+    GroupMask after = matchByte(ctrl + index, CTRL_EMPTY);
+    GroupMask before =
+        matchByte(ctrl + ((index - GROUP_WIDTH) & (size - 1)), CTRL_EMPTY);
+    return after != 0 && before != 0 &&
+           __builtin_ctz(after) + __builtin_clz(before) - (32 - GROUP_WIDTH) <
+               GROUP_WIDTH;
+}
+
+/** @brief Wyznacza rozmiar tablicy przed wstawieniem elementu.
+ * Jeśli miejsce zajmują głównie usunięte elementy, wystarczy je pominąć, nie
+ * zwiększając tablicy.
+ * @param[in] size          - liczba komórek
+ * @param[in] used          - liczba elementów
+ * @param[in] deleted       - liczba komórek, z których usunięto elementy
+ * @return Nowa liczba komórek lub 0, jeśli tablicy nie trzeba przebudowywać.
+ */
+static inline size_t grownSize(size_t size, size_t used, size_t deleted) {
+    if (used + deleted + 1 <= MAX_LOAD(size)) {
+        return 0;
+    }
+    return 2 * used < size / 2 ? size : 2 * size;
+}
+
+/** @brief Wyznacza rozmiar tablicy po usunięciu elementu.
+ * @param[in] size          - liczba komórek
+ * @param[in] used          - liczba elementów
+ * @return Nowa liczba komórek lub 0, jeśli tablicy nie trzeba zmniejszać.
+ */
+static inline size_t shrunkSize(size_t size, size_t used) {
+    size_t new_size = size;
+    while (new_size / 2 >= HASH_TABLE_INITIAL_SIZE &&
+           used < new_size / SHRINK_RATIO) {
+        new_size /= 2;
+    }
+    return new_size < size ? new_size : 0;
+}
+
+/**
+ * Wspólna część tablic przeglądanych grupami bajtów kontrolnych: komórki
+ * dowolnego, stałego rozmiaru i bajty kontrolne. Zajęte są te komórki, których
+ * bajt kontrolny spełnia @ref IS_FULL_CTRL; zawartość pozostałych jest
+ * nieokreślona.
+ */
+typedef struct HashTable {
+    /// tablica komórek
+    void *slots;
+    /// bajty kontrolne komórek; pierwsze @ref GROUP_WIDTH jest powtórzonych
+    /// za końcem
+    uint8_t *ctrl;
+    /// rozmiar tablicy (potęga dwójki)
+    size_t array_size;
+    /// liczba elementów w tablicy
+    size_t size;
+    /// liczba komórek, z których usunięto elementy
+    size_t deleted;
+} HashTable;
+
+/// Wyznacza skrót klucza zapisanego w komórce @p slot tablicy, której
+/// właścicielem jest @p owner.
+typedef hash_t (*SlotHash)(const void *owner, const void *slot);
+
+/// Stwierdza, czy w komórce @p slot tablicy, której właścicielem jest
+/// @p owner, zapisano klucz wskazywany przez @p key.
+typedef bool (*SlotMatch)(const void *owner, const void *slot, const void *key);
+
+/** @brief Wyznacza adres komórki tablicy.
+ * @param[in] table         - tablica
+ * @param[in] slot_size     - rozmiar komórki
+ * @param[in] index         - indeks komórki
+ * @return Wskaźnik na komórkę.
+ */
+static inline void *hashTableSlot(const HashTable *table, size_t slot_size,
+                                  size_t index) {
+    return (char *)table->slots + index * slot_size;
+}
+
+/** @brief Alokuje pustą tablicę o @p size komórkach.
+ * Jeśli nie uda się zaalokować pamięci, @p table pozostaje bez zmian.
+ * @param[in,out] table     - tablica
+ * @param[in] slot_size     - rozmiar komórki
+ * @param[in] size          - liczba komórek, potęga dwójki nie mniejsza niż
+ * @ref GROUP_WIDTH
+ * @return Status powodzenia alokacji pamięci.
+ */
+static inline Status allocateHashTable(HashTable *table, size_t slot_size,
+                                       size_t size) {
+    void *slots = calloc(size, slot_size);
+    uint8_t *ctrl = newCtrlBytes(size);
+    if (slots == NULL || ctrl == NULL) {
+        free(slots);
+        free(ctrl);
+        return false;
+    }
+    *table = (const HashTable){slots, ctrl, size, 0, 0};
+    return true;
+}
+
+/** @brief Zwalnia pamięć zajmowaną przez tablicę.
+ * Nie zwalnia pamięci wskazywanej przez zawartość komórek.
+ * @param[in,out] table     - tablica
+ */
+static inline void freeHashTable(HashTable *table) {
+    free(table->slots);
+    free(table->ctrl);
+    *table = (const HashTable){NULL, NULL, 0, 0, 0};
+}
+
+/** @brief Znajduje komórkę z kluczem @p key.
+ * Wywołuje @p match tylko dla komórek, w których zapisano tę samą część
+ * skrótu.
+ * @param[in] table         - tablica
+ * @param[in] slot_size     - rozmiar komórki
+ * @param[in] hash          - skrót klucza
+ * @param[in] match         - funkcja porównująca klucz komórki z @p key
+ * @param[in] owner         - właściciel tablicy, przekazywany do @p match
+ * @param[in] key           - wskaźnik na szukany klucz
+ * @return Indeks komórki lub SIZE_MAX, jeśli klucza nie ma w tablicy.
+ */
+static inline size_t findInHashTable(const HashTable *table, size_t slot_size,
+                                     hash_t hash, SlotMatch match,
+                                     const void *owner, const void *key) {
+    size_t mask = table->array_size - 1;
+    size_t pos = H1(hash) & mask;
+    for (size_t stride = GROUP_WIDTH;; stride += GROUP_WIDTH) {
+        const uint8_t *group = table->ctrl + pos;
+        for (GroupMask m = matchByte(group, H2(hash)); m != 0; m &= m - 1) {
+            size_t index = (pos + __builtin_ctz(m)) & mask;
+            if (match(owner, hashTableSlot(table, slot_size, index), key)) {
+                return index;
+            }
+        }
+        if (matchByte(group, CTRL_EMPTY) != 0) {
+            return SIZE_MAX;
+        }
+        pos = (pos + stride) & mask;
+    }
+}
+
+/** @brief Przenosi elementy do nowych tablic, pomijając usunięte komórki.
+ * Jeśli nie uda się zaalokować pamięci, tablica pozostaje bez zmian.
+ * @param[in,out] table     - tablica
+ * @param[in] slot_size     - rozmiar komórki
+ * @param[in] new_size      - nowa liczba komórek
+ * @param[in] slot_hash     - funkcja skrótu klucza komórki
+ * @param[in] owner         - właściciel tablicy, przekazywany do @p slot_hash
+ * @return Status powodzenia alokacji pamięci.
+ */
+static inline Status rehashHashTable(HashTable *table, size_t slot_size,
+                                     size_t new_size, SlotHash slot_hash,
+                                     const void *owner) {
+    HashTable copy;
+    CHECK_RET(allocateHashTable(&copy, slot_size, new_size));
+    for (size_t i = 0; i < table->array_size; ++i) {
+        if (IS_FULL_CTRL(table->ctrl[i])) {
+            const void *slot = hashTableSlot(table, slot_size, i);
+            hash_t hash = slot_hash(owner, slot);
+            size_t index = findFreeSlot(copy.ctrl, new_size, hash);
+            setCtrl(copy.ctrl, new_size, index, H2(hash));
+            memcpy(hashTableSlot(&copy, slot_size, index), slot, slot_size);
+        }
+    }
+    copy.size = table->size;
+    freeHashTable(table);
+    *table = copy;
+    return true;
+}
+
+/** @brief Zajmuje komórkę dla nowego klucza, którego nie ma w tablicy.
+ * W razie potrzeby najpierw przebudowuje tablicę.
+ * @param[in,out] table     - tablica
+ * @param[in] slot_size     - rozmiar komórki
+ * @param[in] hash          - skrót nowego klucza
+ * @param[in] slot_hash     - funkcja skrótu klucza komórki
+ * @param[in] owner         - właściciel tablicy, przekazywany do @p slot_hash
+ * @return Wskaźnik na komórkę, do której trzeba zapisać element, lub NULL,
+ * gdy nie udało się zaalokować pamięci.
+ */
+static inline void *claimHashTableSlot(HashTable *table, size_t slot_size,
+                                       hash_t hash, SlotHash slot_hash,
+                                       const void *owner) {
+    size_t new_size =
+        grownSize(table->array_size, table->size, table->deleted);
+    if (new_size != 0 &&
+        !rehashHashTable(table, slot_size, new_size, slot_hash, owner)) {
+        return NULL;
+    }
+    size_t index = findFreeSlot(table->ctrl, table->array_size, hash);
+    if (table->ctrl[index] == CTRL_DELETED) {
+        table->deleted--;
+    }
+    setCtrl(table->ctrl, table->array_size, index, H2(hash));
+    table->size++;
+    return hashTableSlot(table, slot_size, index);
+}
+
+/** @brief Zwalnia komórkę zajmowaną przez element.
+ * Jeśli to możliwe, oznacza komórkę jako pustą, a nie usuniętą. Zmniejsza
+ * tablicę, gdy elementy zajmują jej niewielką część; jeśli nie uda się przy
+ * tym zaalokować pamięci, tablica pozostaje większa.
+ * @param[in,out] table     - tablica
+ * @param[in] slot_size     - rozmiar komórki
+ * @param[in] index         - indeks zwalnianej komórki
+ * @param[in] slot_hash     - funkcja skrótu klucza komórki
+ * @param[in] owner         - właściciel tablicy, przekazywany do @p slot_hash
+ */
+static inline void releaseHashTableSlot(HashTable *table, size_t slot_size,
+                                        size_t index, SlotHash slot_hash,
+                                        const void *owner) {
+    table->size--;
+    if (canEmptySlot(table->ctrl, table->array_size, index)) {
+        setCtrl(table->ctrl, table->array_size, index, CTRL_EMPTY);
+    } else {
+        setCtrl(table->ctrl, table->array_size, index, CTRL_DELETED);
+        table->deleted++;
+    }
+    size_t new_size = shrunkSize(table->array_size, table->size);
+    if (new_size != 0) {
+        rehashHashTable(table, slot_size, new_size, slot_hash, owner);
+    }
+}
+
+/** @brief Wyznacza najdłuższą ścieżkę szukania elementu tablicy.
+ * Służy do badania rozkładu elementów w tablicy.
+ * @param[in] table         - tablica
+ * @param[in] slot_size     - rozmiar komórki
+ * @param[in] slot_hash     - funkcja skrótu klucza komórki
+ * @param[in] owner         - właściciel tablicy, przekazywany do @p slot_hash
+ * @return Liczba grup przeglądanych przy szukaniu najtrudniej dostępnego
+ * elementu lub 0, jeśli tablica jest pusta.
+ */
+static inline size_t longestProbeHashTable(const HashTable *table,
+                                           size_t slot_size,
+                                           SlotHash slot_hash,
+                                           const void *owner) {
+    size_t longest = 0;
+    for (size_t i = 0; i < table->array_size; ++i) {
+        if (IS_FULL_CTRL(table->ctrl[i])) {
+            hash_t hash = slot_hash(owner, hashTableSlot(table, slot_size, i));
+            size_t groups = probeLength(table->array_size, hash, i);
+            if (groups > longest) {
+                longest = groups;
+            }
+        }
+    }
+    return longest;
+}
+
+#endif /* __HASH_GROUP_H__ */
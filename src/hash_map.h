@@ -0,0 +1,129 @@
+/** @file
+ * Makra generujące tablice haszujące o kluczach i wartościach ustalonego
+ * typu.
+ * W odróżnieniu od @ref Dictionary elementy są przechowywane bezpośrednio, a
+ * nie jako wskaźniki, a funkcje skrótu i porównania są znane w czasie
+ * kompilacji, więc kompilator może je rozwinąć w miejscu wywołania. Szukanie,
+ * przebudowa i usuwanie elementów korzystają z funkcji tablicy
+ * @ref HashTable wspólnych ze słownikiem. Tablica nie zarządza pamięcią
+ * wskazywaną przez klucze i wartości.
+ *
+ * Tablicę typu @p Name deklaruje się makrem @ref HASH_MAP_TYPE, a jej
+ * funkcje (init@p Name, delete@p Name, get@p Name, insert@p Name,
+ * deleteFrom@p Name i longestProbe@p Name) definiuje makrem
+ * @ref HASH_MAP_DEFINE; jeśli mają być widoczne w innych plikach, ich
+ * deklaracje generuje @ref HASH_MAP_PROTOTYPES.
+ */
+#ifndef __HASH_MAP_H__
+#define __HASH_MAP_H__
+
+#include "hash_group.h"
+
+/** @brief Definiuje strukturę tablicy haszującej.
+ * Komórki tablicy @p table są typu Name##Slot o polach @p key i @p val.
+ * @param Name              - nazwa typu tablicy
+ * @param Key               - typ kluczy
+ * @param Val               - typ wartości
+ */
+#define HASH_MAP_TYPE(Name, Key, Val)                                          \
+    typedef struct Name##Slot {                                                \
+        Key key;                                                               \
+        Val val;                                                               \
+    } Name##Slot;                                                              \
+                                                                               \
+    typedef struct Name {                                                      \
+        HashTable table;                                                       \
+    } Name;
+
+/** @brief Deklaruje funkcje tablicy haszującej zdefiniowane w innym pliku.
+ * @param Name              - nazwa typu tablicy
+ * @param Key               - typ kluczy
+ * @param Val               - typ wartości
+ */
+#define HASH_MAP_PROTOTYPES(Name, Key, Val)                                    \
+    Status init##Name(Name *map);                                              \
+    void delete##Name(Name *map);                                              \
+    Val *get##Name(const Name *map, Key key);                                  \
+    Status insert##Name(Name *map, Key key, Val val);                          \
+    void deleteFrom##Name(Name *map, Key key);                                 \
+    size_t longestProbe##Name(const Name *map);
+
+/** @brief Definiuje funkcje tablicy haszującej.
+ * - init@p Name tworzy pustą tablicę i zwraca status powodzenia alokacji
+ *   pamięci;
+ * - delete@p Name zwalnia pamięć zajmowaną przez tablicę;
+ * - get@p Name zwraca wskaźnik na wartość skojarzoną z kluczem lub NULL;
+ *   wskaźnik traci ważność przy kolejnej zmianie tablicy;
+ * - insert@p Name wstawia element lub zastępuje wartość istniejącego i zwraca
+ *   status powodzenia alokacji pamięci;
+ * - deleteFrom@p Name usuwa element, jeśli jest w tablicy;
+ * - longestProbe@p Name zwraca liczbę grup przeglądanych przy szukaniu
+ *   najtrudniej dostępnego elementu (lub 0 dla pustej tablicy).
+ * @param Name              - nazwa typu tablicy
+ * @param Key               - typ kluczy
+ * @param Val               - typ wartości
+ * @param hash              - funkcja skrótu klucza, zwracająca @ref hash_t
+ * @param equal             - funkcja porównująca dwa klucze na równość
+ * @param scope             - klasa funkcji, np. pusta lub static inline
+ */
+#define HASH_MAP_DEFINE(Name, Key, Val, hash, equal, scope)                    \
+    static inline hash_t hashSlot##Name(const void *owner, const void *slot) { \
+        (void)owner;                                                           \
+        return hash(((const Name##Slot *)slot)->key);                          \
+    }                                                                          \
+                                                                               \
+    static inline bool matchSlot##Name(const void *owner, const void *slot,    \
+                                       const void *key) {                      \
+        (void)owner;                                                           \
+        return equal(((const Name##Slot *)slot)->key, *(Key const *)key);      \
+    }                                                                          \
+                                                                               \
+    static inline size_t find##Name(const Name *map, Key key, hash_t h) {      \
+        return findInHashTable(&map->table, sizeof(Name##Slot), h,             \
+                               matchSlot##Name, NULL, &key);                   \
+    }                                                                          \
+                                                                               \
+    scope Status init##Name(Name *map) {                                       \
+        map->table = (const HashTable){NULL, NULL, 0, 0, 0};                   \
+        return allocateHashTable(&map->table, sizeof(Name##Slot),              \
+                                 HASH_TABLE_INITIAL_SIZE);                     \
+    }                                                                          \
+                                                                               \
+    scope void delete##Name(Name *map) { freeHashTable(&map->table); }         \
+                                                                               \
+    scope Val *get##Name(const Name *map, Key key) {                           \
+        size_t index = find##Name(map, key, hash(key));                        \
+        if (index == SIZE_MAX) {                                               \
+            return NULL;                                                       \
+        }                                                                      \
+        return &((Name##Slot *)map->table.slots)[index].val;                   \
+    }                                                                          \
+                                                                               \
+    scope Status insert##Name(Name *map, Key key, Val val) {                   \
+        hash_t h = hash(key);                                                  \
+        size_t index = find##Name(map, key, h);                                \
+        if (index != SIZE_MAX) {                                               \
+            ((Name##Slot *)map->table.slots)[index].val = val;                 \
+            return true;                                                       \
+        }                                                                      \
+        Name##Slot *slot = claimHashTableSlot(                                 \
+            &map->table, sizeof(Name##Slot), h, hashSlot##Name, NULL);         \
+        CHECK_RET(slot);                                                       \
+        *slot = (const Name##Slot){key, val};                                  \
+        return true;                                                           \
+    }                                                                          \
+                                                                               \
+    scope void deleteFrom##Name(Name *map, Key key) {                          \
+        size_t index = find##Name(map, key, hash(key));                        \
+        if (index != SIZE_MAX) {                                               \
+            releaseHashTableSlot(&map->table, sizeof(Name##Slot), index,       \
+                                 hashSlot##Name, NULL);                        \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    scope size_t longestProbe##Name(const Name *map) {                         \
+        return longestProbeHashTable(&map->table, sizeof(Name##Slot),          \
+                                     hashSlot##Name, NULL);                    \
+    }
+
+#endif /* __HASH_MAP_H__ */
@@ -0,0 +1,94 @@
+#include "heap.h"
+
+/** @brief Porównuje elementy kopca.
+ * @param[in] a         - pierwszy element
+ * @param[in] b         - drugi element
+ * @return @p true jeśli @p a powinien znaleźć się w kopcu przed @p b.
+ */
+static bool lessHeapEntry(HeapEntry a, HeapEntry b) {
+    if (a.key != b.key) {
+        return a.key < b.key;
+    }
+    if (a.dist != b.dist) {
+        return a.dist < b.dist;
+    }
+    return a.time > b.time;
+}
+
+Heap newHeap(size_t capacity) { return newDaryHeap(capacity, 1); }
+
+Heap newDaryHeap(size_t capacity, unsigned shift) {
+    Heap h = {0};
+    if (capacity == 0) {
+        capacity = 1;
+    }
+    h.array = malloc(capacity * sizeof(HeapEntry));
+    if (h.array == NULL) {
+        return h;
+    }
+    h.capacity = capacity;
+    h.shift = shift;
+    return h;
+}
+
+Status reserveHeap(Heap *h, size_t capacity) {
+    if (capacity <= h->capacity) {
+        return true;
+    }
+    if (capacity < 2 * h->capacity) {
+        capacity = 2 * h->capacity;
+    }
+    HeapEntry *n = realloc(h->array, capacity * sizeof(HeapEntry));
+    CHECK_RET(n);
+    h->array = n;
+    h->capacity = capacity;
+    return true;
+}
+
+void deleteHeap(Heap *h) {
+    free(h->array);
+    h->array = NULL;
+    h->size = h->capacity = 0;
+}
+
+Status pushHeap(Heap *h, HeapEntry e) {
+    if (h->size == h->capacity) {
+        HeapEntry *n = realloc(h->array, 2 * h->capacity * sizeof(HeapEntry));
+        CHECK_RET(n);
+        h->array = n;
+        h->capacity *= 2;
+    }
+    size_t i = h->size++;
+    while (i > 0 && lessHeapEntry(e, h->array[(i - 1) >> h->shift])) {
+        h->array[i] = h->array[(i - 1) >> h->shift];
+        i = (i - 1) >> h->shift;
+    }
+    h->array[i] = e;
+    return true;
+}
+
+HeapEntry topHeap(Heap *h) { return h->array[0]; }
+
+void popHeap(Heap *h) {
+    HeapEntry last = h->array[--h->size];
+    size_t arity = (size_t)1 << h->shift;
+    size_t i = 0;
+    while ((i << h->shift) + 1 < h->size) {
+        size_t first = (i << h->shift) + 1;
+        size_t end = first + arity < h->size ? first + arity : h->size;
+        size_t child = first;
+        for (size_t c = first + 1; c < end; ++c) {
+            if (lessHeapEntry(h->array[c], h->array[child])) {
+                child = c;
+            }
+        }
+        if (!lessHeapEntry(h->array[child], last)) {
+            break;
+        }
+        h->array[i] = h->array[child];
+        i = child;
+    }
+    h->array[i] = last;
+}
+
+bool isEmptyHeap(Heap *h) { return h->size == 0; }
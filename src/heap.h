@@ -0,0 +1,102 @@
+#ifndef __HEAP_H__
+#define __HEAP_H__
+/** @file
+ * Interfejs dostarczajacy strukturę kopca d-arnego (kolejki priorytetowej).
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "status.h"
+
+/**
+ * Element kopca - wierzchołek wraz z etykietą, z którą został wstawiony.
+ * Mniejsze są elementy o mniejszym priorytecie, przy równych priorytetach te
+ * o mniejszej odległości, a przy równych odległościach te o późniejszym roku.
+ */
+typedef struct HeapEntry {
+    /// priorytet - długość ścieżki powiększona o dolne ograniczenie odległości
+    /// do celu
+    uint64_t key;
+    /// długość ścieżki do wierzchołka
+    uint64_t dist;
+    /// rok najdawniej zbudowanego odcinka na ścieżce
+    int time;
+    /// wierzchołek
+    int vertex;
+} HeapEntry;
+
+/**
+ * Struktura reprezentująca kopiec typu min, w którym każdy węzeł ma
+ * 2^shift dzieci.
+ */
+typedef struct Heap {
+    /// tablica przechowująca elementy kopca
+    HeapEntry *array;
+    /// liczba elementów w kopcu
+    size_t size;
+    /// pojemność tablicy (zaalokowany rozmiar)
+    size_t capacity;
+    /// logarytm dwójkowy liczby dzieci węzła
+    unsigned shift;
+} Heap;
+
+/** @brief newHeap tworzy nowy kopiec binarny.
+ * @param[in] capacity  - początkowa pojemność kopca
+ * @return kopiec o podanej pojemności, lub kopiec o h.array == NULL, gdy nie
+ * udało się zaalokować pamięci.
+ */
+Heap newHeap(size_t capacity);
+
+/** @brief newDaryHeap tworzy nowy kopiec o 2^@p shift dzieciach w węźle.
+ * Płytszy kopiec wymaga mniej porównań przy wstawianiu, a dzieci węzła leżą
+ * obok siebie w pamięci.
+ * @param[in] capacity  - początkowa pojemność kopca
+ * @param[in] shift     - logarytm dwójkowy liczby dzieci węzła
+ * @return kopiec o podanej pojemności, lub kopiec o h.array == NULL, gdy nie
+ * udało się zaalokować pamięci.
+ */
+Heap newDaryHeap(size_t capacity, unsigned shift);
+
+/** @brief reserveHeap zapewnia pojemność kopca.
+ * Kolejne wstawienia, po których liczba elementów nie przekroczy @p capacity,
+ * nie alokują pamięci.
+ * @param[in,out] h     - kopiec
+ * @param[in] capacity  - wymagana pojemność
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status reserveHeap(Heap *h, size_t capacity);
+
+/** @brief deleteHeap zwalnia pamięć zajmowaną przez kopiec.
+ * @param[in,out] h     - kopiec
+ */
+void deleteHeap(Heap *h);
+
+/** @brief pushHeap wstawia element do kopca.
+ * W razie potrzeby powiększa tablicę kopca.
+ * @param[in,out] h     - kopiec
+ * @param[in] e         - element do wstawienia
+ * @return Status powodzenia operacji (może się nie powieść w przypadku błędu
+ * alokacji pamięci).
+ */
+Status pushHeap(Heap *h, HeapEntry e);
+
+/** @brief topHeap zwraca najmniejszy element kopca.
+ * @param[in] h         - kopiec
+ * @return najmniejszy element kopca (jeśli kopiec jest pusty, zachowanie jest
+ * niezdefiniowane).
+ */
+HeapEntry topHeap(Heap *h);
+
+/** @brief popHeap usuwa najmniejszy element kopca.
+ * @param[in,out] h     - kopiec
+ */
+void popHeap(Heap *h);
+
+/** @brief isEmptyHeap stwierdza, czy kopiec jest pusty.
+ * @param[in] h         - kopiec
+ * @return @p true jeśli kopiec jest pusty, @p false gdy nie jest.
+ */
+bool isEmptyHeap(Heap *h);
+
+#endif /* __HEAP_H__ */
@@ -0,0 +1,375 @@
+#include <string.h>
+
+#include "contraction.h"
+#include "hub_labels.h"
+#include "road_graph.h"
+
+/// Odległość do wierzchołka, do którego nie da się dojechać.
+#define INFINITY UINT64_MAX
+
+/// Etykiety są budowane od nowa, gdy wyszukiwania zastępujące nieaktualne
+/// etykiety ustalą tyle razy więcej wierzchołków, niż jest miast.
+#define REBUILD_WORK_FACTOR 64
+
+/// Początkowa pojemność kopca.
+#define HEAP_INITIAL_CAPACITY 16
+
+HubLabels *newHubLabels(void) {
+    HubLabels *hl = calloc(1, sizeof(HubLabels));
+    CHECK_RET(hl);
+    hl->stale = true;
+    hl->heap = newHeap(HEAP_INITIAL_CAPACITY);
+    if (hl->heap.array == NULL) {
+        free(hl);
+        return NULL;
+    }
+    return hl;
+}
+
+void deleteHubLabels(HubLabels *hl) {
+    if (hl == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < hl->capacity; ++i) {
+        free(hl->labels[i].array);
+    }
+    free(hl->labels);
+    free(hl->order);
+    free(hl->rank);
+    free(hl->hub_dist);
+    free(hl->dist);
+    free(hl->stamp);
+    deleteHeap(&hl->heap);
+    free(hl);
+}
+
+/** @brief Zmienia rozmiar tablicy.
+ * @param[in,out] array     - tablica
+ * @param[in] capacity      - nowa liczba elementów
+ * @param[in] size          - rozmiar elementu
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status resizeArray(void **array, size_t capacity, size_t size) {
+    void *n = realloc(*array, capacity * size);
+    CHECK_RET(n);
+    *array = n;
+    return true;
+}
+
+/** @brief Wstawia do etykiety odległość od węzła.
+ * Jeśli etykieta zawiera już ten węzeł, pozostawia mniejszą z odległości.
+ * @param[in,out] set       - etykieta
+ * @param[in] hub           - numer węzła
+ * @param[in] dist          - odległość od węzła
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status insertLabel(LabelSet *set, int hub, uint64_t dist) {
+    size_t lo = 0, hi = set->size;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (set->array[mid].hub < hub) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < set->size && set->array[lo].hub == hub) {
+        if (dist < set->array[lo].dist) {
+            set->array[lo].dist = dist;
+        }
+        return true;
+    }
+    if (set->size == set->capacity) {
+        size_t capacity = set->capacity > 0 ? 2 * set->capacity : 4;
+        CHECK_RET(resizeArray((void **)&set->array, capacity, sizeof(HubLabel)));
+        set->capacity = capacity;
+    }
+    memmove(set->array + lo + 1, set->array + lo,
+            (set->size - lo) * sizeof(HubLabel));
+    set->array[lo] = (HubLabel){hub, dist};
+    set->size++;
+    return true;
+}
+
+/** @brief Zapewnia, że etykiety obejmują @p cities_no wierzchołków.
+ * Nowe wierzchołki stają się najmniej ważnymi węzłami, a ich etykiety
+ * zawierają jedynie je same - nie wychodzą z nich jeszcze żadne odcinki
+ * drogowe.
+ * @param[in,out] hl        - etykiety
+ * @param[in] cities_no     - liczba wierzchołków
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status reserveVertices(HubLabels *hl, size_t cities_no) {
+    if (cities_no > hl->capacity) {
+        size_t capacity = 2 * hl->capacity;
+        if (capacity < cities_no) {
+            capacity = cities_no;
+        }
+        CHECK_RET(resizeArray((void **)&hl->order, capacity, sizeof(int)));
+        CHECK_RET(resizeArray((void **)&hl->rank, capacity, sizeof(int)));
+        CHECK_RET(resizeArray((void **)&hl->hub_dist, capacity,
+                              sizeof(uint64_t)));
+        CHECK_RET(resizeArray((void **)&hl->dist, capacity, sizeof(uint64_t)));
+        CHECK_RET(resizeArray((void **)&hl->stamp, capacity, sizeof(unsigned)));
+        CHECK_RET(resizeArray((void **)&hl->labels, capacity, sizeof(LabelSet)));
+        size_t added = capacity - hl->capacity;
+        // ustawia wszystkie bajty na 0xff, czyli odległości na INFINITY
+        memset(hl->hub_dist + hl->capacity, 0xff, added * sizeof(uint64_t));
+        memset(hl->stamp + hl->capacity, 0, added * sizeof(unsigned));
+        memset(hl->labels + hl->capacity, 0, added * sizeof(LabelSet));
+        hl->capacity = capacity;
+    }
+    for (size_t v = hl->cities_no; v < cities_no; ++v) {
+        hl->order[v] = v;
+        hl->rank[v] = v;
+        hl->labels[v].size = 0;
+        CHECK_RET(insertLabel(&hl->labels[v], v, 0));
+        hl->cities_no = v + 1;
+    }
+    return true;
+}
+
+/** @brief Wyznacza odległość z wierzchołka do węzła bieżącego wyszukiwania
+ * na podstawie etykiet.
+ * @param[in] hl            - etykiety z odległościami węzła wczytanymi do
+ * @p hub_dist
+ * @param[in] v             - wierzchołek
+ * @return Odległość wyznaczona przez etykiety.
+ */
+static uint64_t hubQuery(const HubLabels *hl, int v) {
+    const LabelSet *set = &hl->labels[v];
+    uint64_t best = INFINITY;
+    for (size_t i = 0; i < set->size; ++i) {
+        uint64_t d = hl->hub_dist[set->array[i].hub];
+        if (d != INFINITY && d + set->array[i].dist < best) {
+            best = d + set->array[i].dist;
+        }
+    }
+    return best;
+}
+
+/** @brief Przeprowadza przycinane wyszukiwanie z węzła.
+ * Wyszukiwanie rozpoczyna się w wierzchołku @p start w odległości
+ * @p start_dist od węzła i nie rozwija wierzchołków, do których etykiety
+ * wyznaczają już odległość nie większą - pozostałym dopisuje węzeł do etykiet.
+ * @param[in,out] hl        - etykiety
+ * @param[in] map           - mapa dróg
+ * @param[in] hub           - numer węzła
+ * @param[in] start         - wierzchołek początkowy
+ * @param[in] start_dist    - odległość wierzchołka początkowego od węzła
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status prunedSearch(HubLabels *hl, Map *map, int hub, int start,
+                           uint64_t start_dist) {
+    const LabelSet *own = &hl->labels[hl->order[hub]];
+    for (size_t i = 0; i < own->size; ++i) {
+        hl->hub_dist[own->array[i].hub] = own->array[i].dist;
+    }
+    hl->hub_dist[hub] = 0;
+    if (++hl->epoch == 0) {
+        memset(hl->stamp, 0, hl->capacity * sizeof(unsigned));
+        hl->epoch = 1;
+    }
+    hl->heap.size = 0;
+    hl->stamp[start] = hl->epoch;
+    hl->dist[start] = start_dist;
+    Status ret = pushHeap(&hl->heap,
+                          (HeapEntry){start_dist, start_dist, 0, start});
+    while (ret && !isEmptyHeap(&hl->heap)) {
+        HeapEntry e = topHeap(&hl->heap);
+        popHeap(&hl->heap);
+        if (e.dist > hl->dist[e.vertex] || hubQuery(hl, e.vertex) <= e.dist) {
+            continue;
+        }
+        ret = insertLabel(&hl->labels[e.vertex], hub, e.dist);
+        RoadIterator it = iterateRoads(map->graph, e.vertex);
+        Road road;
+        while (ret && nextRoad(&it, &road)) {
+            uint64_t dist = e.dist + road.length;
+            if (hl->stamp[road.end] != hl->epoch ||
+                dist < hl->dist[road.end]) {
+                hl->stamp[road.end] = hl->epoch;
+                hl->dist[road.end] = dist;
+                ret = pushHeap(&hl->heap, (HeapEntry){dist, dist, 0, road.end});
+            }
+        }
+    }
+    // etykieta węzła mogła się powiększyć, ale wczytane odległości się nie
+    // zmieniły
+    for (size_t i = 0; i < own->size; ++i) {
+        hl->hub_dist[own->array[i].hub] = INFINITY;
+    }
+    hl->hub_dist[hub] = INFINITY;
+    return ret;
+}
+
+/** @brief Buduje etykiety od nowa.
+ * Węzły przetwarzane są w kolejności ważności wyznaczonej przez ściąganie
+ * wierzchołków jak w hierarchii skrótów - wcześniejsze węzły leżą na
+ * większej liczbie najkrótszych ścieżek, więc przycinają więcej późniejszych
+ * wyszukiwań i etykiety pozostają małe.
+ * @param[in,out] hl        - etykiety
+ * @param[in] map           - mapa dróg
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status buildHubLabels(HubLabels *hl, Map *map) {
+    size_t cities_no = map->city_to_int.table.size;
+    CHECK_RET(reserveVertices(hl, cities_no));
+    CHECK_RET(contractionOrder(map, hl->order));
+    for (size_t r = 0; r < cities_no; ++r) {
+        hl->rank[hl->order[r]] = r;
+        hl->labels[r].size = 0;
+    }
+    for (size_t r = 0; r < cities_no; ++r) {
+        CHECK_RET(prunedSearch(hl, map, r, hl->order[r], 0));
+    }
+    return true;
+}
+
+/** @brief Kopiuje etykietę.
+ * @param[in] set           - etykieta
+ * @return Kopia elementów etykiety lub NULL, gdy nie udało się zaalokować
+ * pamięci.
+ */
+static HubLabel *copyLabels(const LabelSet *set) {
+    HubLabel *copy = malloc((set->size > 0 ? set->size : 1) * sizeof(HubLabel));
+    CHECK_RET(copy);
+    memcpy(copy, set->array, set->size * sizeof(HubLabel));
+    return copy;
+}
+
+void hubLabelsAddRoad(HubLabels *hl, Map *map, Road road) {
+    if (hl->stale) {
+        return;
+    }
+    if (!reserveVertices(hl, map->city_to_int.table.size)) {
+        hl->stale = true;
+        return;
+    }
+    // wyszukiwania zmieniają etykiety końców, więc przeglądamy ich kopie
+    size_t n1 = hl->labels[road.start].size;
+    size_t n2 = hl->labels[road.end].size;
+    HubLabel *l1 = copyLabels(&hl->labels[road.start]);
+    HubLabel *l2 = copyLabels(&hl->labels[road.end]);
+    Status ok = l1 != NULL && l2 != NULL;
+    // węzły przetwarzane są w kolejności ważności
+    size_t i = 0, j = 0;
+    while (ok && (i < n1 || j < n2)) {
+        if (j == n2 || (i < n1 && l1[i].hub <= l2[j].hub)) {
+            ok = prunedSearch(hl, map, l1[i].hub, road.end,
+                              l1[i].dist + road.length);
+            i++;
+        } else {
+            ok = prunedSearch(hl, map, l2[j].hub, road.start,
+                              l2[j].dist + road.length);
+            j++;
+        }
+    }
+    free(l1);
+    free(l2);
+    if (!ok) {
+        hl->stale = true;
+    }
+}
+
+void hubLabelsRemoveRoad(HubLabels *hl) {
+    if (!hl->stale) {
+        hl->stale = true;
+        hl->fallback_work = 0;
+    }
+}
+
+/** @brief Wyznacza odległość między wierzchołkami na podstawie etykiet.
+ * @param[in] hl            - aktualne etykiety
+ * @param[in] u             - jeden wierzchołek
+ * @param[in] v             - drugi wierzchołek
+ * @return Długość najkrótszej ścieżki lub UINT64_MAX, jeśli nie da się
+ * dojechać z @p u do @p v.
+ */
+static uint64_t labelDistance(const HubLabels *hl, int u, int v) {
+    const LabelSet *a = &hl->labels[u];
+    const LabelSet *b = &hl->labels[v];
+    uint64_t best = INFINITY;
+    size_t i = 0, j = 0;
+    while (i < a->size && j < b->size) {
+        if (a->array[i].hub < b->array[j].hub) {
+            i++;
+        } else if (a->array[i].hub > b->array[j].hub) {
+            j++;
+        } else {
+            uint64_t d = a->array[i].dist + b->array[j].dist;
+            if (d < best) {
+                best = d;
+            }
+            i++;
+            j++;
+        }
+    }
+    return best;
+}
+
+/** @brief Wyznacza odległość między wierzchołkami algorytmem Dijkstry.
+ * Odnotowuje liczbę ustalonych wierzchołków jako pracę wykonaną pod
+ * nieobecność etykiet.
+ * @param[in,out] hl        - etykiety (wykorzystywane są jedynie ich tablice
+ * pomocnicze)
+ * @param[in] map           - mapa dróg
+ * @param[in] u             - wierzchołek początkowy
+ * @param[in] v             - wierzchołek końcowy
+ * @param[out] d            - długość najkrótszej ścieżki lub UINT64_MAX
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status searchDistance(HubLabels *hl, Map *map, int u, int v,
+                             uint64_t *d) {
+    if (++hl->epoch == 0) {
+        memset(hl->stamp, 0, hl->capacity * sizeof(unsigned));
+        hl->epoch = 1;
+    }
+    *d = INFINITY;
+    hl->heap.size = 0;
+    hl->stamp[u] = hl->epoch;
+    hl->dist[u] = 0;
+    CHECK_RET(pushHeap(&hl->heap, (HeapEntry){0, 0, 0, u}));
+    while (!isEmptyHeap(&hl->heap)) {
+        HeapEntry e = topHeap(&hl->heap);
+        popHeap(&hl->heap);
+        if (e.dist > hl->dist[e.vertex]) {
+            continue;
+        }
+        hl->fallback_work++;
+        if (e.vertex == v) {
+            *d = e.dist;
+            break;
+        }
+        RoadIterator it = iterateRoads(map->graph, e.vertex);
+        Road road;
+        while (nextRoad(&it, &road)) {
+            uint64_t dist = e.dist + road.length;
+            if (hl->stamp[road.end] != hl->epoch ||
+                dist < hl->dist[road.end]) {
+                hl->stamp[road.end] = hl->epoch;
+                hl->dist[road.end] = dist;
+                CHECK_RET(
+                    pushHeap(&hl->heap, (HeapEntry){dist, dist, 0, road.end}));
+            }
+        }
+    }
+    return true;
+}
+
+Status hubLabelsDistance(HubLabels *hl, Map *map, int u, int v, uint64_t *d) {
+    size_t cities_no = map->city_to_int.table.size;
+    if (!reserveVertices(hl, cities_no)) {
+        hubLabelsRemoveRoad(hl);
+        return false;
+    }
+    if (hl->stale && hl->fallback_work >= REBUILD_WORK_FACTOR * cities_no) {
+        CHECK_RET(buildHubLabels(hl, map));
+        hl->stale = false;
+    }
+    if (hl->stale) {
+        return searchDistance(hl, map, u, v, d);
+    }
+    *d = labelDistance(hl, u, v);
+    return true;
+}
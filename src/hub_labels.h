@@ -0,0 +1,114 @@
+/** @file
+ * Etykiety węzłowe (ang. hub labels) wyznaczające dokładne odległości między
+ * miastami.
+ */
+#ifndef __HUB_LABELS_H__
+#define __HUB_LABELS_H__
+
+#include "heap.h"
+#include "map_struct.h"
+
+/**
+ * Element etykiety - odległość wierzchołka od węzła.
+ */
+typedef struct HubLabel {
+    /// numer węzła w kolejności ważności
+    int hub;
+    /// odległość od węzła
+    uint64_t dist;
+} HubLabel;
+
+/**
+ * Etykieta wierzchołka - elementy uporządkowane według numerów węzłów.
+ */
+typedef struct LabelSet {
+    /// elementy etykiety
+    HubLabel *array;
+    /// liczba elementów
+    size_t size;
+    /// pojemność tablicy (zaalokowany rozmiar)
+    size_t capacity;
+} LabelSet;
+
+/**
+ * Etykiety węzłowe.
+ * Każdy wierzchołek przechowuje odległości do pewnego zbioru węzłów, tak
+ * dobranego, że dla każdej pary wierzchołków w tej samej spójnej składowej
+ * pewna najkrótsza ścieżka między nimi przechodzi przez wspólny węzeł ich
+ * etykiet. Odległość jest więc minimum sum odległości po wspólnych węzłach.
+ * Etykiety wyznaczane są przycinanymi wyszukiwaniami (ang. pruned landmark
+ * labeling) z kolejnych wierzchołków, od najważniejszych.
+ */
+typedef struct HubLabels {
+    /// czy etykiety wymagają ponownego zbudowania
+    bool stale;
+    /// liczba wierzchołków ustalonych przez wyszukiwania zastępujące
+    /// etykiety od chwili ich unieważnienia
+    uint64_t fallback_work;
+    /// liczba wierzchołków, dla których przechowywane są etykiety
+    size_t cities_no;
+    /// pojemność tablic indeksowanych wierzchołkami
+    size_t capacity;
+    /// wierzchołki w kolejności ważności
+    int *order;
+    /// numer wierzchołka w kolejności ważności
+    int *rank;
+    /// etykiety wierzchołków
+    LabelSet *labels;
+    /// odległości od węzła bieżącego wyszukiwania, indeksowane numerami
+    /// węzłów
+    uint64_t *hub_dist;
+    /// odległości w bieżącym wyszukiwaniu
+    uint64_t *dist;
+    /// znaczniki pokolenia, w którym wierzchołek otrzymał odległość
+    unsigned *stamp;
+    /// pokolenie bieżącego wyszukiwania
+    unsigned epoch;
+    /// kopiec wyszukiwań
+    Heap heap;
+} HubLabels;
+
+/** @brief Tworzy puste (nieaktualne) etykiety węzłowe.
+ * @return Wskaźnik na etykiety lub NULL, gdy nie udało się zaalokować pamięci.
+ */
+HubLabels *newHubLabels(void);
+
+/** @brief Zwalnia etykiety węzłowe.
+ * @param[in,out] hl        - etykiety do zwolnienia
+ */
+void deleteHubLabels(HubLabels *hl);
+
+/** @brief Uwzględnia w etykietach nowy odcinek drogowy.
+ * Wznawia przycinane wyszukiwania z węzłów etykiet końców odcinka, dopisując
+ * lub zmniejszając odległości tam, gdzie odcinek skraca drogę. Etykiety mogą
+ * przestać być minimalne, ale pozostają dokładne. Jeśli nie uda się
+ * zaalokować pamięci, unieważnia etykiety.
+ * @param[in,out] hl        - etykiety
+ * @param[in] map           - mapa dróg zawierająca już nowy odcinek
+ * @param[in] road          - nowy odcinek drogowy
+ */
+void hubLabelsAddRoad(HubLabels *hl, Map *map, Road road);
+
+/** @brief Odnotowuje usunięcie odcinka drogowego.
+ * Usunięcie odcinka może wydłużyć odległości, więc etykiety stają się
+ * nieaktualne.
+ * @param[in,out] hl        - etykiety
+ */
+void hubLabelsRemoveRoad(HubLabels *hl);
+
+/** @brief Wyznacza odległość między wierzchołkami.
+ * Nieaktualne etykiety są budowane od nowa dopiero wtedy, gdy praca
+ * wykonana przez zastępujące je wyszukiwania przekroczy szacowany koszt
+ * budowy - dzięki temu częste usuwanie odcinków drogowych nie powoduje
+ * ciągłego przebudowywania.
+ * @param[in,out] hl        - etykiety
+ * @param[in] map           - mapa dróg
+ * @param[in] u             - jeden wierzchołek
+ * @param[in] v             - drugi wierzchołek
+ * @param[out] d            - długość najkrótszej ścieżki lub UINT64_MAX, jeśli
+ * nie da się dojechać z @p u do @p v
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status hubLabelsDistance(HubLabels *hl, Map *map, int u, int v, uint64_t *d);
+
+#endif /* __HUB_LABELS_H__ */
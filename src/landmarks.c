@@ -0,0 +1,217 @@
+#include <string.h>
+
+#include "landmarks.h"
+#include "road_graph.h"
+
+/// Odległość do wierzchołka, do którego nie da się dojechać.
+#define INFINITY UINT64_MAX
+
+/// Indeks jest budowany od nowa, gdy liczba miast wzrośnie tyle razy.
+#define GROWTH_FACTOR 2
+
+/// Indeks jest budowany od nowa, gdy liczba usuniętych odcinków przekroczy
+/// liczbę miast podzieloną przez tę stałą.
+#define REMOVED_ROADS_RATIO 8
+
+/// Początkowa pojemność kopca.
+#define HEAP_INITIAL_CAPACITY 16
+
+Landmarks *newLandmarks(size_t count) {
+    CHECK_RET(count > 0);
+    Landmarks *lm = calloc(1, sizeof(Landmarks));
+    CHECK_RET(lm);
+    lm->requested = count;
+    lm->stale = true;
+    lm->vertices = malloc(count * sizeof(int));
+    lm->heap = newHeap(HEAP_INITIAL_CAPACITY);
+    if (lm->vertices == NULL || lm->heap.array == NULL) {
+        deleteLandmarks(lm);
+        return NULL;
+    }
+    return lm;
+}
+
+void deleteLandmarks(Landmarks *lm) {
+    if (lm == NULL) {
+        return;
+    }
+    free(lm->vertices);
+    free(lm->dist);
+    deleteHeap(&lm->heap);
+    free(lm);
+}
+
+/** @brief Zapewnia, że indeks przechowuje odległości @p cities_no wierzchołków.
+ * Nowe wierzchołki są nieosiągalne z żadnego punktu orientacyjnego - nie
+ * wychodzą z nich jeszcze żadne odcinki drogowe.
+ * @param[in,out] lm        - indeks
+ * @param[in] cities_no     - liczba wierzchołków
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status reserveDistances(Landmarks *lm, size_t cities_no) {
+    if (cities_no <= lm->cities_no) {
+        return true;
+    }
+    size_t k = lm->requested;
+    uint64_t *dist = realloc(lm->dist, cities_no * k * sizeof(uint64_t));
+    CHECK_RET(dist);
+    // ustawia wszystkie bajty na 0xff, czyli odległości na INFINITY
+    memset(dist + lm->cities_no * k, 0xff,
+           (cities_no - lm->cities_no) * k * sizeof(uint64_t));
+    lm->dist = dist;
+    lm->cities_no = cities_no;
+    return true;
+}
+
+/** @brief Wyznacza odległości od punktu orientacyjnego algorytmem Dijkstry.
+ * Rozpoczyna od wierzchołków znajdujących się w kopcu indeksu, których
+ * odległości zostały już zmniejszone.
+ * @param[in,out] lm        - indeks
+ * @param[in] map           - mapa dróg
+ * @param[in] i             - numer punktu orientacyjnego
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status propagate(Landmarks *lm, Map *map, size_t i) {
+    size_t k = lm->requested;
+    while (!isEmptyHeap(&lm->heap)) {
+        HeapEntry e = topHeap(&lm->heap);
+        popHeap(&lm->heap);
+        if (e.dist > lm->dist[(size_t)e.vertex * k + i]) {
+            continue;
+        }
+        RoadIterator it = iterateRoads(map->graph, e.vertex);
+        Road road;
+        while (nextRoad(&it, &road)) {
+            uint64_t dist = e.dist + road.length;
+            uint64_t *old = &lm->dist[(size_t)road.end * k + i];
+            if (dist < *old) {
+                *old = dist;
+                CHECK_RET(pushHeap(&lm->heap,
+                                   (HeapEntry){dist, dist, 0, road.end}));
+            }
+        }
+    }
+    return true;
+}
+
+/** @brief Wybiera punkty orientacyjne i wyznacza ich odległości.
+ * Kolejnym punktem zostaje wierzchołek najdalszy od dotychczas wybranych
+ * (w pierwszej kolejności wierzchołki, do których nie da się z nich
+ * dojechać), co rozmieszcza punkty na obrzeżach sieci dróg.
+ * @param[in,out] lm        - indeks
+ * @param[in] map           - mapa dróg
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status buildLandmarks(Landmarks *lm, Map *map) {
+    size_t k = lm->requested;
+    size_t cities_no = map->city_to_int.table.size;
+    CHECK_RET(reserveDistances(lm, cities_no));
+    memset(lm->dist, 0xff, lm->cities_no * k * sizeof(uint64_t));
+    lm->count = 0;
+    if (cities_no == 0) {
+        return true;
+    }
+
+    // odległość do najbliższego z wybranych punktów orientacyjnych
+    uint64_t *nearest = malloc(cities_no * sizeof(uint64_t));
+    CHECK_RET(nearest);
+    memset(nearest, 0xff, cities_no * sizeof(uint64_t));
+
+    Status ret = false;
+    for (size_t i = 0; i < k; ++i) {
+        int next = -1;
+        for (size_t v = 0; v < cities_no; ++v) {
+            RoadIterator it = iterateRoads(map->graph, v);
+            Road road;
+            if (nextRoad(&it, &road) && nearest[v] > 0 &&
+                (next == -1 || nearest[v] > nearest[next])) {
+                next = v;
+            }
+        }
+        if (next == -1) {
+            break;
+        }
+        lm->vertices[lm->count++] = next;
+        lm->dist[(size_t)next * k + i] = 0;
+        lm->heap.size = 0;
+        if (!pushHeap(&lm->heap, (HeapEntry){0, 0, 0, next}) ||
+            !propagate(lm, map, i)) {
+            goto FREE;
+        }
+        for (size_t v = 0; v < cities_no; ++v) {
+            if (lm->dist[v * k + i] < nearest[v]) {
+                nearest[v] = lm->dist[v * k + i];
+            }
+        }
+    }
+    ret = true;
+FREE:
+    free(nearest);
+    return ret;
+}
+
+Status updateLandmarks(Landmarks *lm, Map *map) {
+    size_t cities_no = map->city_to_int.table.size;
+    if (lm->stale || cities_no > GROWTH_FACTOR * lm->built_cities_no ||
+        lm->removed_roads * REMOVED_ROADS_RATIO > cities_no) {
+        lm->stale = true;
+        CHECK_RET(buildLandmarks(lm, map));
+        lm->stale = false;
+        lm->built_cities_no = cities_no;
+        lm->removed_roads = 0;
+    }
+    return reserveDistances(lm, cities_no);
+}
+
+void landmarksAddRoad(Landmarks *lm, Map *map, Road road) {
+    if (lm->stale) {
+        return;
+    }
+    if (!reserveDistances(lm, map->city_to_int.table.size)) {
+        lm->stale = true;
+        return;
+    }
+    size_t k = lm->requested;
+    for (size_t i = 0; i < lm->count; ++i) {
+        uint64_t *d1 = &lm->dist[(size_t)road.start * k + i];
+        uint64_t *d2 = &lm->dist[(size_t)road.end * k + i];
+        lm->heap.size = 0;
+        Status ok = true;
+        if (*d1 != INFINITY && *d1 + road.length < *d2) {
+            *d2 = *d1 + road.length;
+            ok = pushHeap(&lm->heap, (HeapEntry){*d2, *d2, 0, road.end});
+        } else if (*d2 != INFINITY && *d2 + road.length < *d1) {
+            *d1 = *d2 + road.length;
+            ok = pushHeap(&lm->heap, (HeapEntry){*d1, *d1, 0, road.start});
+        }
+        if (!ok || !propagate(lm, map, i)) {
+            lm->stale = true;
+            return;
+        }
+    }
+}
+
+void landmarksRemoveRoad(Landmarks *lm) { lm->removed_roads++; }
+
+void invalidateLandmarks(Landmarks *lm) { lm->stale = true; }
+
+uint64_t landmarkBound(const Landmarks *lm, int v, int t) {
+    const uint64_t *dv = lm->dist + (size_t)v * lm->requested;
+    const uint64_t *dt = lm->dist + (size_t)t * lm->requested;
+    uint64_t bound = 0;
+    for (size_t i = 0; i < lm->count; ++i) {
+        if (dv[i] == INFINITY || dt[i] == INFINITY) {
+            // jeden z wierzchołków jest osiągalny z punktu orientacyjnego,
+            // a drugi nie - leżą w różnych spójnych składowych
+            if (dv[i] != dt[i]) {
+                return INFINITY;
+            }
+            continue;
+        }
+        uint64_t diff = dv[i] > dt[i] ? dv[i] - dt[i] : dt[i] - dv[i];
+        if (diff > bound) {
+            bound = diff;
+        }
+    }
+    return bound;
+}
@@ -0,0 +1,94 @@
+/** @file
+ * Indeks punktów orientacyjnych, wyznaczający dolne ograniczenia odległości
+ * między miastami.
+ */
+#ifndef __LANDMARKS_H__
+#define __LANDMARKS_H__
+
+#include "heap.h"
+#include "map_struct.h"
+
+/**
+ * Indeks punktów orientacyjnych.
+ * Dla każdego punktu orientacyjnego L przechowuje odległości d(L, v) do
+ * wszystkich wierzchołków. Z nierówności trójkąta |d(L, t) - d(L, v)| jest
+ * dolnym ograniczeniem odległości z v do t. Odległości są wyznaczone w grafie
+ * zawierającym wszystkie obecne odcinki drogowe (i być może odcinki już
+ * usunięte), więc ograniczenia pozostają poprawne po usunięciu odcinka.
+ */
+typedef struct Landmarks {
+    /// żądana liczba punktów orientacyjnych
+    size_t requested;
+    /// liczba wybranych punktów orientacyjnych
+    size_t count;
+    /// liczba wierzchołków, dla których przechowywane są odległości
+    size_t cities_no;
+    /// liczba wierzchołków w chwili wyboru punktów orientacyjnych
+    size_t built_cities_no;
+    /// liczba odcinków usuniętych od chwili wyboru punktów orientacyjnych
+    size_t removed_roads;
+    /// czy indeks wymaga ponownego zbudowania
+    bool stale;
+    /// wybrane punkty orientacyjne
+    int *vertices;
+    /// odległości; d(L_i, v) znajduje się pod indeksem v * requested + i
+    uint64_t *dist;
+    /// kopiec wykorzystywany przy wyznaczaniu odległości
+    Heap heap;
+} Landmarks;
+
+/** @brief Tworzy pusty indeks punktów orientacyjnych.
+ * Indeks zostanie zbudowany przy pierwszym wywołaniu @ref updateLandmarks.
+ * @param[in] count         - liczba punktów orientacyjnych
+ * @return Wskaźnik na indeks lub NULL, gdy nie udało się zaalokować pamięci.
+ */
+Landmarks *newLandmarks(size_t count);
+
+/** @brief Zwalnia indeks punktów orientacyjnych.
+ * @param[in,out] lm        - indeks do zwolnienia
+ */
+void deleteLandmarks(Landmarks *lm);
+
+/** @brief Przygotowuje indeks do odpowiadania na zapytania.
+ * Buduje indeks od nowa, jeśli został unieważniony, jeśli liczba miast
+ * znacząco wzrosła od ostatniego zbudowania, albo jeśli usunięto wiele
+ * odcinków drogowych (ograniczenia są wtedy poprawne, ale słabe).
+ * @param[in,out] lm        - indeks
+ * @param[in] map           - mapa dróg
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status updateLandmarks(Landmarks *lm, Map *map);
+
+/** @brief Uwzględnia w indeksie nowy odcinek drogowy.
+ * Zmniejsza odległości wierzchołków, do których nowy odcinek skraca drogę.
+ * Jeśli nie uda się zaalokować pamięci, unieważnia indeks.
+ * @param[in,out] lm        - indeks
+ * @param[in] map           - mapa dróg zawierająca już nowy odcinek
+ * @param[in] road          - nowy odcinek drogowy
+ */
+void landmarksAddRoad(Landmarks *lm, Map *map, Road road);
+
+/** @brief Odnotowuje usunięcie odcinka drogowego.
+ * Ograniczenia pozostają poprawne, ale stopniowo słabną, więc po usunięciu
+ * wielu odcinków indeks zostanie zbudowany od nowa.
+ * @param[in,out] lm        - indeks
+ */
+void landmarksRemoveRoad(Landmarks *lm);
+
+/** @brief Unieważnia indeks, np. po zmianie numeracji miast.
+ * Indeks zostanie zbudowany od nowa przy następnym wywołaniu
+ * @ref updateLandmarks.
+ * @param[in,out] lm        - indeks
+ */
+void invalidateLandmarks(Landmarks *lm);
+
+/** @brief Wyznacza dolne ograniczenie odległości z @p v do @p t.
+ * @param[in] lm            - indeks przygotowany przez @ref updateLandmarks
+ * @param[in] v             - wierzchołek początkowy
+ * @param[in] t             - wierzchołek końcowy
+ * @return Dolne ograniczenie odległości lub UINT64_MAX, jeśli z @p v nie da
+ * się dojechać do @p t.
+ */
+uint64_t landmarkBound(const Landmarks *lm, int v, int t);
+
+#endif /* __LANDMARKS_H__ */
@@ -4,8 +4,19 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "city_order.h"
+#include "connectivity.h"
+#include "contraction.h"
+#include "delta_stepping.h"
+#include "edge_table.h"
+#include "hub_labels.h"
+#include "landmarks.h"
 #include "map.h"
 #include "map_struct.h"
+#include "path_cache.h"
+#include "road_graph.h"
+#include "route_trees.h"
+#include "search_pool.h"
 #include "shortest_paths.h"
 #include "utils.h"
 
@@ -13,6 +24,11 @@
 /// ścieżki.
 #define INFINITY UINT64_MAX
 
+/// Miasta są numerowane od nowa dopiero wtedy, gdy dodano więcej odcinków
+/// drogowych niż tę stałą; małe mapy mieszczą się w pamięci podręcznej
+/// procesora przy dowolnej numeracji.
+#define RENUMBER_SLACK 1024
+
 /** @brief Usuwa drogi krajowe.
  * @param[in,out] map       - mapa, z której usuwamy drogi krajowe
  */
@@ -22,76 +38,37 @@ static void deleteRoutes(Map *map) {
     }
 }
 
-/** @brief Usuwa listę sąsiedztwa, która reprezentuje drogi między miastami.
- * @param[in,out] map       - mapa, z której usuwamy drogi
- */
-static void deleteAdjacencyDictionaries(Map *map) {
-    if (map == NULL) {
-        return;
-    }
-    for (size_t i = 0; i < map->neighbours.size; ++i) {
-        deleteDictionary(map->neighbours.arr[i]);
-        free(map->neighbours.arr[i]);
-        map->neighbours.arr[i] = NULL;
-    }
-}
-
-/** @brief Zwalnia pamięć z wskaźnika @p ptr o ile ten nie jest @p DELETED.
- * @param[in,out] ptr           - wskaźnik, spod którego opróżniamy pamięć
- */
-static void free_(void *ptr) {
-    if (ptr != DELETED) {
-        free(ptr);
-    }
-}
-
-/** @brief Opróżnia listę (zwalnia pamięć).
- * Współpracuje z listami, które są elementami słownika.
- * @param[in,out] ptr          - wskaźnik na listę
- */
-static void free_list(void *ptr) {
-    List *l = ptr;
-    if (l != NULL && l != DELETED) {
-        deleteList(l);
-        free(l->begin);
-        free(l);
-    }
-}
-
 Map *newMap(void) {
     Map *map = calloc(1, sizeof(Map));
     CHECK_RET(map);
     /// Droga krajowa o numerze 0 jest niepoprawna.
     memset(map->routes, 0, ROUTE_MAX * sizeof(Route));
 
-    Dictionary *d =
-        newDictionary(hashString, undereferencing_strcmp, free_, empty);
-    if (d == NULL) {
+    seedStringHash();
+    if (!initCityIndex(&map->city_to_int)) {
         goto DELETE;
     }
-    map->city_to_int = *d;
-    free(d);
 
-    Vector *n = newVector();
-    if (n == NULL) {
+    if (!initCityNames(&map->int_to_city)) {
         goto DELETE;
     }
-    map->neighbours = *n;
-    free(n);
 
-    Vector *c = newVector();
-    if (c == NULL) {
+    if (!initEdgeTable(&map->edges)) {
         goto DELETE;
     }
-    map->int_to_city = *c;
-    free(c);
 
-    Dictionary *edges = newDictionary(hashEdge, cmpEdges, empty, free_list);
-    if (edges == NULL) {
+    map->workspace = newSearchWorkspace();
+    if (map->workspace == NULL) {
+        goto DELETE;
+    }
+    map->connectivity = newConnectivity();
+    if (map->connectivity == NULL) {
+        goto DELETE;
+    }
+    map->graph = newRoadGraph();
+    if (map->graph == NULL) {
         goto DELETE;
     }
-    map->routesThrough = *edges;
-    free(edges);
     return map;
 
 DELETE:
@@ -102,80 +79,48 @@ DELETE:
 
 void deleteMap(Map *map) {
     deleteRoutes(map);
-    deleteDictionary(&map->city_to_int);
-    free(map->city_to_int.array);
-    deleteAdjacencyDictionaries(map);
-    vectorDeleteFreeContent(&map->neighbours);
-    deleteDictionary(&map->routesThrough);
-    vectorDelete(&map->int_to_city);
+    deleteCityIndex(&map->city_to_int);
+    deleteEdgeTable(&map->edges);
+    deleteCityNames(&map->int_to_city);
+    deleteSearchWorkspace(map->workspace);
+    deleteLandmarks(map->landmarks);
+    deleteContractionHierarchy(map->hierarchy);
+    deleteHubLabels(map->hub_labels);
+    deleteDeltaStepping(map->delta_stepping);
+    deleteSearchPool(map->search_pool);
+    deleteRouteTrees(map->route_trees);
+    deletePathCache(map->path_cache);
+    deleteConnectivity(map->connectivity);
+    deleteRoadGraph(map->graph);
     free(map);
 }
 
 Road getRoadFromName(Map *map, char *city1, char *city2) {
-    Entry e1 = getDictionary(&map->city_to_int, (void *)city1);
-    Entry e2 = getDictionary(&map->city_to_int, (void *)city2);
-    if (NOT_FOUND(e1) || NOT_FOUND(e2)) {
+    int *e1 = getCityIndex(&map->city_to_int, city1);
+    int *e2 = getCityIndex(&map->city_to_int, city2);
+    if (e1 == NULL || e2 == NULL) {
         return (const Road){0};
     }
-    int id1 = decodeCityId(e1.val);
-    int id2 = decodeCityId(e2.val);
+    int id1 = *e1;
+    int id2 = *e2;
     return getRoad(map, id1, id2);
 }
 
-/** @brief Stwierdza, czy drogi @p r1 i @p r2 są tą samą drogą, tylko w
- * przeciwnym kierunku.
- * @param r1
- * @param r2
- * @return
- */
-static bool areRoadsConsistent(Road *r1, Road *r2) {
-    CHECK_RET(r1);
-    CHECK_RET(r2);
-    CHECK_RET(r1->builtYear == r2->builtYear);
-    CHECK_RET(r1->length == r2->length);
-    CHECK_RET(r1->end == r2->start);
-    CHECK_RET(r2->start == r1->end);
-    return true;
-}
-
 Status addCity(Map *map, const char *city) {
     CHECK_RET(map);
     CHECK_RET(city);
-    if (!NOT_FOUND(getDictionary(&map->city_to_int, (void *)city))) {
+    if (getCityIndex(&map->city_to_int, city) != NULL) {
         return true;
     }
 
-    size_t len = strlen(city);
-    char *c = malloc(len + 1);
+    const char *c = appendCityName(&map->int_to_city, city, strlen(city));
     CHECK_RET(c);
-    strcpy(c, city);
-
-    void *city_id = encodeCityId(map->city_to_int.size);
-    if (!insertDictionary(&map->city_to_int, (void *)c, city_id)) {
-        free(c);
+    int id = (int)map->city_to_int.table.size;
+    if (!insertCityIndex(&map->city_to_int, c, id)) {
+        removeLastCityName(&map->int_to_city);
         return false;
     }
-
-    Dictionary *d = newDictionary(hashInt, equalInt, empty, free_);
-    if (d == NULL) {
-        goto DELETE_FROM_DICTIONARY;
-    }
-    if (vectorAppend(&map->neighbours, d) == false) {
-        goto DELETE_DICT;
-    }
-    if (vectorAppend(&map->int_to_city, (void *)c) == false) {
-        goto DELETE_V;
-    }
     return true;
-
-DELETE_V:
-    vectorRemoveLast(&map->neighbours, false);
-DELETE_DICT:
-    deleteDictionary(d);
-    free(d);
-DELETE_FROM_DICTIONARY:
-    deleteFromDictionary(&map->city_to_int, (void *)c);
-    return false;
 }
 
 bool addRoad(Map *map, const char *city1, const char *city2, unsigned length,
@@ -185,67 +130,45 @@ bool addRoad(Map *map, const char *city1, const char *city2, unsigned length,
     CHECK_RET(map);
     CHECK_RET(possiblyValidRoad(city1, city2));
 
-    Entry e1 = getDictionary(&map->city_to_int, (void *)city1);
-    Entry e2 = getDictionary(&map->city_to_int, (void *)city2);
+    int *e1 = getCityIndex(&map->city_to_int, city1);
+    int *e2 = getCityIndex(&map->city_to_int, city2);
 
     // don't bother with deleting this, in case of further failure
-    if (NOT_FOUND(e1)) {
+    if (e1 == NULL) {
         CHECK_RET(addCity(map, city1));
     }
-    if (NOT_FOUND(e2)) {
+    if (e2 == NULL) {
         CHECK_RET(addCity(map, city2));
     }
 
-    e1 = getDictionary(&map->city_to_int, (void *)city1);
-    e2 = getDictionary(&map->city_to_int, (void *)city2);
-    int id1 = decodeCityId(e1.val);
-    int id2 = decodeCityId(e2.val);
+    e1 = getCityIndex(&map->city_to_int, city1);
+    e2 = getCityIndex(&map->city_to_int, city2);
+    int id1 = *e1;
+    int id2 = *e2;
 
-    Entry edge12 = getDictionary((map->neighbours.arr)[id1], &id2);
-    Entry edge21 = getDictionary((map->neighbours.arr)[id2], &id1);
-    if (!NOT_FOUND(edge12) || !NOT_FOUND(edge21)) {
-        return false;
-    }
+    CHECK_RET(getEdge(&map->edges, id1, id2) == NULL);
+    CHECK_RET(reserveRoadGraph(map->graph, map->city_to_int.table.size));
+    CHECK_RET(insertEdge(&map->edges, id1, id2, length, builtYear));
 
-    List *l = NULL;
-    Road *r1 = calloc(1, sizeof(Road));
-    Road *r2 = calloc(1, sizeof(Road));
-    if (r1 == NULL || r2 == NULL) {
-        goto FREE_L;
-    }
-    *r1 = (const Road){
+    Road road = {
         .builtYear = builtYear, .length = length, .start = id1, .end = id2};
-    *r2 = *r1;
-    r2->start = r1->end;
-    r2->end = r1->start;
-
-    void *edge = encodeEdgeAsPtr(id1, id2);
-
-    l = newList();
-    if (!l) {
-        goto FREE_L;
+    map->version++;
+    map->roads_added++;
+    roadGraphAddRoad(map->graph, map, road);
+    connectivityAddRoad(map->connectivity, map, road);
+    if (map->landmarks != NULL) {
+        landmarksAddRoad(map->landmarks, map, road);
     }
-    if (insertDictionary(&map->routesThrough, edge, l) == false) {
-        goto FREE_L;
+    if (map->hierarchy != NULL) {
+        invalidateContractionHierarchy(map->hierarchy);
     }
-    if (insertDictionary(map->neighbours.arr[id1], &(r1->end), r1) == false) {
-        goto FREE_R;
+    if (map->hub_labels != NULL) {
+        hubLabelsAddRoad(map->hub_labels, map, road);
     }
-    if (insertDictionary(map->neighbours.arr[id2], &(r2->end), r2) == false) {
-        goto FREE_R;
+    if (map->route_trees != NULL) {
+        routeTreesAddRoad(map->route_trees, map, road);
     }
     return true;
-
-FREE_R:
-    deleteFromDictionary(&map->routesThrough, edge);
-    l = NULL;
-FREE_L:
-    deleteList(l);
-    free(l);
-    free(r1);
-    free(r2);
-
-    return false;
 }
 
 bool repairRoad(Map *map, const char *city1, const char *city2,
@@ -254,28 +177,28 @@ bool repairRoad(Map *map, const char *city1, const char *city2,
     CHECK_RET(repairYear);
     CHECK_RET(possiblyValidRoad(city1, city2));
 
-    Entry e1 = getDictionary(&map->city_to_int, (void *)city1);
-    CHECK_RET(NOT_FOUND(e1) == false);
-    Entry e2 = getDictionary(&map->city_to_int, (void *)city2);
-    CHECK_RET(NOT_FOUND(e2) == false);
+    int *e1 = getCityIndex(&map->city_to_int, city1);
+    CHECK_RET(e1 != NULL);
+    int *e2 = getCityIndex(&map->city_to_int, city2);
+    CHECK_RET(e2 != NULL);
 
-    int id1 = decodeCityId(e1.val);
-    int id2 = decodeCityId(e2.val);
+    int id1 = *e1;
+    int id2 = *e2;
 
-    Entry edge12 = getDictionary((map->neighbours.arr)[id1], &id2);
-    Entry edge21 = getDictionary((map->neighbours.arr)[id2], &id1);
+    Edge *e = getEdge(&map->edges, id1, id2);
+    CHECK_RET(e);
+    CHECK_RET(repairYear >= e->builtYear);
+    e->builtYear = repairYear;
 
-    if (NOT_FOUND(edge12) || NOT_FOUND(edge21)) {
-        return false;
+    Road road = {e->length, repairYear, id1, id2};
+    map->version++;
+    roadGraphRepairRoad(map->graph, road);
+    if (map->hierarchy != NULL) {
+        contractionRepairRoad(map->hierarchy, id1, id2, repairYear);
+    }
+    if (map->route_trees != NULL) {
+        routeTreesAddRoad(map->route_trees, map, road);
     }
-    Road *r1 = edge12.val;
-    Road *r2 = edge21.val;
-
-    assert(areRoadsConsistent(r1, r2));
-
-    CHECK_RET(repairYear >= r1->builtYear);
-    r1->builtYear = repairYear;
-    r2->builtYear = repairYear;
     return true;
 }
 
@@ -288,18 +211,49 @@ Status addRoadRepair(Map *map, char *city1, char *city2, unsigned length,
     }
 }
 
-/** @brief Dodaje do drogi krajowej fragment wskazany przez tablicę @p prev.
- * @param[in,out] routesThrough    - słownik dróg krajowych  przebiagających
- * przez drogi
+/** @brief Zapamiętuje ścieżkę wyznaczoną przez tablicę przodków.
+ * @param[in] prev          - tablica przodków (@ref searchPrev)
+ * @param[in] end           - wierzchołek, w którym kończy się ścieżka
+ * @return Lista kolejnych przodków @p end (bez niego samego), zakończona
+ * wierzchołkiem początkowym ścieżki, lub NULL, gdy nie udało się zaalokować
+ * pamięci.
+ */
+static List *pathFromPrev(int *prev, int end) {
+    List *path = newList();
+    CHECK_RET(path);
+    for (int current = prev[end]; current != -1; current = prev[current]) {
+        if (listInsertBefore(path, path->end, current) == false) {
+            deleteList(path);
+            free(path);
+            return NULL;
+        }
+    }
+    return path;
+}
+
+/** @brief Zwalnia listę wraz z jej zawartością.
+ * @param[in,out] l         - lista do zwolnienia
+ */
+static void freeList(List *l) {
+    if (l != NULL) {
+        deleteList(l);
+        free(l);
+    }
+}
+
+/** @brief Dodaje do drogi krajowej fragment @p path.
+ * @param[in,out] edges            - tablica odcinków, w której zapisujemy
+ * drogi krajowe przebiegające przez odcinki
  * @param[in] routeId              - numer drogi krajowej, którą modyfikujemy
  * @param[in,out] route            - droga krajowa, którą modyfikujemy
- * @param[in] prev                 - tablica wyznaczonych poprzedników elementów
+ * @param[in] path                 - kolejne wierzchołki do dodania, zaczynając
+ * od sąsiada końca drogi krajowej (@ref pathFromPrev)
  * @param[in] after                - element, po którym należy wstawiać nowe
  * wierzchołki
  * @return Status powodzenia operacji.
  */
-static Status appendPath(Dictionary *routesThrough, unsigned routeId,
-                         List *route, int *prev, Node *after) {
+static Status appendPath(EdgeTable *edges, unsigned routeId,
+                         List *route, List *path, Node *after) {
     int current = after->value;
     int inserted_count = 0;
     if (after == route->begin) {
@@ -307,9 +261,9 @@ static Status appendPath(Dictionary *routesThrough, unsigned routeId,
     } else if (after == route->end) {
         current = route->end->prev->value;
     }
-    while (current != -1 && prev[current] != -1) {
+    for (Node *n = path->begin->next; n != path->end; n = n->next) {
         int p = current;
-        current = prev[current];
+        current = n->value;
         bool v = true;
         if (route != NULL) {
             v = listInsertAfter(route, after, current);
@@ -320,11 +274,11 @@ static Status appendPath(Dictionary *routesThrough, unsigned routeId,
             }
             return false;
         }
-        if (routesThrough != NULL) {
-            Entry e = getDictionary(routesThrough, encodeEdgeAsPtr(p, current));
-            assert(!NOT_FOUND(e));
-            List *l = e.val;
-            if (listInsertAfter(l, l->begin, routeId) == false) {
+        if (edges != NULL) {
+            Edge *e = getEdge(edges, p, current);
+            assert(e != NULL);
+            List *l = edgeRoutes(e);
+            if (l == NULL || listInsertAfter(l, l->begin, routeId) == false) {
                 return false;
             }
         }
@@ -333,51 +287,256 @@ static Status appendPath(Dictionary *routesThrough, unsigned routeId,
     return true;
 }
 
-bool newRoute(Map *map, unsigned routeId, const char *city1,
-              const char *city2) {
+/** @brief Sprawdza, czy między miastami istnieje droga.
+ * @param[in,out] map       - mapa dróg
+ * @param[in] A             - pierwsze miasto
+ * @param[in] B             - drugie miasto
+ * @return @p true jeśli miasta są połączone, @p false jeśli nie są lub
+ * nastąpił błąd alokacji pamięci.
+ */
+static bool areConnected(Map *map, int A, int B) {
+    bool connected;
+    return connectivityQuery(map->connectivity, map, A, B, &connected) &&
+           connected;
+}
+
+Status renumberCities(Map *map) {
     CHECK_RET(map);
-    CHECK_RET(possiblyValidRoad(city1, city2));
-    CHECK_RET(1 <= routeId && routeId < ROUTE_MAX);
-    CHECK_RET(map->routes[routeId].cities.begin == NULL);
-    CHECK_RET(map->routes[routeId].cities.end == NULL);
+    size_t cities_no = map->city_to_int.table.size;
+    map->roads_added = 0;
+    if (cities_no == 0) {
+        return true;
+    }
+    int *order = malloc(cities_no * sizeof(int));
+    int *perm = malloc(cities_no * sizeof(int));
+    const char **names = malloc(cities_no * sizeof(char *));
+    Status ret = false;
+    if (order == NULL || perm == NULL || names == NULL ||
+        !cityOrder(map, order)) {
+        goto FREE;
+    }
+    for (size_t i = 0; i < cities_no; ++i) {
+        perm[order[i]] = (int)i;
+        names[i] = map->int_to_city.names[order[i]];
+    }
+    if (!reserveRoadGraphSnapshot(map->graph, cities_no,
+                                  map->edges.count) ||
+        !renumberEdgeTable(&map->edges, perm, cities_no)) {
+        goto FREE;
+    }
 
-    Entry e1 = getDictionary(&map->city_to_int, (void *)city1);
-    CHECK_RET(NOT_FOUND(e1) == false);
-    Entry e2 = getDictionary(&map->city_to_int, (void *)city2);
-    CHECK_RET(NOT_FOUND(e2) == false);
-    int id1 = decodeCityId(e1.val);
-    int id2 = decodeCityId(e2.val);
+    // Od tego miejsca nic nie może się nie udać.
+    HashTable *cities = &map->city_to_int.table;
+    for (size_t i = 0; i < cities->array_size; ++i) {
+        if (IS_FULL_CTRL(cities->ctrl[i])) {
+            CityIndexSlot *slot = &((CityIndexSlot *)cities->slots)[i];
+            slot->val = perm[slot->val];
+        }
+    }
+    memcpy(map->int_to_city.names, names, cities_no * sizeof(char *));
+    for (unsigned i = 0; i < ROUTE_MAX; ++i) {
+        List *l = &map->routes[i].cities;
+        if (l->begin != NULL) {
+            for (Node *n = l->begin->next; n != l->end; n = n->next) {
+                n->value = perm[n->value];
+            }
+        }
+        if (map->route_trees != NULL) {
+            routeTreesRemoveRoute(map->route_trees, i);
+        }
+    }
+    rebuildRoadGraph(map->graph, map);
+
+    // Indeksy odległości są wyznaczane od nowa przy następnym użyciu.
+    map->version++;
+    connectivityRemoveRoad(map->connectivity);
+    if (map->landmarks != NULL) {
+        invalidateLandmarks(map->landmarks);
+    }
+    if (map->hierarchy != NULL) {
+        invalidateContractionHierarchy(map->hierarchy);
+    }
+    if (map->hub_labels != NULL) {
+        hubLabelsRemoveRoad(map->hub_labels);
+    }
+    ret = true;
+
+FREE:
+    free(order);
+    free(perm);
+    free(names);
+    return ret;
+}
+
+/** @brief Numeruje miasta od nowa, jeśli od poprzedniego numerowania
+ * dodano więcej odcinków drogowych, niż było ich wtedy na mapie.
+ * Błąd alokacji pamięci nie jest zgłaszany - numeracja pozostaje wtedy bez
+ * zmian.
+ * @param[in,out] map       - mapa dróg
+ */
+static void maintainCityOrder(Map *map) {
+    if (map->renumbering &&
+        2 * map->roads_added > map->edges.count + RENUMBER_SLACK) {
+        renumberCities(map);
+    }
+}
+
+/** @brief Przygotowuje wyszukiwanie najkrótszych ścieżek na mapie.
+ * Opróżnia zbiór wykluczonych wierzchołków i uaktualnia indeks punktów
+ * orientacyjnych oraz hierarchię skrótów.
+ * @param[in,out] map       - mapa dróg
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status prepareSearch(Map *map) {
+    CHECK_RET(clearExclusions(map->workspace, map->city_to_int.table.size));
+    if (map->landmarks != NULL) {
+        CHECK_RET(updateLandmarks(map->landmarks, map));
+    }
+    if (map->hierarchy != NULL) {
+        CHECK_RET(updateContractionHierarchy(map->hierarchy, map));
+    }
+    return true;
+}
 
+/** @brief Wyszukuje najkrótszą ścieżkę między wierzchołkami A i B.
+ * Jeśli mapa ma aktualną hierarchię skrótów, odpowiada za jej pomocą.
+ * W przeciwnym razie, jeśli mapa ma indeks punktów orientacyjnych, prowadzi
+ * wyszukiwanie A* z A, a jeśli nie ma - wyszukiwanie z obu końców.
+ * @param[in,out] map       - mapa dróg, przygotowana przez @ref prepareSearch
+ * @param[in] A             - wierzchołek początkowy
+ * @param[in] B             - wierzchołek końcowy
+ * @param[out] d            - długość najkrótszej ścieżki
+ * @param[out] w            - rok najdawniej zbudowanego odcinka
+ * @param[in] fixing        - czy bezpośrednia droga z A do B jest zabroniona
+ * @return Wynik @ref shortestPaths.
+ */
+static Status searchPath(Map *map, int A, int B, uint64_t *d, int *w,
+                         bool fixing) {
+    if (map->hierarchy != NULL && !fixing) {
+        bool answered;
+        Status ret = contractionShortestPaths(map->hierarchy, map->workspace,
+                                              A, B, d, w, &answered);
+        if (answered) {
+            return ret;
+        }
+    }
+    uint64_t settled = workspaceStats(map->workspace)->settled;
+    Status ret;
+    if (map->delta_stepping != NULL) {
+        ret = shortestPathsParallel(map, map->workspace, map->delta_stepping,
+                                    A, B, d, w, fixing);
+    } else if (map->landmarks != NULL) {
+        ret = shortestPaths(map, map->workspace, A, B, d, w, fixing);
+    } else {
+        ret = shortestPathsBidirectional(map, map->workspace, A, B, d, w,
+                                         fixing);
+    }
+    if (map->hierarchy != NULL) {
+        contractionFallbackWork(
+            map->hierarchy,
+            workspaceStats(map->workspace)->settled - settled);
+    }
+    return ret;
+}
+
+/** @brief Znajduje najkrótszą ścieżkę między wierzchołkami A i B.
+ * Jeśli mapa ma pamięć podręczną ścieżek, najpierw szuka w niej wyniku, a po
+ * udanym wyszukiwaniu go zapamiętuje. Nieudane wyszukiwania (np. gdy
+ * najlepsza ścieżka nie jest jednoznaczna) nie są zapamiętywane.
+ * @param[in,out] map       - mapa dróg, przygotowana przez @ref prepareSearch
+ * @param[in] A             - wierzchołek początkowy
+ * @param[in] B             - wierzchołek końcowy
+ * @param[out] d            - długość najkrótszej ścieżki
+ * @param[out] w            - rok najdawniej zbudowanego odcinka
+ * @param[in] fixing        - czy bezpośrednia droga z A do B jest zabroniona
+ * @return Wynik @ref shortestPaths.
+ */
+static Status findPath(Map *map, int A, int B, uint64_t *d, int *w,
+                       bool fixing) {
+    if (map->path_cache != NULL) {
+        SearchStats *stats = workspaceStats(map->workspace);
+        if (pathCacheGet(map->path_cache, map->workspace, map->version, A, B,
+                         fixing, d, w)) {
+            stats->cache_hits++;
+            return true;
+        }
+        stats->cache_misses++;
+    }
+    Status ret = searchPath(map, A, B, d, w, fixing);
+    if (ret && map->path_cache != NULL) {
+        pathCachePut(map->path_cache, map->workspace, map->version, A, B,
+                     fixing, *d, *w);
+    }
+    return ret;
+}
+
+/** @brief Znajduje najkrótszą ścieżkę z @p A do najbliższego z celów.
+ * Wyszukiwanie prowadzone jest bez hierarchii skrótów, więc jego pracę
+ * dolicza się do kosztu jej nieużywania.
+ * @param[in,out] map       - mapa dróg z przygotowanym zbiorem wykluczonych
+ * wierzchołków
+ * @param[in] A             - wierzchołek początkowy
+ * @param[in] targets       - wierzchołki docelowe
+ * @param[in] count         - liczba wierzchołków docelowych
+ * @param[out] d            - długość najkrótszej ścieżki lub INFINITY
+ * @param[out] w            - rok najdawniej zbudowanego odcinka ścieżki
+ * @param[out] nearest      - indeks najbliższego celu lub -1
+ * @return Wynik @ref shortestPathsToNearest.
+ */
+static Status findNearestPath(Map *map, int A, const int *targets,
+                              size_t count, uint64_t *d, int *w,
+                              int *nearest) {
+    uint64_t settled = workspaceStats(map->workspace)->settled;
+    Status ret = shortestPathsToNearest(map, map->workspace, A, targets, count,
+                                        d, w, nearest);
+    if (map->hierarchy != NULL) {
+        contractionFallbackWork(
+            map->hierarchy,
+            workspaceStats(map->workspace)->settled - settled);
+    }
+    return ret;
+}
+
+/** @brief Wyklucza z wyszukiwania miasta leżące na drodze krajowej.
+ * @param[in] map           - mapa dróg
+ * @param[in] route         - droga krajowa
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status excludeRoute(Map *map, List *route) {
+    CHECK_RET(prepareSearch(map));
+    for (Node *n = route->begin->next; n != route->end; n = n->next) {
+        excludeVertex(map->workspace, n->value);
+    }
+    return true;
+}
+
+/** @brief Tworzy drogę krajową wzdłuż ścieżki wyznaczonej przez ostatnie
+ * wyszukiwanie.
+ * @param[in,out] map       - mapa dróg
+ * @param[in] routeId       - numer nieistniejącej drogi krajowej
+ * @param[in] end           - koniec drogi krajowej; jej początkiem jest
+ * źródło wyszukiwania
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status buildRoute(Map *map, unsigned routeId, int end) {
     Status ret = false;
 
-    bool *visited = NULL;
-    int *prev = NULL;
+    List *path = NULL;
     List *l = newList();
     CHECK_RET(l);
     map->routes[routeId].cities = *l;
     free(l);
 
-    size_t cities_no = map->city_to_int.size;
-    uint64_t d;
-    int w;
-    visited = calloc(cities_no, sizeof(bool));
-    prev = malloc(cities_no * sizeof(int));
-    if (visited == NULL || prev == NULL) {
-        goto FREE_ROUTE;
-    }
-    memset(prev, 0xff, cities_no * sizeof(int));
-    if (shortestPaths(map, id1, id2, visited, prev, &d, &w, false) == false) {
-        goto FREE_ROUTE;
-    }
-    if (d == UINT64_MAX) {
+    path = pathFromPrev(searchPrev(map->workspace), end);
+    if (path == NULL) {
         goto FREE_ROUTE;
     }
 
     l = &map->routes[routeId].cities;
-    if (listInsertAfter(l, l->begin, id2) == false) {
+    if (listInsertAfter(l, l->begin, end) == false) {
         goto FREE_ROUTE;
     }
-    if (appendPath(&map->routesThrough, routeId, l, prev, l->begin) == false) {
+    if (appendPath(&map->edges, routeId, l, path, l->begin) == false) {
         goto FREE_ROUTE;
     }
 
@@ -386,32 +545,127 @@ FREE_ROUTE:
     if (ret == false) {
         deleteList(&map->routes[routeId].cities);
     }
-    free(visited);
-    free(prev);
+    freeList(path);
 
     return ret;
 }
 
+bool newRoute(Map *map, unsigned routeId, const char *city1,
+              const char *city2) {
+    CHECK_RET(map);
+    maintainCityOrder(map);
+    CHECK_RET(possiblyValidRoad(city1, city2));
+    CHECK_RET(1 <= routeId && routeId < ROUTE_MAX);
+    CHECK_RET(map->routes[routeId].cities.begin == NULL);
+    CHECK_RET(map->routes[routeId].cities.end == NULL);
+
+    int *e1 = getCityIndex(&map->city_to_int, city1);
+    CHECK_RET(e1 != NULL);
+    int *e2 = getCityIndex(&map->city_to_int, city2);
+    CHECK_RET(e2 != NULL);
+    int id1 = *e1;
+    int id2 = *e2;
+
+    CHECK_RET(areConnected(map, id1, id2));
+
+    uint64_t d;
+    int w;
+    CHECK_RET(prepareSearch(map));
+    CHECK_RET(findPath(map, id1, id2, &d, &w, false));
+    CHECK_RET(d != UINT64_MAX);
+    return buildRoute(map, routeId, id2);
+}
+
+bool newRoutes(Map *map, const char *hub, size_t count,
+               const unsigned *routeIds, const char *const *cities) {
+    CHECK_RET(map);
+    maintainCityOrder(map);
+    CHECK_RET(validCityName(hub));
+    CHECK_RET(count > 0);
+    int *e = getCityIndex(&map->city_to_int, hub);
+    CHECK_RET(e != NULL);
+    int source = *e;
+
+    Status ret = false;
+    size_t built = 0;
+    int *targets = malloc(count * sizeof(int));
+    bool *unique = malloc(count * sizeof(bool));
+    if (targets == NULL || unique == NULL) {
+        goto FREE;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        unsigned routeId = routeIds[i];
+        if (!possiblyValidRoad(hub, cities[i]) || routeId < 1 ||
+            routeId >= ROUTE_MAX ||
+            map->routes[routeId].cities.begin != NULL) {
+            goto FREE;
+        }
+        for (size_t j = 0; j < i; ++j) {
+            if (routeIds[j] == routeId) {
+                goto FREE;
+            }
+        }
+        int *c = getCityIndex(&map->city_to_int, cities[i]);
+        if (c == NULL) {
+            goto FREE;
+        }
+        targets[i] = *c;
+        if (!areConnected(map, source, targets[i])) {
+            goto FREE;
+        }
+    }
+
+    // Wyszukiwanie prowadzone jest bez hierarchii skrótów, więc jego pracę
+    // dolicza się do kosztu jej nieużywania.
+    uint64_t settled = workspaceStats(map->workspace)->settled;
+    if (!clearExclusions(map->workspace, map->city_to_int.table.size) ||
+        !shortestPathsFrom(map, map->workspace, source, targets, count,
+                           unique)) {
+        goto FREE;
+    }
+    if (map->hierarchy != NULL) {
+        contractionFallbackWork(
+            map->hierarchy,
+            workspaceStats(map->workspace)->settled - settled);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!unique[i]) {
+            goto FREE;
+        }
+    }
+    for (; built < count; ++built) {
+        if (!buildRoute(map, routeIds[built], targets[built])) {
+            goto FREE;
+        }
+    }
+
+    ret = true;
+FREE:
+    if (ret == false) {
+        for (size_t i = 0; i < built; ++i) {
+            removeRoute(map, routeIds[i]);
+        }
+    }
+    free(targets);
+    free(unique);
+    return ret;
+}
+
 Road getRoad(Map *map, int id1, int id2) {
     Road null = {0};
     if (map == NULL || id1 == id2 || id1 < 0 || id2 < 0) {
         return null;
     }
-    int64_t cities_no = map->city_to_int.size;
+    int64_t cities_no = map->city_to_int.table.size;
     if (id1 >= cities_no || id2 >= cities_no) {
         return null;
     }
 
-    Entry edge12 = getDictionary((map->neighbours.arr)[id1], &id2);
-    Entry edge21 = getDictionary((map->neighbours.arr)[id2], &id1);
-
-    if (NOT_FOUND(edge12) || NOT_FOUND(edge21)) {
-        return null;
-    }
-    if (areRoadsConsistent(edge12.val, edge21.val) == false) {
+    Edge *e = getEdge(&map->edges, id1, id2);
+    if (e == NULL) {
         return null;
     }
-    return *(Road *)edge12.val;
+    return (const Road){e->length, e->builtYear, id1, id2};
 }
 
 /** @brief Liczy długość reprezentacji tekstowej drogi krajowej.
@@ -429,16 +683,27 @@ static size_t getRouteDescriptionLength(Map *map, unsigned routeId) {
         int next = node->next->value;
         Road r = getRoad(map, current, next);
 
-        string_length += strlen(map->int_to_city.arr[current]) + 1;
+        string_length += cityNameLength(map->int_to_city.names[current]) + 1;
         string_length += intLength(r.length) + 1;
         string_length += intLength(r.builtYear) + 1;
 
         node = node->next;
     }
-    string_length += strlen(map->int_to_city.arr[node->value]);
+    string_length += cityNameLength(map->int_to_city.names[node->value]);
     return string_length;
 }
 
+/** @brief Dopisuje nazwę miasta do opisu drogi krajowej.
+ * @param[out] ptr      - miejsce w opisie, od którego zapisywana jest nazwa
+ * @param[in] name      - nazwa zapisana w tablicy nazw miast
+ * @return Wskaźnik na pierwszy bajt za nazwą.
+ */
+static char *appendName(char *ptr, const char *name) {
+    size_t length = cityNameLength(name);
+    memcpy(ptr, name, length);
+    return ptr + length;
+}
+
 char const *getRouteDescription(Map *map, unsigned routeId) {
     if (map == NULL || routeId == 0 || routeId >= ROUTE_MAX) {
         char *c = malloc(1);
@@ -472,9 +737,8 @@ char const *getRouteDescription(Map *map, unsigned routeId) {
         int current = node->value;
         int next = node->next->value;
         Road r = getRoad(map, current, next);
-        sprintf(ptr, "%s;%n", (char *)map->int_to_city.arr[current],
-                &bytes_written);
-        ptr += bytes_written;
+        ptr = appendName(ptr, map->int_to_city.names[current]);
+        *ptr++ = ';';
         sprintf(ptr, "%" PRIu64 ";%n", r.length, &bytes_written);
         ptr += bytes_written;
         sprintf(ptr, "%d;%n", r.builtYear, &bytes_written);
@@ -482,87 +746,50 @@ char const *getRouteDescription(Map *map, unsigned routeId) {
 
         node = node->next;
     }
-    sprintf(ptr, "%s%n", (char *)map->int_to_city.arr[node->value],
-            &bytes_written);
-    ptr += bytes_written;
+    ptr = appendName(ptr, map->int_to_city.names[node->value]);
     *ptr = 0;
     return description;
 }
 
 bool extendRoute(Map *map, unsigned routeId, const char *city) {
     CHECK_RET(map);
+    maintainCityOrder(map);
     CHECK_RET(1 <= routeId && routeId < ROUTE_MAX);
     CHECK_RET(validCityName(city));
     CHECK_RET(map->routes[routeId].cities.begin != NULL);
     CHECK_RET(map->routes[routeId].cities.end != NULL);
 
-    Entry e = getDictionary(&map->city_to_int, (void *)city);
-    CHECK_RET(NOT_FOUND(e) == false);
-    int id = decodeCityId(e.val);
+    int *e = getCityIndex(&map->city_to_int, city);
+    CHECK_RET(e != NULL);
+    int id = *e;
 
     List *route = &map->routes[routeId].cities;
-    size_t cities_no = map->city_to_int.size;
-    uint64_t d1, d2;
-    int w1, w2;
-
-    CHECK_RET(id != route->begin->next->value && id != route->end->prev->value);
-
-    Status ret = false;
-    bool *visited1 = NULL;
-    bool *visited2 = NULL;
-    int *prev1 = NULL;
-    int *prev2 = NULL;
-
-    visited1 = calloc(cities_no, sizeof(bool));
-    prev1 = malloc(cities_no * sizeof(int));
-    if (visited1 == NULL || prev1 == NULL) {
-        goto FREE;
-    }
-    memset(prev1, 0xff, cities_no * sizeof(int));
-    for (Node *n = route->begin->next; n != route->end; n = n->next) {
-        visited1[n->value] = true;
-    }
-    visited1[route->begin->next->value] = false;
-    if (shortestPaths(map, id, route->begin->next->value, visited1, prev1, &d1,
-                      &w1, false) == false) {
-        goto FREE;
-    }
-
-    visited2 = calloc(cities_no, sizeof(bool));
-    prev2 = malloc(cities_no * sizeof(int));
-    if (visited2 == NULL || prev2 == NULL) {
-        goto FREE;
-    }
-    // this sets every element to -1
-    memset(prev2, 0xff, cities_no * sizeof(int));
-
-    for (Node *n = route->begin->next; n != route->end; n = n->next) {
-        visited2[n->value] = true;
-    }
-    visited2[route->end->prev->value] = false;
-    if (shortestPaths(map, id, route->end->prev->value, visited2, prev2, &d2,
-                      &w2, false) == false) {
-        goto FREE;
-    }
-    if (d1 == INFINITY && d2 == INFINITY) {
-        goto FREE;
-    }
-    if (d1 < d2 || (d1 == d2 && w1 >= w2)) {
-        if (appendPath(&map->routesThrough, routeId, route, prev1,
-                       route->begin) == false) {
-            goto FREE;
-        }
-    } else if (appendPath(&map->routesThrough, routeId, route, prev2,
-                          route->end) == false) {
-        goto FREE;
+    int ends[2] = {route->begin->next->value, route->end->prev->value};
+    CHECK_RET(id != ends[0] && id != ends[1]);
+    CHECK_RET(areConnected(map, id, ends[0]));
+
+    int nearest;
+    List *path;
+    if (map->route_trees != NULL) {
+        CHECK_RET(routeTreesNearest(map->route_trees, map, routeId, id,
+                                    &nearest, &path));
+    } else {
+        CHECK_RET(excludeRoute(map, route));
+        includeVertex(map->workspace, ends[0]);
+        includeVertex(map->workspace, ends[1]);
+        uint64_t d;
+        int w;
+        CHECK_RET(findNearestPath(map, id, ends, 2, &d, &w, &nearest));
+        CHECK_RET(nearest != -1);
+        path = pathFromPrev(searchPrev(map->workspace), ends[nearest]);
+        CHECK_RET(path);
+    }
+    Status ret = appendPath(&map->edges, routeId, route, path,
+                            nearest == 0 ? route->begin : route->end);
+    freeList(path);
+    if (map->route_trees != NULL) {
+        routeTreesUpdateRoute(map->route_trees, map, routeId);
     }
-
-    ret = true;
-FREE:
-    free(visited1);
-    free(visited2);
-    free(prev1);
-    free(prev2);
     return ret;
 }
 
@@ -577,61 +804,124 @@ static Status extendPathFromPrev(List *route, int *prev, int start, int end) {
     return true;
 }
 
+/** @brief Znajduje objazd z A do B z pominięciem bezpośredniej drogi.
+ * Obszar roboczy mapy korzysta z @ref findPath, a obszary robocze puli
+ * wątków - z wyszukiwania, które jedynie odczytuje mapę.
+ * @param[in,out] map       - mapa dróg, przygotowana przez @ref prepareSearch
+ * @param[in,out] ws        - obszar roboczy ze zbiorem wykluczonych
+ * wierzchołków
+ * @param[in] A             - wierzchołek początkowy
+ * @param[in] B             - wierzchołek końcowy
+ * @param[out] d            - długość najkrótszej ścieżki
+ * @param[out] w            - rok najdawniej zbudowanego odcinka
+ * @return Wynik wyszukiwania.
+ */
+static Status findDetour(Map *map, SearchWorkspace *ws, int A, int B,
+                         uint64_t *d, int *w) {
+    if (ws == map->workspace) {
+        return findPath(map, A, B, d, w, true);
+    }
+    if (map->landmarks != NULL) {
+        return shortestPaths(map, ws, A, B, d, w, true);
+    }
+    return shortestPathsBidirectional(map, ws, A, B, d, w, true);
+}
+
 /** @brief repairRoute naprawia drogę krajową nr. @p routeId po usunięciu drogi.
- * Droga usuwana łączy @p id1 oraz @p id2.
- * @param[in,out] map       - mapa, którą modyfikujemy
+ * Droga usuwana łączy @p id1 oraz @p id2. Jedynie odczytuje mapę, więc
+ * naprawy różnych dróg krajowych mogą przebiegać współbieżnie w różnych
+ * obszarach roboczych.
+ * @param[in] map           - mapa, przygotowana przez @ref prepareSearch
+ * @param[in,out] ws        - obszar roboczy wyszukiwania
  * @param[in] routeId       - numer drogi krajowej, którą naprawiamy
  * @param[in] id1           - początek usuwanej drogi
  * @param[in] id2           - koniec usuwanej drogi
- * @return lista wierzchołków, które należy wstawić pomiędzy @p id1 i @p id2 na
- * strukturze reprezentującej drogę krajową.
+ * @return lista wierzchołków od @p id2 do @p id1 (włącznie), którą należy
+ * wstawić w miejsce usuwanej drogi na strukturze reprezentującej drogę
+ * krajową.
  */
-static List *repairRoute(Map *map, unsigned routeId, int id1, int id2) {
-    const uint64_t infinity = UINT64_MAX;
+static List *repairRoute(Map *map, SearchWorkspace *ws, unsigned routeId,
+                         int id1, int id2) {
     List *cities = &map->routes[routeId].cities;
-    size_t cities_no = map->city_to_int.size;
 
-    bool *visited;
-    int *prev;
     List *ret = NULL;
 
-    visited = calloc(cities_no, sizeof(bool));
-    prev = calloc(cities_no, sizeof(int));
-    if (visited == NULL || prev == NULL) {
-        goto FREE;
-    }
-    for (size_t i = 0; i < cities_no; ++i) {
-        prev[i] = -1;
-    }
+    CHECK_RET(clearExclusions(ws, map->city_to_int.table.size));
     for (Node *n = cities->begin->next; n != cities->end; n = n->next) {
-        visited[n->value] = true;
+        excludeVertex(ws, n->value);
     }
-    visited[id1] = false;
-    visited[id2] = false;
+    includeVertex(ws, id1);
+    includeVertex(ws, id2);
 
     uint64_t d;
     int w;
-    if (shortestPaths(map, id2, id1, visited, prev, &d, &w, true) == false) {
-        goto FREE;
-    }
-    if (d == infinity) {
-        goto FREE;
-    }
+    CHECK_RET(findDetour(map, ws, id2, id1, &d, &w));
+    CHECK_RET(d != INFINITY);
 
     ret = newList();
-    if (ret == NULL) {
-        goto FREE;
+    CHECK_RET(ret);
+    if (extendPathFromPrev(ret, searchPrev(ws), id1, id2) == false ||
+        listInsertAfter(ret, ret->begin, id2) == false) {
+        freeList(ret);
+        return NULL;
     }
-    if (extendPathFromPrev(ret, prev, id1, id2) == false) {
-        deleteList(ret);
-        free(ret);
-        ret = NULL;
-        goto FREE;
+    return ret;
+}
+
+/**
+ * Naprawy dróg krajowych przebiegających przez usuwaną drogę.
+ */
+typedef struct RouteRepairs {
+    /// mapa dróg
+    Map *map;
+    /// numery naprawianych dróg krajowych
+    unsigned *routeIds;
+    /// początek usuwanej drogi
+    int id1;
+    /// koniec usuwanej drogi
+    int id2;
+    /// objazdy wyznaczone przez @ref repairRoute (NULL, jeśli nie wyznaczono)
+    List **detours;
+} RouteRepairs;
+
+/** @brief Wyznacza objazd jednej z naprawianych dróg krajowych.
+ * @param[in,out] arg       - naprawy (@ref RouteRepairs)
+ * @param[in,out] ws        - obszar roboczy wyszukiwania
+ * @param[in] index         - numer naprawianej drogi krajowej w @p arg
+ * @return Status powodzenia naprawy.
+ */
+static Status repairRouteJob(void *arg, SearchWorkspace *ws, size_t index) {
+    RouteRepairs *repairs = arg;
+    repairs->detours[index] =
+        repairRoute(repairs->map, ws, repairs->routeIds[index], repairs->id1,
+                    repairs->id2);
+    return repairs->detours[index] != NULL;
+}
+
+/** @brief Wyznacza objazdy wszystkich naprawianych dróg krajowych.
+ * Jeśli mapa ma pulę wątków, objazdy wyznaczane są współbieżnie - mapa nie
+ * jest przy tym modyfikowana, a wynik nie zależy od przeplotu.
+ * @param[in,out] map       - mapa dróg
+ * @param[in,out] repairs   - naprawy
+ * @param[in] count         - liczba naprawianych dróg krajowych
+ * @return Status powodzenia wszystkich napraw.
+ */
+static Status repairRoutes(Map *map, RouteRepairs *repairs, size_t count) {
+    CHECK_RET(prepareSearch(map));
+    if (map->search_pool == NULL) {
+        for (size_t i = 0; i < count; ++i) {
+            CHECK_RET(repairRouteJob(repairs, map->workspace, i));
+        }
+        return true;
+    }
+    Status ret =
+        runSearchPool(map->search_pool, repairRouteJob, repairs, count);
+    uint64_t settled = map->search_stats.settled;
+    mergePoolStats(&map->search_stats, map->search_pool);
+    if (map->hierarchy != NULL) {
+        contractionFallbackWork(map->hierarchy,
+                                map->search_stats.settled - settled);
     }
-    deleteListNode(ret, ret->end->prev);
-FREE:
-    free(prev);
-    free(visited);
     return ret;
 }
 
@@ -661,52 +951,62 @@ static void vectorDeleteFreeListContent(Vector *vector, bool free_as_list) {
 
 bool removeRoad(Map *map, const char *city1, const char *city2) {
     CHECK_RET(map);
+    maintainCityOrder(map);
     CHECK_RET(possiblyValidRoad(city1, city2));
 
-    Entry e1 = getDictionary(&map->city_to_int, (void *)city1);
-    CHECK_RET(NOT_FOUND(e1) == false);
-    Entry e2 = getDictionary(&map->city_to_int, (void *)city2);
-    CHECK_RET(NOT_FOUND(e2) == false);
+    int *e1 = getCityIndex(&map->city_to_int, city1);
+    CHECK_RET(e1 != NULL);
+    int *e2 = getCityIndex(&map->city_to_int, city2);
+    CHECK_RET(e2 != NULL);
 
-    int id1 = decodeCityId(e1.val);
-    int id2 = decodeCityId(e2.val);
+    int id1 = *e1;
+    int id2 = *e2;
     Road road = getRoad(map, id1, id2);
     if (road.builtYear == 0 || road.start != id1 || road.end != id2) {
         return false;
     }
 
-    Entry e = getDictionary(&map->routesThrough, encodeEdgeAsPtr(id1, id2));
-    CHECK_RET(NOT_FOUND(e) == false);
-    List *routesThrough = e.val;
+    List *routesThrough = edgeRoutes(getEdge(&map->edges, id1, id2));
+    CHECK_RET(routesThrough);
+    size_t count = 0;
+    for (Node *n = routesThrough->begin->next; n != routesThrough->end;
+         n = n->next) {
+        count++;
+    }
     Vector *new_routes = newVector();
+    RouteRepairs repairs = {map, malloc((count + 1) * sizeof(unsigned)), id1,
+                            id2, calloc(count + 1, sizeof(List *))};
     Status ret = false;
 
-    if (new_routes == NULL) {
-        return false;
+    if (new_routes == NULL || repairs.routeIds == NULL ||
+        repairs.detours == NULL) {
+        goto FREE;
     }
+    size_t index = 0;
     for (Node *n = routesThrough->begin->next; n != routesThrough->end;
          n = n->next) {
-        List *l = repairRoute(map, (unsigned)n->value, id1, id2);
-        if (!l || !listInsertBefore(l, l->end, id1) ||
-            !listInsertAfter(l, l->begin, id2)) {
-            goto FREE;
-        }
-        if (vectorAppend(new_routes, l) == false) {
+        repairs.routeIds[index++] = n->value;
+    }
+    if (repairRoutes(map, &repairs, count) == false) {
+        goto FREE;
+    }
+    for (index = 0; index < count; ++index) {
+        if (vectorAppend(new_routes, repairs.detours[index]) == false) {
             goto FREE;
         }
+        repairs.detours[index] = NULL;
     }
-    size_t index = 0;
+    index = 0;
     for (Node *n = routesThrough->begin->next; n != routesThrough->end;
          n = n->next) {
         unsigned routeId = n->value;
-        // uzupełnienie map routesThrough
+        // uzupełnienie list dróg krajowych na odcinkach objazdu
         List *r = &((Route *)new_routes->arr[index])->cities;
         for (Node *n = r->begin->next; n != r->end->prev; n = n->next) {
             int a = n->value;
             int b = n->next->value;
-            Entry e = getDictionary(&map->routesThrough, encodeEdgeAsPtr(a, b));
-            List *l = e.val;
-            if (listInsertAfter(l, l->end, routeId) == false) {
+            List *l = edgeRoutes(getEdge(&map->edges, a, b));
+            if (l == NULL || listInsertAfter(l, l->end, routeId) == false) {
                 size_t rindex = index;
                 for (Node *nn = n; nn != routesThrough->begin; nn = nn->prev) {
                     unsigned routeId = nn->value;
@@ -714,11 +1014,10 @@ bool removeRoad(Map *map, const char *city1, const char *city2) {
                     for (Node *n = r->begin->next; n != r->end; n = n->next) {
                         int a = n->value;
                         int b = n->next->value;
-                        Entry e = getDictionary(&map->routesThrough,
-                                                encodeEdgeAsPtr(a, b));
-                        List *l = e.val;
-                        if (l->end->prev->value == (int)routeId) {
-                            deleteListNode(l, l->end);
+                        Edge *e = getEdge(&map->edges, a, b);
+                        if (e != NULL && e->routes.begin != NULL &&
+                            e->routes.end->prev->value == (int)routeId) {
+                            deleteListNode(&e->routes, e->routes.end);
                         }
                     }
                     rindex -= 1;
@@ -751,13 +1050,38 @@ bool removeRoad(Map *map, const char *city1, const char *city2) {
         index++;
     }
 
-    deleteList(routesThrough);
-    deleteFromDictionary(&map->routesThrough, encodeEdgeAsPtr(id1, id2));
-    deleteFromDictionary(map->neighbours.arr[id1], &id2);
-    deleteFromDictionary(map->neighbours.arr[id2], &id1);
+    removeEdge(&map->edges, id1, id2);
+    map->version++;
+    roadGraphRemoveRoad(map->graph, map, road);
+    // Objazd naprawionej drogi krajowej łączy końce usuniętego odcinka, więc
+    // składowe się nie zmieniły.
+    if (count == 0) {
+        connectivityRemoveRoad(map->connectivity);
+    }
+    if (map->landmarks != NULL) {
+        landmarksRemoveRoad(map->landmarks);
+    }
+    if (map->hierarchy != NULL) {
+        invalidateContractionHierarchy(map->hierarchy);
+    }
+    if (map->hub_labels != NULL) {
+        hubLabelsRemoveRoad(map->hub_labels);
+    }
+    if (map->route_trees != NULL) {
+        routeTreesRemoveRoad(map->route_trees, map, road);
+        for (index = 0; index < count; ++index) {
+            routeTreesUpdateRoute(map->route_trees, map,
+                                  repairs.routeIds[index]);
+        }
+    }
 
     ret = true;
 FREE:
+    for (size_t i = 0; repairs.detours != NULL && i < count; ++i) {
+        freeList(repairs.detours[i]);
+    }
+    free(repairs.detours);
+    free(repairs.routeIds);
     vectorDeleteFreeListContent(new_routes, !ret);
     free(new_routes);
     return ret;
@@ -780,16 +1104,106 @@ bool removeRoute(Map *map, unsigned routeId) {
         return false;
     }
     while (n2 != map->routes[routeId].cities.end) {
-        Entry e = getDictionary(&map->routesThrough,
-                                encodeEdgeAsPtr(n1->value, n2->value));
-        if (NOT_FOUND(e)) {
+        Edge *e = getEdge(&map->edges, n1->value, n2->value);
+        if (e == NULL || e->routes.begin == NULL) {
             return false;
         }
-        removeFromList(e.val, routeId);
+        removeFromList(&e->routes, routeId);
         n1 = n1->next;
         n2 = n2->next;
     }
 
     deleteList(&map->routes[routeId].cities);
+    if (map->route_trees != NULL) {
+        routeTreesRemoveRoute(map->route_trees, routeId);
+    }
     return true;
 }
+
+Status enableLandmarks(Map *map, size_t count) {
+    CHECK_RET(map);
+    CHECK_RET(map->landmarks == NULL);
+    map->landmarks = newLandmarks(count);
+    return map->landmarks != NULL;
+}
+
+bool getDistance(Map *map, const char *city1, const char *city2,
+                 uint64_t *length) {
+    CHECK_RET(map);
+    maintainCityOrder(map);
+    CHECK_RET(possiblyValidRoad(city1, city2));
+
+    int *e1 = getCityIndex(&map->city_to_int, city1);
+    CHECK_RET(e1 != NULL);
+    int *e2 = getCityIndex(&map->city_to_int, city2);
+    CHECK_RET(e2 != NULL);
+    CHECK_RET(areConnected(map, *e1, *e2));
+
+    if (map->hub_labels == NULL) {
+        map->hub_labels = newHubLabels();
+        CHECK_RET(map->hub_labels);
+    }
+    CHECK_RET(hubLabelsDistance(map->hub_labels, map, *e1, *e2, length));
+    return *length != INFINITY;
+}
+
+bool areCitiesConnected(Map *map, const char *city1, const char *city2,
+                        bool *connected) {
+    CHECK_RET(map);
+    CHECK_RET(possiblyValidRoad(city1, city2));
+
+    int *e1 = getCityIndex(&map->city_to_int, city1);
+    CHECK_RET(e1 != NULL);
+    int *e2 = getCityIndex(&map->city_to_int, city2);
+    CHECK_RET(e2 != NULL);
+    return connectivityQuery(map->connectivity, map, *e1, *e2, connected);
+}
+
+Status enableContractionHierarchy(Map *map) {
+    CHECK_RET(map);
+    CHECK_RET(map->hierarchy == NULL);
+    map->hierarchy = newContractionHierarchy();
+    return map->hierarchy != NULL;
+}
+
+Status enableParallelSearch(Map *map, unsigned threads) {
+    CHECK_RET(map);
+    CHECK_RET(map->delta_stepping == NULL);
+    map->delta_stepping = newDeltaStepping(threads);
+    CHECK_RET(map->delta_stepping);
+    map->search_pool = newSearchPool(threads);
+    return map->search_pool != NULL;
+}
+
+Status enableRouteTrees(Map *map) {
+    CHECK_RET(map);
+    CHECK_RET(map->route_trees == NULL);
+    map->route_trees = newRouteTrees();
+    return map->route_trees != NULL;
+}
+
+Status enableCityRenumbering(Map *map) {
+    CHECK_RET(map);
+    map->renumbering = true;
+    return true;
+}
+
+Status enablePathCache(Map *map, size_t capacity) {
+    CHECK_RET(map);
+    CHECK_RET(map->path_cache == NULL);
+    map->path_cache = newPathCache(capacity);
+    return map->path_cache != NULL;
+}
+
+Status selectPriorityQueue(Map *map, QueueKind kind) {
+    CHECK_RET(map);
+    if (map->search_pool != NULL) {
+        CHECK_RET(selectPoolQueue(map->search_pool, kind));
+    }
+    return selectSearchQueue(map->workspace, kind);
+}
+
+SearchStats getSearchStats(Map *map) {
+    mergeSearchStats(&map->search_stats, map->workspace);
+    return map->search_stats;
+}
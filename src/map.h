@@ -11,6 +11,7 @@
 #define __MAP_H__
 
 #include "map_struct.h"
+#include "priority_queue.h"
 #include <stdbool.h>
 
 /**
@@ -83,6 +84,24 @@ bool repairRoad(Map *map, const char *city1, const char *city2, int repairYear);
  */
 bool newRoute(Map *map, unsigned routeId, const char *city1, const char *city2);
 
+/** @brief Tworzy drogi krajowe łączące miasto @p hub z podanymi miastami.
+ * Każda z dróg jest taka, jaką utworzyłoby wywołanie @ref newRoute, ale
+ * wszystkie wyznaczane są jednym wyszukiwaniem z miasta @p hub. Drogi są
+ * tworzone wszystkie albo żadna.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] hub        – wskaźnik na napis reprezentujący nazwę wspólnego
+ * początku dróg;
+ * @param[in] count      – liczba tworzonych dróg krajowych;
+ * @param[in] routeIds   – numery dróg krajowych;
+ * @param[in] cities     – nazwy miast, w których kończą się kolejne drogi.
+ * @return Wartość @p true, jeśli wszystkie drogi krajowe zostały utworzone.
+ * Wartość @p false, jeśli dla którejś z dróg wystąpiłby błąd w @ref newRoute,
+ * numery dróg się powtarzają lub nie udało się zaalokować pamięci - żadna
+ * droga nie zostaje wtedy utworzona.
+ */
+bool newRoutes(Map *map, const char *hub, size_t count,
+               const unsigned *routeIds, const char *const *cities);
+
 /** @brief Wydłuża drogę krajową do podanego miasta.
  * Dodaje do drogi krajowej nowe odcinki dróg do podanego miasta w taki sposób,
  * aby nowy fragment drogi krajowej był najkrótszy. Jeśli jest więcej niż jeden
@@ -185,4 +204,125 @@ Road getRoadFromName(Map *map, char *city1, char *city2);
  */
 bool removeRoute(Map *map, unsigned routeId);
 
+/** @brief Wyznacza długość najkrótszej drogi pomiędzy miastami.
+ * Korzysta z etykiet węzłowych, budowanych po serii zapytań, uaktualnianych
+ * przy dodawaniu odcinków drogowych i budowanych od nowa w ten sam sposób po
+ * usunięciu odcinka.
+ * @param[in,out] map       - mapa dróg
+ * @param[in] city1         - nazwa pierwszego z miast
+ * @param[in] city2         - nazwa drugiego z miast
+ * @param[out] length       - długość najkrótszej drogi
+ * @return Wartość @p false, jeśli któreś z miast nie istnieje, nazwy są
+ * niepoprawne lub identyczne, miasta nie są połączone lub nastąpił błąd
+ * alokacji pamięci, @p true wpp.
+ */
+bool getDistance(Map *map, const char *city1, const char *city2,
+                 uint64_t *length);
+
+/** @brief Sprawdza, czy między miastami istnieje droga.
+ * Korzysta ze spójnych składowych mapy, więc nie prowadzi wyszukiwania.
+ * @param[in,out] map       - mapa dróg
+ * @param[in] city1         - nazwa pierwszego z miast
+ * @param[in] city2         - nazwa drugiego z miast
+ * @param[out] connected    - tutaj zapisywane jest, czy miasta są połączone
+ * @return Wartość @p false, jeśli któreś z miast nie istnieje, nazwy są
+ * niepoprawne lub identyczne lub nastąpił błąd alokacji pamięci, @p true
+ * wpp.
+ */
+bool areCitiesConnected(Map *map, const char *city1, const char *city2,
+                        bool *connected);
+
+/** @brief Włącza indeks punktów orientacyjnych.
+ * Wyszukiwania najkrótszych ścieżek są wówczas kierowane do celu dolnymi
+ * ograniczeniami odległości (wyszukiwanie A*). Indeks jest budowany przy
+ * pierwszym wyszukiwaniu i uaktualniany przy zmianach sieci dróg.
+ * @param[in,out] map       - mapa dróg
+ * @param[in] count         - liczba punktów orientacyjnych
+ * @return @p false jeśli nastąpił błąd alokacji pamięci, indeks był już
+ * włączony lub @p count jest równe 0, @p true wpp.
+ */
+Status enableLandmarks(Map *map, size_t count);
+
+/** @brief Włącza hierarchię skrótów.
+ * Wyszukiwania najkrótszych ścieżek przeglądają wówczas jedynie niewielką
+ * część mapy. Hierarchia jest budowana przy wyszukiwaniu, gdy zwykłe
+ * wyszukiwania wykonały pracę porównywalną z kosztem budowy, i budowana od
+ * nowa w ten sam sposób po dodaniu lub usunięciu odcinka drogowego.
+ * @param[in,out] map       - mapa dróg
+ * @return @p false jeśli nastąpił błąd alokacji pamięci lub hierarchia była
+ * już włączona, @p true wpp.
+ */
+Status enableContractionHierarchy(Map *map);
+
+/** @brief Włącza równoległe wyszukiwania najkrótszych ścieżek.
+ * Wyszukiwania, których nie obsłuży hierarchia skrótów, są wówczas
+ * prowadzone metodą delta-stepping przez pulę wątków, a objazdy dróg
+ * krajowych naprawianych przez @ref removeRoad wyznaczane są współbieżnie
+ * przez drugą pulę. Wyniki są takie same jak wyszukiwań jednowątkowych.
+ * @param[in,out] map       - mapa dróg
+ * @param[in] threads       - liczba wątków wyszukiwania
+ * @return @p false jeśli nastąpił błąd alokacji pamięci lub uruchamiania
+ * wątków, wyszukiwania równoległe były już włączone lub @p threads jest równe
+ * 0, @p true wpp.
+ */
+Status enableParallelSearch(Map *map, unsigned threads);
+
+/** @brief Wybiera implementację kolejki priorytetowej wyszukiwań
+ * najkrótszych ścieżek.
+ * @param[in,out] map       - mapa dróg
+ * @param[in] kind          - implementacja kolejki
+ * @return @p false jeśli nastąpił błąd alokacji pamięci, @p true wpp.
+ */
+Status selectPriorityQueue(Map *map, QueueKind kind);
+
+/** @brief Włącza pamięć podręczną drzew najkrótszych ścieżek z końców dróg
+ * krajowych.
+ * Przedłużenie drogi krajowej (@ref extendRoute) odczytuje wtedy ścieżkę
+ * z drzew jej końców, budowanych przy pierwszym przedłużeniu i poprawianych
+ * przyrostowo przy zmianach mapy. Wyniki są takie same jak bez drzew.
+ * @param[in,out] map       - mapa dróg
+ * @return @p false jeśli nastąpił błąd alokacji pamięci lub drzewa były już
+ * włączone, @p true wpp.
+ */
+Status enableRouteTrees(Map *map);
+
+/** @brief Włącza pamięć podręczną wyników wyszukiwań najkrótszych ścieżek.
+ * Powtórzone zapytanie o ścieżkę między tymi samymi miastami, z tym samym
+ * zbiorem wykluczonych miast, odczytuje wynik bez wyszukiwania, dopóki nie
+ * zmienią się odcinki drogowe mapy. Wyniki są takie same jak bez pamięci
+ * podręcznej.
+ * @param[in,out] map       - mapa dróg
+ * @param[in] capacity      - maksymalna liczba zapamiętanych wyników
+ * @return @p false jeśli nastąpił błąd alokacji pamięci, @p capacity jest
+ * równe 0 lub pamięć podręczna była już włączona, @p true wpp.
+ */
+Status enablePathCache(Map *map, size_t capacity);
+
+/** @brief Numeruje miasta od nowa w kolejności przeszukiwania wszerz.
+ * Sąsiednie miasta otrzymują bliskie numery, więc wyszukiwania odwołują się
+ * do bliskich sobie miejsc w pamięci. Nazwy miast, drogi krajowe i wyniki
+ * poleceń nie zmieniają się; indeksy odległości są budowane od nowa przy
+ * następnym użyciu.
+ * @param[in,out] map       - mapa dróg
+ * @return @p false jeśli nastąpił błąd alokacji pamięci (numeracja pozostaje
+ * wtedy bez zmian), @p true wpp.
+ */
+Status renumberCities(Map *map);
+
+/** @brief Włącza numerowanie miast od nowa w miarę rozbudowy mapy.
+ * Przed wyszukiwaniem miasta są numerowane od nowa (@ref renumberCities),
+ * jeśli od poprzedniego numerowania liczba odcinków drogowych co najmniej
+ * się podwoiła.
+ * @param[in,out] map       - mapa dróg
+ * @return @p false jeśli @p map jest NULL, @p true wpp.
+ */
+Status enableCityRenumbering(Map *map);
+
+/** @brief Zwraca łączne liczniki pracy wykonanej przez wyszukiwania
+ * najkrótszych ścieżek na mapie.
+ * @param[in,out] map       - mapa, której liczniki odczytujemy
+ * @return Liczniki wyszukiwań.
+ */
+SearchStats getSearchStats(Map *map);
+
 #endif /* __MAP_H__ */
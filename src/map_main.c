@@ -2,6 +2,7 @@
 #define _XOPEN_SOURCE 700
 
 #include <errno.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -10,6 +11,76 @@
 #include "map_text_interface.h"
 #include "parser.h"
 
+/// Opcja włączająca indeks punktów orientacyjnych, np. --landmarks=8.
+#define LANDMARKS_OPTION "--landmarks="
+
+/// Największa liczba punktów orientacyjnych, którą można podać w opcji.
+#define MAX_LANDMARKS 64
+
+/// Opcja włączająca hierarchię skrótów.
+#define CONTRACTION_OPTION "--ch"
+
+/// Opcja włączająca równoległe wyszukiwania, np. --threads=4.
+#define THREADS_OPTION "--threads="
+
+/// Największa liczba wątków wyszukiwania, którą można podać w opcji.
+#define MAX_THREADS 256
+
+/// Opcja włączająca drzewa najkrótszych ścieżek z końców dróg krajowych.
+#define ROUTE_TREES_OPTION "--route-trees"
+
+/// Opcja włączająca pamięć podręczną ścieżek, np. --path-cache=1024.
+#define PATH_CACHE_OPTION "--path-cache="
+
+/// Największa pojemność pamięci podręcznej ścieżek, którą można podać w opcji.
+#define MAX_PATH_CACHE (1UL << 20)
+
+/// Opcja włączająca numerowanie miast w kolejności przeszukiwania wszerz.
+#define RENUMBER_OPTION "--renumber"
+
+/// Opcja wybierająca kolejkę priorytetową wyszukiwań, np. --queue=radix.
+#define QUEUE_OPTION "--queue="
+
+/** @brief Odczytuje nazwę implementacji kolejki priorytetowej.
+ * @param[in] name      - nazwa: binary, quaternary lub radix
+ * @param[out] kind     - tutaj zapisywana jest implementacja
+ * @return @p true jeśli nazwa jest poprawna, @p false wpp.
+ */
+static bool parseQueueKind(const char *name, QueueKind *kind) {
+    if (strcmp(name, "binary") == 0) {
+        *kind = BINARY_QUEUE;
+    } else if (strcmp(name, "quaternary") == 0) {
+        *kind = QUATERNARY_QUEUE;
+    } else if (strcmp(name, "radix") == 0) {
+        *kind = RADIX_QUEUE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/** @brief Odczytuje dodatnią liczbę podaną jako wartość opcji.
+ * @param[in] value     - wartość opcji
+ * @param[in] max       - największa dopuszczalna liczba
+ * @param[out] result   - tutaj zapisywana jest odczytana liczba
+ * @return @p true jeśli @p value jest zapisem dziesiętnym liczby z przedziału
+ * [1, @p max], @p false wpp.
+ */
+static bool parseCount(const char *value, unsigned long max,
+                       unsigned long *result) {
+    if (*value < '0' || *value > '9') {
+        return false;
+    }
+    char *end;
+    errno = 0;
+    unsigned long count = strtoul(value, &end, 10);
+    if (errno != 0 || *end != '\0' || count == 0 || count > max) {
+        return false;
+    }
+    *result = count;
+    return true;
+}
+
 static size_t line_no = 0;
 
 static void error(bool condition) {
@@ -18,11 +89,78 @@ static void error(bool condition) {
     }
 }
 
-int main() {
+/** @brief Wypisuje na standardowe wyjście błędów liczniki wyszukiwań.
+ * @param[in] map       - mapa, której liczniki wypisujemy
+ */
+static void printSearchStats(Map *map) {
+    SearchStats stats = getSearchStats(map);
+    fprintf(stderr,
+            "STATS searches=%" PRIu64 " settled=%" PRIu64 " touched=%" PRIu64
+            " cache_hits=%" PRIu64 " cache_misses=%" PRIu64 "\n",
+            stats.searches, stats.settled, stats.touched, stats.cache_hits,
+            stats.cache_misses);
+}
+
+int main(int argc, char *argv[]) {
+    bool print_stats = false;
+    unsigned long landmarks = 0;
+    bool contraction = false;
+    QueueKind queue = DEFAULT_QUEUE_KIND;
+    unsigned long threads = 0;
+    bool route_trees = false;
+    unsigned long path_cache = 0;
+    bool renumber = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--stats") == 0) {
+            print_stats = true;
+        } else if (strcmp(argv[i], CONTRACTION_OPTION) == 0) {
+            contraction = true;
+        } else if (strcmp(argv[i], ROUTE_TREES_OPTION) == 0) {
+            route_trees = true;
+        } else if (strcmp(argv[i], RENUMBER_OPTION) == 0) {
+            renumber = true;
+        } else if (strncmp(argv[i], LANDMARKS_OPTION,
+                           strlen(LANDMARKS_OPTION)) == 0) {
+            if (!parseCount(argv[i] + strlen(LANDMARKS_OPTION), MAX_LANDMARKS,
+                            &landmarks)) {
+                fprintf(stderr, "invalid landmark count: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strncmp(argv[i], THREADS_OPTION, strlen(THREADS_OPTION)) ==
+                   0) {
+            if (!parseCount(argv[i] + strlen(THREADS_OPTION), MAX_THREADS,
+                            &threads)) {
+                fprintf(stderr, "invalid thread count: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strncmp(argv[i], PATH_CACHE_OPTION,
+                           strlen(PATH_CACHE_OPTION)) == 0) {
+            if (!parseCount(argv[i] + strlen(PATH_CACHE_OPTION),
+                            MAX_PATH_CACHE, &path_cache)) {
+                fprintf(stderr, "invalid path cache capacity: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strncmp(argv[i], QUEUE_OPTION, strlen(QUEUE_OPTION)) == 0 &&
+                   !parseQueueKind(argv[i] + strlen(QUEUE_OPTION), &queue)) {
+            fprintf(stderr, "unknown queue: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
     Map *m = newMap();
     if (m == NULL) {
         return 0;
     }
+    if ((landmarks > 0 && !enableLandmarks(m, landmarks)) ||
+        (contraction && !enableContractionHierarchy(m)) ||
+        (threads > 0 && !enableParallelSearch(m, (unsigned)threads)) ||
+        (route_trees && !enableRouteTrees(m)) ||
+        (path_cache > 0 && !enablePathCache(m, path_cache)) ||
+        (renumber && !enableCityRenumbering(m)) ||
+        !selectPriorityQueue(m, queue)) {
+        deleteMap(m);
+        return 0;
+    }
 
     char *line = NULL;
     size_t line_len = 0;
@@ -56,6 +194,15 @@ int main() {
         case OP_REMOVE_ROAD:
             error(!execRemoveRoad(m, op.arg));
             break;
+        case OP_NEW_ROUTES:
+            error(!execNewRoutes(m, op.arg));
+            break;
+        case OP_GET_DISTANCE:
+            error(!execGetDistance(m, op.arg));
+            break;
+        case OP_CONNECTED:
+            error(!execConnected(m, op.arg));
+            break;
         case OP_ERROR:
             error(true);
             break;
@@ -66,6 +213,9 @@ int main() {
         }
     }
     free(line);
+    if (print_stats) {
+        printSearchStats(m);
+    }
     deleteMap(m);
     return 0;
 }
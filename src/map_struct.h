@@ -4,9 +4,10 @@
 #ifndef __MAP_STRUCT_H__
 #define __MAP_STRUCT_H__
 
-#include "dictionary.h"
+#include "city_index.h"
+#include "city_names.h"
+#include "edge_table.h"
 #include "list.h"
-#include "vector.h"
 
 /// Maksymalna liczba dróg krajowych.
 #define ROUTE_MAX 1000
@@ -33,22 +34,84 @@ typedef struct Road {
     int end;
 } Road;
 
+/**
+ * Liczniki pracy wykonanej przez wyszukiwania najkrótszych ścieżek.
+ */
+typedef struct SearchStats {
+    /// Liczba przeprowadzonych wyszukiwań.
+    uint64_t searches;
+    /// Łączna liczba wierzchołków, których etykiety zostały ustalone.
+    uint64_t settled;
+    /// Łączna liczba wierzchołków, do których dotarły wyszukiwania.
+    uint64_t touched;
+    /// Liczba zapytań, na które odpowiedziała pamięć podręczna ścieżek.
+    uint64_t cache_hits;
+    /// Liczba zapytań, których nie było w pamięci podręcznej ścieżek.
+    uint64_t cache_misses;
+} SearchStats;
+
+struct SearchWorkspace;
+struct Landmarks;
+struct ContractionHierarchy;
+struct HubLabels;
+struct DeltaStepping;
+struct SearchPool;
+struct RouteTrees;
+struct PathCache;
+struct Connectivity;
+struct RoadGraph;
+
 /**
  * Struktura przechowująca informację o mapie połączeń.
  */
 typedef struct Map {
     /// Przechowuje wszystkie drogi krajowe.
     Route routes[ROUTE_MAX];
-    /// Każdy z sąsiadów przechowuje Dictionary[int, Road], słownik sąsiadów.
-    Vector neighbours;
-    /// Każdy element przechowuje char*, nazwę miasta o odpowiednim indeksie.
-    Vector int_to_city;
-    /// Słownik Dictionary[char*, int], który służy do uzyskania
-    /// identyfikatora, na podstawie tekstowej nazwy miasta.
-    Dictionary city_to_int;
-    /// Słownik Dictionary[(int, int), List[int]] dla każdej krawędzi
-    /// przechowuje listę dróg krajowych, które przez nią przebiegają.
-    Dictionary routesThrough;
+    /// Nazwy miast o kolejnych indeksach, zapisane w zwartych blokach pamięci.
+    CityNames int_to_city;
+    /// Tablica haszująca, która służy do uzyskania identyfikatora na podstawie
+    /// tekstowej nazwy miasta; nazwy należą do @p int_to_city.
+    CityIndex city_to_int;
+    /// Odcinki drogowe, po jednym rekordzie na odcinek, wraz z listami dróg
+    /// krajowych, które przez nie przebiegają.
+    EdgeTable edges;
+    /// Zwarta reprezentacja odcinków drogowych przeglądana przez
+    /// wyszukiwania; jest wyznaczana z tablicy @p edges.
+    struct RoadGraph *graph;
+    /// Liczniki pracy wykonanej przez wyszukiwania najkrótszych ścieżek
+    /// (bez liczników bieżących obszarów roboczych, zob. getSearchStats).
+    SearchStats search_stats;
+    /// Obszar roboczy wyszukiwań najkrótszych ścieżek.
+    struct SearchWorkspace *workspace;
+    /// Indeks punktów orientacyjnych kierujący wyszukiwania do celu lub NULL,
+    /// jeśli nie jest używany.
+    struct Landmarks *landmarks;
+    /// Hierarchia skrótów przyspieszająca wyszukiwania lub NULL, jeśli nie
+    /// jest używana.
+    struct ContractionHierarchy *hierarchy;
+    /// Etykiety węzłowe wyznaczające odległości między miastami lub NULL,
+    /// jeśli nie pytano jeszcze o odległość.
+    struct HubLabels *hub_labels;
+    /// Pula wątków równoległych wyszukiwań lub NULL, jeśli wyszukiwania są
+    /// jednowątkowe.
+    struct DeltaStepping *delta_stepping;
+    /// Pula wątków wyznaczających współbieżnie objazdy naprawianych dróg
+    /// krajowych lub NULL, jeśli naprawy są wykonywane po kolei.
+    struct SearchPool *search_pool;
+    /// Drzewa najkrótszych ścieżek z końców przedłużanych dróg krajowych lub
+    /// NULL, jeśli nie są używane.
+    struct RouteTrees *route_trees;
+    /// Pamięć podręczna wyników wyszukiwań ścieżek lub NULL, jeśli nie jest
+    /// używana.
+    struct PathCache *path_cache;
+    /// Spójne składowe mapy.
+    struct Connectivity *connectivity;
+    /// Wersja grafu, zwiększana przy każdej zmianie odcinków drogowych.
+    uint64_t version;
+    /// Czy miasta są numerowane od nowa w miarę rozbudowy mapy.
+    bool renumbering;
+    /// Liczba odcinków drogowych dodanych od ostatniego numerowania miast.
+    size_t roads_added;
 } Map;
 
 #endif /* __MAP_STRUCT_H__ */
@@ -3,6 +3,7 @@
  */
 #include "map_text_interface.h"
 #include "utils.h"
+#include <inttypes.h>
 #include <stdio.h>
 
 Status execAddRoad(Map *map, char *arg) {
@@ -75,10 +76,13 @@ Status execGetRouteDescription(Map *map, char *arg) {
  * istnieje.
  */
 static char *nextNthSemicolon(char *ptr, size_t n) {
-    for (size_t i = 0; i < n && (ptr - 1) != NULL; ++i) {
-        ptr = strchr(ptr, ';') + 1;
+    for (size_t i = 0; i < n && ptr != NULL; ++i) {
+        ptr = strchr(ptr, ';');
+        if (ptr != NULL) {
+            ptr++;
+        }
     }
-    return ptr == (void *)1 ? NULL : ptr;
+    return ptr;
 }
 
 Status execNewRouteThrough(Map *map, char *arg) {
@@ -131,8 +135,7 @@ Status execNewRouteThrough(Map *map, char *arg) {
     if (!addCity(map, xx)) {
         return false;
     }
-    Entry e = getDictionary(&map->city_to_int, xx);
-    int id = decodeCityId(e.val);
+    int id = *getCityIndex(&map->city_to_int, xx);
     listInsertAfter(&map->routes[routeId].cities,
                     map->routes[routeId].cities.begin, id);
     ptr = nextNthSemicolon(prev, 3);
@@ -153,13 +156,13 @@ Status execNewRouteThrough(Map *map, char *arg) {
                              map->routes[routeId].cities.end, r.end)) {
             return false;
         }
-        Entry e =
-            getDictionary(&map->routesThrough, encodeEdgeAsPtr(r.start, r.end));
-        if (NOT_FOUND(e)) {
+        Edge *e = getEdge(&map->edges, r.start, r.end);
+        if (e == NULL) {
             return false;
         }
-        List *routesthrough = e.val;
-        if (!listInsertAfter(routesthrough, routesthrough->end, routeId)) {
+        List *routesthrough = edgeRoutes(e);
+        if (routesthrough == NULL ||
+            !listInsertAfter(routesthrough, routesthrough->end, routeId)) {
             return false;
         }
 
@@ -179,6 +182,25 @@ Status execNewRoute(Map *map, char *arg) {
     return newRoute(map, rid, city1, city2);
 }
 
+Status execNewRoutes(Map *map, char *arg) {
+    size_t count = 0;
+    for (char *p = arg; (p = strchr(p, ';')) != NULL; p++) {
+        count++;
+    }
+    count /= 2;
+    unsigned ids[count];
+    const char *cities[count];
+    char *hub = arg;
+    char *ptr = strchr(arg, ';');
+    for (size_t i = 0; i < count; ++i) {
+        *ptr = 0;
+        ids[i] = strtoul(ptr + 1, NULL, 10);
+        cities[i] = strchr(ptr + 1, ';') + 1;
+        ptr = strchr(cities[i], ';');
+    }
+    return newRoutes(map, hub, count, ids, cities);
+}
+
 Status execExtendRoute(Map *map, char *arg) {
     unsigned rid;
     extractRouteId(arg, &rid);
@@ -200,3 +222,27 @@ Status execRemoveRoad(Map *map, char *arg) {
     extractCityName(strchr(arg, ';') + 1, city2);
     return removeRoad(map, city1, city2);
 }
+
+Status execGetDistance(Map *map, char *arg) {
+    size_t len = strlen(arg);
+    char city1[len];
+    char city2[len];
+    extractCityName(arg, city1);
+    extractCityName(strchr(arg, ';') + 1, city2);
+    uint64_t length;
+    CHECK_RET(getDistance(map, city1, city2, &length));
+    printf("%" PRIu64 "\n", length);
+    return true;
+}
+
+Status execConnected(Map *map, char *arg) {
+    size_t len = strlen(arg);
+    char city1[len];
+    char city2[len];
+    extractCityName(arg, city1);
+    extractCityName(strchr(arg, ';') + 1, city2);
+    bool connected;
+    CHECK_RET(areCitiesConnected(map, city1, city2, &connected));
+    printf("%d\n", connected);
+    return true;
+}
@@ -47,6 +47,13 @@ Status execNewRouteThrough(Map *map, char *arg);
  */
 Status execNewRoute(Map *map, char *arg);
 
+/** Dodaje drogi krajowe ze wspólnego miasta do podanych miast.
+ * @param[in,out] map   - mapa, do której dodajemy drogi krajowe
+ * @param[in] arg       - string w formacie wejściowym
+ * @return
+ */
+Status execNewRoutes(Map *map, char *arg);
+
 /** Rozszerza drogę krajową do podanego miasta
  * @param[in,out] map   - mapa, z której drogę krajową rozszerzamy
  * @param[in] arg       - string w formacie wejściowym
@@ -68,4 +75,18 @@ Status execRemoveRoute(Map *map, char *arg);
  */
 Status execRemoveRoad(Map *map, char *arg);
 
+/** Wypisuje długość najkrótszej drogi pomiędzy miastami
+ * @param[in,out] map   - mapa, w której szukamy drogi
+ * @param[in] arg       - string w formacie wejściowym
+ * @return
+ */
+Status execGetDistance(Map *map, char *arg);
+
+/** Wypisuje 1, jeśli między miastami istnieje droga, lub 0 wpp.
+ * @param[in,out] map   - mapa, w której szukamy drogi
+ * @param[in] arg       - string w formacie wejściowym
+ * @return
+ */
+Status execConnected(Map *map, char *arg);
+
 #endif /* __MAP_TEXT_INTERFACE_H__ */
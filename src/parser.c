@@ -1,5 +1,6 @@
 #define _GNU_SOURCE
 #include <errno.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
@@ -43,22 +44,11 @@ static size_t countChar(char *str, char c) {
     return count;
 }
 
-/** @brief Liczy skrót (hasz) stringa zakończonego bajtem zerowym, bądź
- * średnikiem.
- * @param ptr                 - string
- * @return wartość skrótu
- */
-static hash_t hashSemicolonTerminated(void *ptr) {
-    uint8_t *str = ptr;
-    hash_t ret = 1;
-    while (*str && *str != ';') {
-        ret *= *str + 1;
-        str++;
-    }
-    return ret;
+hash_t hashSemicolonTerminated(void *ptr) {
+    return nHashString(ptr, strcspn(ptr, ";"));
 }
 
-static bool cmpSemicolonTerminated(void *ptr1, void *ptr2) {
+bool cmpSemicolonTerminated(void *ptr1, void *ptr2) {
     if (ptr1 == DELETED || ptr2 == DELETED) {
         return false;
     }
@@ -307,6 +297,35 @@ static bool vExtendRoute(char *arg) {
     return extractCityName(strchr(arg, ';') + 1, c);
 }
 
+/** @brief Stwierdza, czy linia wejścia jest składniowo poprawna, jako operacja
+ * newRoutes: nazwa miasta, po której następują pary numer drogi krajowej i
+ * nazwa miasta.
+ * @param[in] arg    - linia wejścia
+ * @return Wartość logiczna poprawności linii wejścia.
+ */
+static bool vNewRoutes(char *arg) {
+    size_t semicolon_count = countChar(arg, ';');
+    if (semicolon_count == 0 || semicolon_count % 2 != 0) {
+        return false;
+    }
+    char *field = arg;
+    for (size_t i = 0; i <= semicolon_count; ++i) {
+        char *end = strchrnul(field, ';');
+        if (i % 2 == 1) {
+            errno = 0;
+            unsigned long id = strtoul(field, NULL, 10);
+            if (!validUnsignedNumeral(field, end - field) || errno != 0 ||
+                id > UINT_MAX) {
+                return false;
+            }
+        } else if (!nValidCityName(field, end - field)) {
+            return false;
+        }
+        field = end + 1;
+    }
+    return true;
+}
+
 static bool vRemoveRoad(char *arg) {
     if (countChar(arg, ';') != 1) {
         return false;
@@ -342,7 +361,12 @@ static void validateArgs(struct Operation *ret) {
     case OP_REMOVE_ROUTE:
         valid = vRemoveRoute(ret->arg);
         break;
+    case OP_NEW_ROUTES:
+        valid = vNewRoutes(ret->arg);
+        break;
     case OP_REMOVE_ROAD:
+    case OP_GET_DISTANCE:
+    case OP_CONNECTED:
         valid = vRemoveRoad(ret->arg);
         break;
     case OP_ERROR:
@@ -400,6 +424,8 @@ struct Operation parse(char *line, size_t length) {
     if (validUnsignedNumeral(line, op_name_length)) {
         ret.arg = line;
         ret.op = OP_NEW_ROUTE_THROUGH;
+    } else if (strcmp(line, "newRoutes") == 0) {
+        ret.op = OP_NEW_ROUTES;
     } else if (strcmp(line, "newRoute") == 0) {
         ret.op = OP_NEW_ROUTE;
     } else if (strcmp(line, "addRoad") == 0) {
@@ -414,6 +440,10 @@ struct Operation parse(char *line, size_t length) {
         ret.op = OP_REMOVE_ROAD;
     } else if (strcmp(line, "removeRoute") == 0) {
         ret.op = OP_REMOVE_ROUTE;
+    } else if (strcmp(line, "getDistance") == 0) {
+        ret.op = OP_GET_DISTANCE;
+    } else if (strcmp(line, "connected") == 0) {
+        ret.op = OP_CONNECTED;
     }
     *first_semicolon = ';';
     validateArgs(&ret);
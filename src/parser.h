@@ -4,6 +4,7 @@
 #ifndef __PARSER_H__
 #define __PARSER_H__
 
+#include "dictionary.h"
 #include "status.h"
 #include <ctype.h>
 
@@ -21,7 +22,10 @@ enum opcode {
     OP_NEW_ROUTE_THROUGH,
     OP_REMOVE_ROAD,
     OP_REMOVE_ROUTE,
-    OP_EXTEND_ROUTE
+    OP_EXTEND_ROUTE,
+    OP_GET_DISTANCE,
+    OP_NEW_ROUTES,
+    OP_CONNECTED
 };
 
 /** @brief Struktura reprezentująca typ operacji.
@@ -33,6 +37,22 @@ struct Operation {
     char *arg;
 };
 
+/** @brief Liczy skrót (hasz) stringa zakończonego bajtem zerowym, bądź
+ * średnikiem.
+ * Używany w słowniku wykrywającym powtórzenia miast w opisie drogi krajowej.
+ * @param[in] ptr       - string
+ * @return wartość skrótu
+ */
+hash_t hashSemicolonTerminated(void *ptr);
+
+/** @brief Porównuje stringi zakończone bajtem zerowym, bądź średnikiem.
+ * @param[in] ptr1      - pierwszy string
+ * @param[in] ptr2      - drugi string
+ * @return Wartość @p true, jeśli żaden ze stringów nie jest usunięty ze
+ * słownika (wartość DELETED) i oba są równe, @p false wpp.
+ */
+bool cmpSemicolonTerminated(void *ptr1, void *ptr2);
+
 /** @brief Parsuje linię wejścia, zwracając typ operacji oraz skojarzony
  * argument.
  * @param[in] line      - linia wejścia
@@ -0,0 +1,290 @@
+#include <string.h>
+
+#include "path_cache.h"
+#include "utils.h"
+
+#define INFINITY UINT64_MAX
+
+/**
+ * Klucz zapamiętanego wyniku. Zbiór wykluczonych wierzchołków jest
+ * reprezentowany skrótem i liczbą elementów, a przy trafieniu porównywany
+ * dokładnie.
+ */
+typedef struct CacheKey {
+    /// wierzchołek początkowy
+    int A;
+    /// wierzchołek końcowy
+    int B;
+    /// czy bezpośrednia droga z A do B była zabroniona
+    bool fixing;
+    /// liczba wykluczonych wierzchołków
+    size_t excluded_no;
+    /// skrót zbioru wykluczonych wierzchołków (zob. @ref exclusionSignature)
+    hash_t excluded_hash;
+} CacheKey;
+
+/**
+ * Zapamiętany wynik wyszukiwania, element listy ostatnio używanych.
+ */
+typedef struct CacheEntry {
+    /// klucz wyniku; słownik wskazuje na to pole
+    CacheKey key;
+    /// długość najkrótszej ścieżki lub INFINITY
+    uint64_t d;
+    /// rok najdawniej zbudowanego odcinka
+    int w;
+    /// kolejne wierzchołki ścieżki od A do B lub NULL, jeśli jej nie ma
+    int *path;
+    /// liczba wierzchołków ścieżki
+    size_t path_len;
+    /// posortowane wykluczone wierzchołki
+    int *excluded;
+    /// poprzedni (używany później) element listy
+    struct CacheEntry *prev;
+    /// następny (używany wcześniej) element listy
+    struct CacheEntry *next;
+} CacheEntry;
+
+struct PathCache {
+    /// maksymalna liczba zapamiętanych wyników
+    size_t capacity;
+    /// tablica wszystkich elementów
+    CacheEntry *entries;
+    /// liczba elementów, które były kiedykolwiek używane
+    size_t used;
+    /// wartownik listy zapamiętanych wyników, od ostatnio używanego
+    CacheEntry lru;
+    /// słownik Dictionary[CacheKey *, CacheEntry *]
+    Dictionary *index;
+    /// wersja grafu, dla której zapamiętano wyniki
+    uint64_t version;
+};
+
+/** @brief Funkcja skrótu dla kluczy wyników.
+ * @param[in] p         - klucz
+ * @return Skrót (hasz) klucza.
+ */
+static hash_t hashKey(void *p) {
+    CacheKey *key = p;
+    hash_t h = hashMix(((uint64_t)(unsigned)key->A << 32) | (unsigned)key->B);
+    return hashMix(h ^ key->excluded_hash ^ key->excluded_no ^ key->fixing);
+}
+
+/** @brief Porównuje klucze wyników.
+ * @param[in] p1        - pierwszy klucz lub DELETED
+ * @param[in] p2        - drugi klucz
+ * @return @p true jeśli klucze są równe.
+ */
+static bool equalKeys(void *p1, void *p2) {
+    if (p1 == DELETED || p2 == DELETED) {
+        return false;
+    }
+    CacheKey *k1 = p1;
+    CacheKey *k2 = p2;
+    return k1->A == k2->A && k1->B == k2->B && k1->fixing == k2->fixing &&
+           k1->excluded_no == k2->excluded_no &&
+           k1->excluded_hash == k2->excluded_hash;
+}
+
+/** @brief Porównuje liczby całkowite dla qsort.
+ * @param[in] a         - wskaźnik na pierwszą liczbę
+ * @param[in] b         - wskaźnik na drugą liczbę
+ * @return Liczba ujemna, zero lub dodatnia, gdy pierwsza liczba jest
+ * odpowiednio mniejsza, równa lub większa od drugiej.
+ */
+static int cmpInts(const void *a, const void *b) {
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/** @brief Odłącza element od listy ostatnio używanych.
+ * @param[in,out] e     - element listy
+ */
+static void unlinkEntry(CacheEntry *e) {
+    e->prev->next = e->next;
+    e->next->prev = e->prev;
+}
+
+/** @brief Wstawia element na początek listy ostatnio używanych.
+ * @param[in,out] cache - pamięć podręczna
+ * @param[in,out] e     - element spoza listy
+ */
+static void pushEntry(PathCache *cache, CacheEntry *e) {
+    e->prev = &cache->lru;
+    e->next = cache->lru.next;
+    e->next->prev = e;
+    cache->lru.next = e;
+}
+
+/** @brief Zwalnia ścieżkę i zbiór wykluczonych wierzchołków elementu.
+ * @param[in,out] e     - element
+ */
+static void clearEntry(CacheEntry *e) {
+    free(e->path);
+    free(e->excluded);
+    e->path = NULL;
+    e->excluded = NULL;
+}
+
+/** @brief Zapomina wszystkie wyniki, jeśli zmieniła się wersja grafu.
+ * @param[in,out] cache - pamięć podręczna
+ * @param[in] version   - bieżąca wersja grafu
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status checkVersion(PathCache *cache, uint64_t version) {
+    if (cache->version == version && cache->index != NULL) {
+        return true;
+    }
+    for (size_t i = 0; i < cache->used; ++i) {
+        clearEntry(&cache->entries[i]);
+    }
+    cache->used = 0;
+    cache->lru.prev = cache->lru.next = &cache->lru;
+    deleteDictionary(cache->index);
+    free(cache->index);
+    cache->index = newDictionary(hashKey, equalKeys, empty, empty);
+    CHECK_RET(cache->index);
+    cache->version = version;
+    return true;
+}
+
+PathCache *newPathCache(size_t capacity) {
+    CHECK_RET(capacity > 0);
+    PathCache *cache = calloc(1, sizeof(PathCache));
+    CHECK_RET(cache);
+    cache->capacity = capacity;
+    cache->lru.prev = cache->lru.next = &cache->lru;
+    cache->entries = calloc(capacity, sizeof(CacheEntry));
+    if (cache->entries == NULL || !checkVersion(cache, 0)) {
+        deletePathCache(cache);
+        return NULL;
+    }
+    return cache;
+}
+
+void deletePathCache(PathCache *cache) {
+    if (cache == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < cache->used; ++i) {
+        clearEntry(&cache->entries[i]);
+    }
+    deleteDictionary(cache->index);
+    free(cache->index);
+    free(cache->entries);
+    free(cache);
+}
+
+/** @brief Wypełnia klucz wyniku wyszukiwania.
+ * @param[out] key      - klucz
+ * @param[in] ws        - obszar roboczy ze zbiorem wykluczonych wierzchołków
+ * @param[in] A         - wierzchołek początkowy
+ * @param[in] B         - wierzchołek końcowy
+ * @param[in] fixing    - czy bezpośrednia droga z A do B jest zabroniona
+ */
+static void makeKey(CacheKey *key, const SearchWorkspace *ws, int A, int B,
+                    bool fixing) {
+    *key = (const CacheKey){A, B, fixing, 0, 0};
+    key->excluded_no = exclusionSignature(ws, &key->excluded_hash);
+}
+
+bool pathCacheGet(PathCache *cache, SearchWorkspace *ws, uint64_t version,
+                  int A, int B, bool fixing, uint64_t *d, int *w) {
+    if (!checkVersion(cache, version)) {
+        return false;
+    }
+    CacheKey key;
+    makeKey(&key, ws, A, B, fixing);
+    Entry found = getDictionary(cache->index, &key);
+    if (NOT_FOUND(found)) {
+        return false;
+    }
+    CacheEntry *e = found.val;
+    for (size_t i = 0; i < key.excluded_no; ++i) {
+        if (!isVertexExcluded(ws, e->excluded[i])) {
+            return false;
+        }
+    }
+    unlinkEntry(e);
+    pushEntry(cache, e);
+    restoreSearchPath(ws, e->path, e->path_len);
+    *d = e->d;
+    *w = e->w;
+    return true;
+}
+
+/** @brief Zapisuje w elemencie ścieżkę i zbiór wykluczonych wierzchołków.
+ * @param[in,out] e     - element z wypełnionym kluczem
+ * @param[in,out] ws    - obszar roboczy, w którym przeprowadzono wyszukiwanie
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status fillEntry(CacheEntry *e, SearchWorkspace *ws) {
+    const int *list;
+    size_t count = excludedVertices(ws, &list);
+    CHECK_RET(count != SIZE_MAX);
+    if (e->key.excluded_no > 0) {
+        e->excluded = malloc(count * sizeof(int));
+        CHECK_RET(e->excluded);
+        size_t n = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (isVertexExcluded(ws, list[i])) {
+                e->excluded[n++] = list[i];
+            }
+        }
+        qsort(e->excluded, n, sizeof(int), cmpInts);
+        size_t distinct = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (distinct == 0 || e->excluded[distinct - 1] != e->excluded[i]) {
+                e->excluded[distinct++] = e->excluded[i];
+            }
+        }
+        CHECK_RET(distinct == e->key.excluded_no);
+    }
+
+    e->path_len = 0;
+    if (e->d == INFINITY) {
+        return true;
+    }
+    const int *prev = searchPrev(ws);
+    for (int v = e->key.B; v != -1; v = prev[v]) {
+        e->path_len++;
+    }
+    e->path = malloc(e->path_len * sizeof(int));
+    CHECK_RET(e->path);
+    size_t i = e->path_len;
+    for (int v = e->key.B; v != -1; v = prev[v]) {
+        e->path[--i] = v;
+    }
+    return e->path[0] == e->key.A;
+}
+
+void pathCachePut(PathCache *cache, SearchWorkspace *ws, uint64_t version,
+                  int A, int B, bool fixing, uint64_t d, int w) {
+    if (!checkVersion(cache, version)) {
+        return;
+    }
+    CacheEntry *e;
+    if (cache->used < cache->capacity) {
+        e = &cache->entries[cache->used++];
+    } else {
+        e = cache->lru.prev;
+        unlinkEntry(e);
+        deleteFromDictionary(cache->index, &e->key);
+        clearEntry(e);
+    }
+    makeKey(&e->key, ws, A, B, fixing);
+    e->d = d;
+    e->w = w;
+    // Nieużywany element trafia na koniec listy, skąd zostanie wzięty jako
+    // pierwszy.
+    if (!fillEntry(e, ws) || !insertDictionary(cache->index, &e->key, e)) {
+        clearEntry(e);
+        e->prev = cache->lru.prev;
+        e->next = &cache->lru;
+        e->prev->next = e;
+        cache->lru.prev = e;
+        return;
+    }
+    pushEntry(cache, e);
+}
@@ -0,0 +1,63 @@
+/** @file
+ * Pamięć podręczna wyników wyszukiwań najkrótszych ścieżek.
+ */
+#ifndef __PATH_CACHE_H__
+#define __PATH_CACHE_H__
+
+#include "shortest_paths.h"
+
+/**
+ * Pamięć podręczna ograniczonej liczby wyników wyszukiwań, usuwająca najdawniej
+ * używane. Wynik jest identyfikowany końcami ścieżki, zakazem bezpośredniej
+ * drogi i zbiorem wykluczonych wierzchołków, i jest ważny tylko dla wersji
+ * grafu, w której go zapamiętano.
+ */
+typedef struct PathCache PathCache;
+
+/** @brief Tworzy pustą pamięć podręczną.
+ * @param[in] capacity      - maksymalna liczba zapamiętanych wyników,
+ * co najmniej 1
+ * @return Wskaźnik na pamięć podręczną lub NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+PathCache *newPathCache(size_t capacity);
+
+/** @brief Zwalnia pamięć podręczną.
+ * @param[in,out] cache     - pamięć podręczna do zwolnienia
+ */
+void deletePathCache(PathCache *cache);
+
+/** @brief Szuka wyniku wyszukiwania z @p A do @p B.
+ * Jeśli wynik jest zapamiętany, odtwarza w obszarze roboczym tablicę przodków
+ * (zob. @ref searchPrev) tak, jakby wyszukiwanie zostało przeprowadzone.
+ * @param[in,out] cache     - pamięć podręczna
+ * @param[in,out] ws        - obszar roboczy ze zbiorem wykluczonych
+ * wierzchołków, przygotowany przez @ref clearExclusions
+ * @param[in] version       - bieżąca wersja grafu
+ * @param[in] A             - wierzchołek początkowy
+ * @param[in] B             - wierzchołek końcowy
+ * @param[in] fixing        - czy bezpośrednia droga z A do B jest zabroniona
+ * @param[out] d            - długość najkrótszej ścieżki lub INFINITY
+ * @param[out] w            - rok najdawniej zbudowanego odcinka
+ * @return @p true jeśli wynik był zapamiętany, @p false wpp.
+ */
+bool pathCacheGet(PathCache *cache, SearchWorkspace *ws, uint64_t version,
+                  int A, int B, bool fixing, uint64_t *d, int *w);
+
+/** @brief Zapamiętuje wynik udanego wyszukiwania z @p A do @p B.
+ * Ścieżka odczytywana jest z tablicy przodków obszaru roboczego. Jeśli nie
+ * uda się zaalokować pamięci, wynik nie jest zapamiętywany.
+ * @param[in,out] cache     - pamięć podręczna
+ * @param[in,out] ws        - obszar roboczy, w którym przeprowadzono
+ * wyszukiwanie
+ * @param[in] version       - bieżąca wersja grafu
+ * @param[in] A             - wierzchołek początkowy
+ * @param[in] B             - wierzchołek końcowy
+ * @param[in] fixing        - czy bezpośrednia droga z A do B była zabroniona
+ * @param[in] d             - długość najkrótszej ścieżki lub INFINITY
+ * @param[in] w             - rok najdawniej zbudowanego odcinka
+ */
+void pathCachePut(PathCache *cache, SearchWorkspace *ws, uint64_t version,
+                  int A, int B, bool fixing, uint64_t d, int w);
+
+#endif /* __PATH_CACHE_H__ */
@@ -0,0 +1,151 @@
+#include <assert.h>
+#include <string.h>
+
+#include "priority_queue.h"
+
+/// Początkowa pojemność kolejki.
+#define QUEUE_INITIAL_CAPACITY 16
+
+PriorityQueue newPriorityQueue(QueueKind kind) {
+    PriorityQueue q = {0};
+    q.kind = kind;
+    q.free_list = -1;
+    memset(q.buckets, 0xff, sizeof(q.buckets));
+    q.heap =
+        newDaryHeap(QUEUE_INITIAL_CAPACITY, kind == QUATERNARY_QUEUE ? 2 : 1);
+    return q;
+}
+
+void deletePriorityQueue(PriorityQueue *q) {
+    deleteHeap(&q->heap);
+    free(q->pool);
+    free(q->next);
+    q->pool = NULL;
+    q->next = NULL;
+    q->pool_capacity = q->pool_size = q->size = 0;
+}
+
+void clearPriorityQueue(PriorityQueue *q) {
+    q->size = 0;
+    q->heap.size = 0;
+    q->last = 0;
+    if (q->pool_size > 0) {
+        // ustawia wszystkie bajty na 0xff, czyli kubełki na puste
+        memset(q->buckets, 0xff, sizeof(q->buckets));
+        q->pool_size = 0;
+        q->free_list = -1;
+    }
+}
+
+/** @brief Wyznacza kubełek kopca pozycyjnego dla priorytetu.
+ * @param[in] q         - kolejka
+ * @param[in] key       - priorytet większy od @p q->last
+ * @return Numer kubełka - pozycja najstarszego bitu, na którym @p key różni się
+ * od @p q->last.
+ */
+static int radixBucket(const PriorityQueue *q, uint64_t key) {
+    return RADIX_BUCKETS - 1 - __builtin_clzll(key ^ q->last);
+}
+
+/** @brief Dołącza węzeł do listy kubełka.
+ * @param[in,out] q     - kolejka
+ * @param[in] node      - węzeł
+ */
+static void linkNode(PriorityQueue *q, int node) {
+    int b = radixBucket(q, q->pool[node].key);
+    q->next[node] = q->buckets[b];
+    q->buckets[b] = node;
+}
+
+/** @brief Wstawia element do kopca pozycyjnego.
+ * @param[in,out] q     - kolejka
+ * @param[in] e         - element do wstawienia
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status pushRadix(PriorityQueue *q, HeapEntry e) {
+    assert(e.key >= q->last);
+    // przenoszenie elementów do kopca przy usuwaniu nie może alokować pamięci
+    CHECK_RET(reserveHeap(&q->heap, q->size + 1));
+    if (e.key == q->last) {
+        return pushHeap(&q->heap, e);
+    }
+    int node = q->free_list;
+    if (node != -1) {
+        q->free_list = q->next[node];
+    } else {
+        if (q->pool_size == q->pool_capacity) {
+            size_t capacity = q->pool_capacity > 0 ? 2 * q->pool_capacity
+                                                   : QUEUE_INITIAL_CAPACITY;
+            HeapEntry *pool = realloc(q->pool, capacity * sizeof(HeapEntry));
+            CHECK_RET(pool);
+            q->pool = pool;
+            int *next = realloc(q->next, capacity * sizeof(int));
+            CHECK_RET(next);
+            q->next = next;
+            q->pool_capacity = capacity;
+        }
+        node = q->pool_size++;
+    }
+    q->pool[node] = e;
+    linkNode(q, node);
+    return true;
+}
+
+/** @brief Przenosi do kopca elementy o najmniejszym priorytecie.
+ * Jeśli kopiec kolejki pozycyjnej jest pusty, wybiera najniższy niepusty
+ * kubełek, ustala ostatni priorytet na najmniejszy w nim i rozdziela jego
+ * elementy - trafiają do kopca albo do niższych kubełków.
+ * @param[in,out] q     - kolejka
+ */
+static void refillRadix(PriorityQueue *q) {
+    if (q->kind != RADIX_QUEUE || !isEmptyHeap(&q->heap) || q->size == 0) {
+        return;
+    }
+    int b = 0;
+    while (q->buckets[b] == -1) {
+        b++;
+    }
+    int list = q->buckets[b];
+    q->buckets[b] = -1;
+    uint64_t last = q->pool[list].key;
+    for (int node = q->next[list]; node != -1; node = q->next[node]) {
+        if (q->pool[node].key < last) {
+            last = q->pool[node].key;
+        }
+    }
+    q->last = last;
+    while (list != -1) {
+        int node = list;
+        list = q->next[node];
+        if (q->pool[node].key == last) {
+            pushHeap(&q->heap, q->pool[node]);
+            q->next[node] = q->free_list;
+            q->free_list = node;
+        } else {
+            linkNode(q, node);
+        }
+    }
+}
+
+Status pushPriorityQueue(PriorityQueue *q, HeapEntry e) {
+    if (q->kind == RADIX_QUEUE) {
+        CHECK_RET(pushRadix(q, e));
+    } else {
+        CHECK_RET(pushHeap(&q->heap, e));
+    }
+    q->size++;
+    return true;
+}
+
+HeapEntry topPriorityQueue(PriorityQueue *q) {
+    refillRadix(q);
+    return topHeap(&q->heap);
+}
+
+void popPriorityQueue(PriorityQueue *q) {
+    refillRadix(q);
+    popHeap(&q->heap);
+    q->size--;
+}
+
+bool isEmptyPriorityQueue(PriorityQueue *q) { return q->size == 0; }
@@ -0,0 +1,112 @@
+#ifndef __PRIORITY_QUEUE_H__
+#define __PRIORITY_QUEUE_H__
+/** @file
+ * Interfejs kolejki priorytetowej wyszukiwań najkrótszych ścieżek, o
+ * wybieranej implementacji.
+ */
+
+#include "heap.h"
+
+/**
+ * Implementacje kolejki priorytetowej.
+ */
+typedef enum QueueKind {
+    /// kopiec binarny
+    BINARY_QUEUE,
+    /// kopiec czwórkowy
+    QUATERNARY_QUEUE,
+    /// kopiec pozycyjny (ang. radix heap)
+    RADIX_QUEUE
+} QueueKind;
+
+#ifndef DEFAULT_QUEUE_KIND
+/// Implementacja używana, jeśli nie wybrano innej (można ją zmienić podczas
+/// kompilacji).
+#define DEFAULT_QUEUE_KIND RADIX_QUEUE
+#endif
+
+/// Liczba kubełków kopca pozycyjnego (bez kubełka elementów o priorytecie
+/// równym ostatnio zdjętemu) - po jednym na każdy bit priorytetu.
+#define RADIX_BUCKETS 64
+
+/**
+ * Kolejka priorytetowa elementów kopca.
+ * Kopiec pozycyjny wymaga, by priorytety wstawianych elementów nie były
+ * mniejsze od priorytetu ostatnio zdjętego elementu (ani od zera w pustej
+ * kolejce, po @ref clearPriorityQueue) - tak jest w algorytmie
+ * Dijkstry i w wyszukiwaniu A* ze spójnymi ograniczeniami. Element trafia do
+ * kubełka wyznaczonego przez najstarszy bit, na którym jego priorytet różni się
+ * od ostatnio zdjętego, więc każdy element jest przenoszony między kubełkami
+ * co najwyżej 64 razy, a porównania pełnych etykiet odbywają się jedynie
+ * w kopcu elementów o priorytecie równym ostatnio zdjętemu.
+ */
+typedef struct PriorityQueue {
+    /// implementacja
+    QueueKind kind;
+    /// liczba elementów
+    size_t size;
+    /// elementy kopca binarnego lub czwórkowego; w kopcu pozycyjnym elementy
+    /// o priorytecie równym @p last
+    Heap heap;
+    /// priorytet ostatnio przeniesionych do kopca elementów kopca pozycyjnego
+    /// (nie większy od priorytetów elementów kolejki)
+    uint64_t last;
+    /// pierwsze węzły list kubełków kopca pozycyjnego (-1 dla pustych)
+    int buckets[RADIX_BUCKETS];
+    /// węzły list kubełków
+    HeapEntry *pool;
+    /// następniki węzłów na listach kubełków lub liście wolnych węzłów
+    int *next;
+    /// liczba zaalokowanych węzłów
+    size_t pool_capacity;
+    /// liczba użytych kiedykolwiek węzłów
+    size_t pool_size;
+    /// pierwszy wolny węzeł (-1 jeśli nie ma)
+    int free_list;
+} PriorityQueue;
+
+/** @brief newPriorityQueue tworzy pustą kolejkę.
+ * @param[in] kind      - implementacja kolejki
+ * @return kolejka, lub kolejka o q.heap.array == NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+PriorityQueue newPriorityQueue(QueueKind kind);
+
+/** @brief deletePriorityQueue zwalnia pamięć zajmowaną przez kolejkę.
+ * @param[in,out] q     - kolejka
+ */
+void deletePriorityQueue(PriorityQueue *q);
+
+/** @brief clearPriorityQueue usuwa wszystkie elementy kolejki.
+ * @param[in,out] q     - kolejka
+ */
+void clearPriorityQueue(PriorityQueue *q);
+
+/** @brief pushPriorityQueue wstawia element do kolejki.
+ * @param[in,out] q     - kolejka
+ * @param[in] e         - element do wstawienia
+ * @return Status powodzenia operacji (może się nie powieść w przypadku błędu
+ * alokacji pamięci).
+ */
+Status pushPriorityQueue(PriorityQueue *q, HeapEntry e);
+
+/** @brief topPriorityQueue zwraca najmniejszy element kolejki.
+ * @param[in] q         - kolejka
+ * @return najmniejszy element kolejki (jeśli kolejka jest pusta, zachowanie
+ * jest niezdefiniowane).
+ */
+HeapEntry topPriorityQueue(PriorityQueue *q);
+
+/** @brief popPriorityQueue usuwa najmniejszy element kolejki.
+ * Nie alokuje pamięci.
+ * @param[in,out] q     - kolejka
+ */
+void popPriorityQueue(PriorityQueue *q);
+
+/** @brief isEmptyPriorityQueue stwierdza, czy kolejka jest pusta.
+ * @param[in] q         - kolejka
+ * @return @p true jeśli kolejka jest pusta, @p false gdy nie jest.
+ */
+bool isEmptyPriorityQueue(PriorityQueue *q);
+
+#endif /* __PRIORITY_QUEUE_H__ */
@@ -0,0 +1,231 @@
+#include <string.h>
+
+#include "road_graph.h"
+
+/// Migawka jest budowana od nowa, gdy liczba odcinków dodanych i usuniętych
+/// od jej zbudowania przekroczy połowę jej rozmiaru powiększoną o tę stałą.
+#define COMPACTION_SLACK 64
+
+struct RoadGraph {
+    /// liczba miast migawki
+    size_t vertices;
+    /// początki tablic sąsiedztwa miast w @p edges (vertices + 1 elementów)
+    size_t *offsets;
+    /// odcinki migawki
+    GraphEdge *edges;
+    /// liczba odcinków usuniętych od zbudowania migawki
+    size_t removed;
+    /// liczba miast, dla których zaalokowano @p delta_head
+    size_t heads_capacity;
+    /// pierwszy odcinek warstwy zmian wychodzący z miasta lub -1
+    int *delta_head;
+    /// odcinki warstwy zmian
+    GraphEdge *delta;
+    /// następniki na listach odcinków warstwy zmian
+    int *delta_next;
+    /// liczba odcinków warstwy zmian
+    size_t delta_count;
+    /// liczba odcinków, dla których zaalokowano warstwę zmian
+    size_t delta_capacity;
+    /// tablica początków dla następnej migawki lub NULL
+    size_t *next_offsets;
+    /// odcinki następnej migawki lub NULL
+    GraphEdge *next_edges;
+};
+
+RoadGraph *newRoadGraph(void) {
+    RoadGraph *g = calloc(1, sizeof(RoadGraph));
+    CHECK_RET(g);
+    g->offsets = calloc(1, sizeof(size_t));
+    if (g->offsets == NULL) {
+        free(g);
+        return NULL;
+    }
+    return g;
+}
+
+void deleteRoadGraph(RoadGraph *g) {
+    if (g == NULL) {
+        return;
+    }
+    free(g->offsets);
+    free(g->edges);
+    free(g->delta_head);
+    free(g->delta);
+    free(g->delta_next);
+    free(g->next_offsets);
+    free(g->next_edges);
+    free(g);
+}
+
+Status reserveRoadGraph(RoadGraph *g, size_t cities_no) {
+    if (cities_no > g->heads_capacity) {
+        size_t capacity = 2 * g->heads_capacity;
+        if (capacity < cities_no) {
+            capacity = cities_no;
+        }
+        int *heads = realloc(g->delta_head, capacity * sizeof(int));
+        CHECK_RET(heads);
+        memset(heads + g->heads_capacity, 0xff,
+               (capacity - g->heads_capacity) * sizeof(int));
+        g->delta_head = heads;
+        g->heads_capacity = capacity;
+    }
+    if (g->delta_count + 2 > g->delta_capacity) {
+        size_t capacity = 2 * g->delta_capacity + 2;
+        GraphEdge *delta = realloc(g->delta, capacity * sizeof(GraphEdge));
+        CHECK_RET(delta);
+        g->delta = delta;
+        int *next = realloc(g->delta_next, capacity * sizeof(int));
+        CHECK_RET(next);
+        g->delta_next = next;
+        g->delta_capacity = capacity;
+    }
+    return true;
+}
+
+Status reserveRoadGraphSnapshot(RoadGraph *g, size_t cities_no,
+                                size_t roads_no) {
+    free(g->next_offsets);
+    free(g->next_edges);
+    g->next_offsets = calloc(cities_no + 2, sizeof(size_t));
+    g->next_edges = malloc((2 * roads_no + 1) * sizeof(GraphEdge));
+    if (g->next_offsets == NULL || g->next_edges == NULL) {
+        free(g->next_offsets);
+        free(g->next_edges);
+        g->next_offsets = NULL;
+        g->next_edges = NULL;
+        return false;
+    }
+    return true;
+}
+
+void rebuildRoadGraph(RoadGraph *g, Map *map) {
+    size_t vertices = map->city_to_int.table.size;
+    const EdgeTable *table = &map->edges;
+    size_t *offsets = g->next_offsets;
+    GraphEdge *edges = g->next_edges;
+    // offsets[v + 2] zlicza odcinki miasta v, a po zsumowaniu prefiksów
+    // offsets[v + 1] wskazuje miejsce na kolejny odcinek miasta v.
+    for (size_t i = 0; i < table->size; ++i) {
+        const Edge *e = &table->edges[i];
+        if (e->builtYear != 0) {
+            offsets[e->city1 + 2]++;
+            offsets[e->city2 + 2]++;
+        }
+    }
+    for (size_t v = 2; v <= vertices + 1; ++v) {
+        offsets[v] += offsets[v - 1];
+    }
+    for (size_t i = 0; i < table->size; ++i) {
+        const Edge *e = &table->edges[i];
+        if (e->builtYear != 0) {
+            edges[offsets[e->city1 + 1]++] =
+                (GraphEdge){e->length, e->city2, e->builtYear};
+            edges[offsets[e->city2 + 1]++] =
+                (GraphEdge){e->length, e->city1, e->builtYear};
+        }
+    }
+    free(g->offsets);
+    free(g->edges);
+    g->vertices = vertices;
+    g->offsets = offsets;
+    g->edges = edges;
+    g->removed = 0;
+    g->delta_count = 0;
+    memset(g->delta_head, 0xff, g->heads_capacity * sizeof(int));
+    g->next_offsets = NULL;
+    g->next_edges = NULL;
+}
+
+/** @brief Buduje migawkę od nowa z tablicy odcinków mapy i opróżnia
+ * warstwę zmian.
+ * Jeśli nie uda się zaalokować pamięci, graf pozostaje bez zmian.
+ * @param[in,out] g         - graf
+ * @param[in] map           - mapa dróg
+ */
+static void compact(RoadGraph *g, Map *map) {
+    if (reserveRoadGraphSnapshot(g, map->city_to_int.table.size,
+                                 map->edges.count)) {
+        rebuildRoadGraph(g, map);
+    }
+}
+
+/** @brief Buduje migawkę od nowa, jeśli od jej zbudowania graf zmienił się
+ * w znacznym stopniu.
+ * @param[in,out] g         - graf
+ * @param[in] map           - mapa dróg
+ */
+static void compactIfNeeded(RoadGraph *g, Map *map) {
+    if (g->delta_count + g->removed >
+        g->offsets[g->vertices] / 2 + COMPACTION_SLACK) {
+        compact(g, map);
+    }
+}
+
+/** @brief Dopisuje odcinek do warstwy zmian.
+ * @param[in,out] g         - graf z zarezerwowanym miejscem
+ * @param[in] start         - miasto początkowe
+ * @param[in] edge          - odcinek
+ */
+static void appendDelta(RoadGraph *g, int start, GraphEdge edge) {
+    g->delta[g->delta_count] = edge;
+    g->delta_next[g->delta_count] = g->delta_head[start];
+    g->delta_head[start] = (int)g->delta_count++;
+}
+
+void roadGraphAddRoad(RoadGraph *g, Map *map, Road road) {
+    appendDelta(g, road.start,
+                (GraphEdge){road.length, road.end, road.builtYear});
+    appendDelta(g, road.end,
+                (GraphEdge){road.length, road.start, road.builtYear});
+    compactIfNeeded(g, map);
+}
+
+/** @brief Znajduje odcinek grafu prowadzący z @p start do @p end.
+ * @param[in,out] g         - graf
+ * @param[in] start         - miasto początkowe
+ * @param[in] end           - miasto końcowe
+ * @return Wskaźnik na nieusunięty odcinek lub NULL, jeśli go nie ma.
+ */
+static GraphEdge *findEdge(RoadGraph *g, int start, int end) {
+    if ((size_t)start < g->vertices) {
+        for (size_t i = g->offsets[start]; i < g->offsets[start + 1]; ++i) {
+            if (g->edges[i].end == end && g->edges[i].builtYear != 0) {
+                return &g->edges[i];
+            }
+        }
+    }
+    if ((size_t)start < g->heads_capacity) {
+        for (int i = g->delta_head[start]; i != -1; i = g->delta_next[i]) {
+            if (g->delta[i].end == end && g->delta[i].builtYear != 0) {
+                return &g->delta[i];
+            }
+        }
+    }
+    return NULL;
+}
+
+void roadGraphRepairRoad(RoadGraph *g, Road road) {
+    findEdge(g, road.start, road.end)->builtYear = road.builtYear;
+    findEdge(g, road.end, road.start)->builtYear = road.builtYear;
+}
+
+void roadGraphRemoveRoad(RoadGraph *g, Map *map, Road road) {
+    findEdge(g, road.start, road.end)->builtYear = 0;
+    findEdge(g, road.end, road.start)->builtYear = 0;
+    g->removed += 2;
+    compactIfNeeded(g, map);
+}
+
+RoadIterator iterateRoads(const RoadGraph *g, int v) {
+    RoadIterator it = {NULL, NULL, g->delta, g->delta_next, -1, v};
+    if ((size_t)v < g->vertices) {
+        it.edge = g->edges + g->offsets[v];
+        it.end = g->edges + g->offsets[v + 1];
+    }
+    if ((size_t)v < g->heads_capacity) {
+        it.delta_index = g->delta_head[v];
+    }
+    return it;
+}
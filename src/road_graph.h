@@ -0,0 +1,143 @@
+/** @file
+ * Zwarta reprezentacja grafu dróg (CSR) z warstwą zmian, przeglądana przez
+ * wyszukiwania najkrótszych ścieżek.
+ */
+#ifndef __ROAD_GRAPH_H__
+#define __ROAD_GRAPH_H__
+
+#include "map_struct.h"
+#include "status.h"
+
+/**
+ * Odcinek drogowy w zwartej reprezentacji grafu.
+ */
+typedef struct GraphEdge {
+    /// długość odcinka
+    uint64_t length;
+    /// miasto końcowe
+    int end;
+    /// rok budowy lub ostatniej naprawy; 0 oznacza odcinek usunięty
+    int builtYear;
+} GraphEdge;
+
+/**
+ * Graf dróg: migawka w postaci tablic sąsiedztwa kolejnych miast ułożonych
+ * jedna za drugą oraz warstwa odcinków dodanych od ostatniego zbudowania
+ * migawki. Usunięte odcinki są jedynie oznaczane, a naprawy zmieniają rok
+ * w miejscu. Gdy zmian jest dużo w stosunku do rozmiaru migawki, jest ona
+ * budowana od nowa z tablicy odcinków mapy.
+ */
+typedef struct RoadGraph RoadGraph;
+
+/**
+ * Iterator po odcinkach drogowych wychodzących z miasta.
+ * Przechowuje cały stan iteracji, więc wyszukiwania w różnych wątkach mogą
+ * przeglądać niezmieniany graf jednocześnie.
+ */
+typedef struct RoadIterator {
+    /// następny odcinek migawki
+    const GraphEdge *edge;
+    /// koniec odcinków migawki
+    const GraphEdge *end;
+    /// odcinki warstwy zmian
+    const GraphEdge *delta;
+    /// następniki na listach odcinków warstwy zmian
+    const int *delta_next;
+    /// indeks następnego odcinka warstwy zmian lub -1
+    int delta_index;
+    /// miasto, z którego wychodzą odcinki
+    int start;
+} RoadIterator;
+
+/** @brief Tworzy pusty graf.
+ * @return Wskaźnik na graf lub NULL, gdy nie udało się zaalokować pamięci.
+ */
+RoadGraph *newRoadGraph(void);
+
+/** @brief Zwalnia graf.
+ * @param[in,out] g         - graf do zwolnienia
+ */
+void deleteRoadGraph(RoadGraph *g);
+
+/** @brief Zapewnia miejsce na dodanie jednego odcinka między miastami
+ * o indeksach mniejszych niż @p cities_no.
+ * Po udanym wywołaniu @ref roadGraphAddRoad nie może się nie powieść.
+ * @param[in,out] g         - graf
+ * @param[in] cities_no     - liczba miast
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status reserveRoadGraph(RoadGraph *g, size_t cities_no);
+
+/** @brief Dodaje do grafu nowy odcinek drogowy (w obu kierunkach).
+ * Wymaga wcześniejszego wywołania @ref reserveRoadGraph.
+ * @param[in,out] g         - graf
+ * @param[in] map           - mapa dróg zawierająca już nowy odcinek
+ * @param[in] road          - nowy odcinek drogowy
+ */
+void roadGraphAddRoad(RoadGraph *g, Map *map, Road road);
+
+/** @brief Uwzględnia naprawę odcinka drogowego.
+ * @param[in,out] g         - graf
+ * @param[in] road          - naprawiony odcinek drogowy
+ */
+void roadGraphRepairRoad(RoadGraph *g, Road road);
+
+/** @brief Usuwa z grafu odcinek drogowy.
+ * @param[in,out] g         - graf
+ * @param[in] map           - mapa dróg bez usuniętego odcinka
+ * @param[in] road          - usunięty odcinek drogowy
+ */
+void roadGraphRemoveRoad(RoadGraph *g, Map *map, Road road);
+
+/** @brief Rezerwuje pamięć na migawkę zbudowaną przez @ref rebuildRoadGraph.
+ * @param[in,out] g         - graf
+ * @param[in] cities_no     - liczba miast mapy
+ * @param[in] roads_no      - liczba odcinków drogowych mapy
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status reserveRoadGraphSnapshot(RoadGraph *g, size_t cities_no,
+                                size_t roads_no);
+
+/** @brief Buduje migawkę od nowa z tablicy odcinków mapy i opróżnia
+ * warstwę zmian, np. po zmianie numeracji miast.
+ * Wymaga wcześniejszego wywołania @ref reserveRoadGraphSnapshot dla
+ * bieżącej liczby miast i odcinków, więc nie może się nie powieść.
+ * @param[in,out] g         - graf
+ * @param[in] map           - mapa dróg
+ */
+void rebuildRoadGraph(RoadGraph *g, Map *map);
+
+/** @brief Rozpoczyna iterację po odcinkach wychodzących z miasta.
+ * Iterator traci ważność przy zmianie grafu.
+ * @param[in] g             - graf
+ * @param[in] v             - miasto
+ * @return Iterator ustawiony przed pierwszym odcinkiem.
+ */
+RoadIterator iterateRoads(const RoadGraph *g, int v);
+
+/** @brief Przesuwa iterator na kolejny odcinek drogowy.
+ * @param[in,out] it        - iterator (@ref iterateRoads)
+ * @param[out] road         - tutaj zapisywany jest kolejny odcinek
+ * @return @p true jeśli znaleziono kolejny odcinek, @p false jeśli wszystkie
+ * zostały już przejrzane.
+ */
+static inline bool nextRoad(RoadIterator *it, Road *road) {
+    while (it->edge != it->end) {
+        const GraphEdge *e = it->edge++;
+        if (e->builtYear != 0) {
+            *road = (Road){e->length, e->builtYear, it->start, e->end};
+            return true;
+        }
+    }
+    while (it->delta_index != -1) {
+        const GraphEdge *e = &it->delta[it->delta_index];
+        it->delta_index = it->delta_next[it->delta_index];
+        if (e->builtYear != 0) {
+            *road = (Road){e->length, e->builtYear, it->start, e->end};
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif /* __ROAD_GRAPH_H__ */
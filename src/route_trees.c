@@ -0,0 +1,578 @@
+#include <limits.h>
+#include <string.h>
+
+#include "heap.h"
+#include "road_graph.h"
+#include "route_trees.h"
+#include "utils.h"
+
+/// Odległość do wierzchołka, do którego nie da się dojechać.
+#define INFINITY UINT64_MAX
+
+/// Liczba ścieżek, powyżej której nie rozróżniamy ich liczby.
+#define MANY_PATHS 2
+
+/// Początkowa pojemność kopca.
+#define HEAP_INITIAL_CAPACITY 16
+
+/**
+ * Drzewo najkrótszych ścieżek z końca drogi krajowej.
+ * Etykiety są takie, jakie nadaje wyszukiwanie z korzenia, w którym nie
+ * wolno przechodzić przez pozostałe miasta drogi krajowej. Liczba optymalnych
+ * ścieżek zależy od roku najdawniejszego odcinka ścieżki do celu, więc jest
+ * wyznaczana dopiero przy zapytaniu.
+ */
+typedef struct EndpointTree {
+    /// korzeń - koniec drogi krajowej
+    int root;
+    /// liczba wierzchołków, dla których przechowywane są etykiety
+    size_t cities_no;
+    /// długości najkrótszych ścieżek (INFINITY dla nieosiągalnych)
+    uint64_t *dist;
+    /// najpóźniejsze możliwe lata najdawniej zbudowanych odcinków na
+    /// najkrótszych ścieżkach
+    int *time;
+    /// czy wierzchołek jest miastem drogi krajowej innym niż korzeń
+    bool *excluded;
+} EndpointTree;
+
+struct RouteTrees {
+    /// drzewa początku i końca dróg krajowych (NULL, jeśli nie są zbudowane)
+    EndpointTree *trees[ROUTE_MAX][2];
+    /// kopiec wierzchołków, których etykiety są wyznaczane
+    Heap heap;
+    /// pojemność tablic indeksowanych wierzchołkami
+    size_t capacity;
+    /// pokolenie bieżącej aktualizacji
+    unsigned epoch;
+    /// znaczniki pokolenia, w którym wierzchołek trafił na stos
+    unsigned *dirty;
+    /// wierzchołki, których etykiety wyznaczane są od nowa, lub wierzchołki
+    /// optymalnych ścieżek do celu zapytania
+    int *stack;
+    /// liczby optymalnych ścieżek do wierzchołków ze stosu, obcięte do
+    /// @ref MANY_PATHS
+    unsigned char *ways;
+};
+
+RouteTrees *newRouteTrees(void) {
+    RouteTrees *rt = calloc(1, sizeof(RouteTrees));
+    CHECK_RET(rt);
+    rt->heap = newHeap(HEAP_INITIAL_CAPACITY);
+    if (rt->heap.array == NULL) {
+        free(rt);
+        return NULL;
+    }
+    return rt;
+}
+
+/** @brief Zwalnia drzewo.
+ * @param[in,out] t         - drzewo do zwolnienia
+ */
+static void deleteTree(EndpointTree *t) {
+    if (t == NULL) {
+        return;
+    }
+    free(t->dist);
+    free(t->time);
+    free(t->excluded);
+    free(t);
+}
+
+void routeTreesRemoveRoute(RouteTrees *rt, unsigned routeId) {
+    for (int k = 0; k < 2; ++k) {
+        deleteTree(rt->trees[routeId][k]);
+        rt->trees[routeId][k] = NULL;
+    }
+}
+
+void deleteRouteTrees(RouteTrees *rt) {
+    if (rt == NULL) {
+        return;
+    }
+    for (unsigned i = 0; i < ROUTE_MAX; ++i) {
+        routeTreesRemoveRoute(rt, i);
+    }
+    deleteHeap(&rt->heap);
+    free(rt->dirty);
+    free(rt->stack);
+    free(rt->ways);
+    free(rt);
+}
+
+/** @brief Powiększa tablicę.
+ * @param[in,out] array     - wskaźnik na tablicę
+ * @param[in] capacity      - nowa liczba elementów
+ * @param[in] size          - rozmiar elementu
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status growArray(void *array, size_t capacity, size_t size) {
+    void *p = realloc(*(void **)array, capacity * size);
+    CHECK_RET(p);
+    *(void **)array = p;
+    return true;
+}
+
+/** @brief Zapewnia, że drzewo przechowuje etykiety @p cities_no wierzchołków.
+ * Nowe wierzchołki są nieosiągalne - nie wychodzą z nich jeszcze żadne
+ * odcinki drogowe.
+ * @param[in,out] t         - drzewo
+ * @param[in] cities_no     - liczba wierzchołków
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status reserveTree(EndpointTree *t, size_t cities_no) {
+    if (cities_no <= t->cities_no) {
+        return true;
+    }
+    CHECK_RET(growArray(&t->dist, cities_no, sizeof(uint64_t)));
+    CHECK_RET(growArray(&t->time, cities_no, sizeof(int)));
+    CHECK_RET(growArray(&t->excluded, cities_no, sizeof(bool)));
+    size_t added = cities_no - t->cities_no;
+    // ustawia wszystkie bajty na 0xff, czyli odległości na INFINITY
+    memset(t->dist + t->cities_no, 0xff, added * sizeof(uint64_t));
+    memset(t->time + t->cities_no, 0, added * sizeof(int));
+    memset(t->excluded + t->cities_no, 0, added * sizeof(bool));
+    t->cities_no = cities_no;
+    return true;
+}
+
+/** @brief Rozpoczyna aktualizację drzewa.
+ * Zapewnia, że tablice pomocnicze mieszczą @p cities_no wierzchołków, i
+ * zmienia pokolenie znaczników.
+ * @param[in,out] rt        - pamięć podręczna drzew
+ * @param[in] cities_no     - liczba wierzchołków
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status beginUpdate(RouteTrees *rt, size_t cities_no) {
+    if (cities_no > rt->capacity) {
+        CHECK_RET(growArray(&rt->dirty, cities_no, sizeof(unsigned)));
+        CHECK_RET(growArray(&rt->stack, cities_no, sizeof(int)));
+        CHECK_RET(growArray(&rt->ways, cities_no, sizeof(unsigned char)));
+        memset(rt->dirty + rt->capacity, 0,
+               (cities_no - rt->capacity) * sizeof(unsigned));
+        rt->capacity = cities_no;
+    }
+    if (++rt->epoch == 0) {
+        memset(rt->dirty, 0, rt->capacity * sizeof(unsigned));
+        rt->epoch = 1;
+    }
+    rt->heap.size = 0;
+    return true;
+}
+
+/** @brief Porównuje etykiety.
+ * @param[in] d1            - długość pierwszej ścieżki
+ * @param[in] t1            - rok najdawniejszego odcinka pierwszej ścieżki
+ * @param[in] d2            - długość drugiej ścieżki
+ * @param[in] t2            - rok najdawniejszego odcinka drugiej ścieżki
+ * @return @p true jeśli pierwsza etykieta jest lepsza od drugiej.
+ */
+static bool better(uint64_t d1, int t1, uint64_t d2, int t2) {
+    return d1 < d2 || (d1 == d2 && t1 > t2);
+}
+
+/** @brief Stwierdza, czy odcinek leży na optymalnej ścieżce do swojego końca.
+ * @param[in] t             - drzewo
+ * @param[in] road          - odcinek drogowy
+ * @return @p true jeśli przedłużenie optymalnej ścieżki do @p road.start
+ * odcinkiem @p road daje etykietę @p road.end.
+ */
+static bool onOptimalPath(const EndpointTree *t, const Road *road) {
+    int x = road->start;
+    int y = road->end;
+    return t->dist[x] != INFINITY && !t->excluded[x] &&
+           t->dist[x] + road->length == t->dist[y] &&
+           min(t->time[x], road->builtYear) == t->time[y];
+}
+
+/** @brief Proponuje etykietę końca odcinka wyznaczaną przez jego początek.
+ * Przy poprawianiu etykiet (@p improving) zmienić można etykietę dowolnego
+ * wierzchołka, a w przeciwnym razie - jedynie etykiety wierzchołków ze stosu.
+ * @param[in,out] rt        - pamięć podręczna drzew
+ * @param[in,out] t         - drzewo
+ * @param[in] road          - odcinek drogowy
+ * @param[in] improving     - czy etykiety mogą się jedynie poprawić
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status relaxRoad(RouteTrees *rt, EndpointTree *t, const Road *road,
+                        bool improving) {
+    int x = road->start;
+    int y = road->end;
+    if (t->dist[x] == INFINITY || t->excluded[x] || t->excluded[y] ||
+        (!improving && rt->dirty[y] != rt->epoch)) {
+        return true;
+    }
+    uint64_t dist = t->dist[x] + road->length;
+    int time = min(t->time[x], road->builtYear);
+    if (!better(dist, time, t->dist[y], t->time[y])) {
+        return true;
+    }
+    t->dist[y] = dist;
+    t->time[y] = time;
+    return pushHeap(&rt->heap, (HeapEntry){dist, dist, time, y});
+}
+
+/** @brief Proponuje etykiety sąsiadom wierzchołka.
+ * @param[in,out] rt        - pamięć podręczna drzew
+ * @param[in,out] t         - drzewo
+ * @param[in] map           - mapa dróg
+ * @param[in] v             - wierzchołek o ustalonej etykiecie
+ * @param[in] improving     - czy etykiety mogą się jedynie poprawić
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status relaxNeighbours(RouteTrees *rt, EndpointTree *t, Map *map,
+                              int v, bool improving) {
+    RoadIterator it = iterateRoads(map->graph, v);
+    Road road;
+    while (nextRoad(&it, &road)) {
+        CHECK_RET(relaxRoad(rt, t, &road, improving));
+    }
+    return true;
+}
+
+/** @brief Ustala etykiety wierzchołków wyznaczanych od nowa algorytmem
+ * Dijkstry, zaczynając od wierzchołków znajdujących się w kopcu.
+ * @param[in,out] rt        - pamięć podręczna drzew
+ * @param[in,out] t         - drzewo
+ * @param[in] map           - mapa dróg
+ * @param[in] improving     - czy etykiety mogą się jedynie poprawić
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status propagate(RouteTrees *rt, EndpointTree *t, Map *map,
+                        bool improving) {
+    while (!isEmptyHeap(&rt->heap)) {
+        HeapEntry e = topHeap(&rt->heap);
+        popHeap(&rt->heap);
+        int v = e.vertex;
+        if (e.dist != t->dist[v] || e.time != t->time[v]) {
+            continue;
+        }
+        CHECK_RET(relaxNeighbours(rt, t, map, v, improving));
+    }
+    return true;
+}
+
+/** @brief Wyznacza od nowa etykiety wierzchołków ze stosu.
+ * Ich etykiety są najpierw usuwane, a następnie wyznaczane na podstawie
+ * etykiet pozostałych wierzchołków, które się nie zmieniają.
+ * @param[in,out] rt        - pamięć podręczna drzew
+ * @param[in,out] t         - drzewo
+ * @param[in] map           - mapa dróg
+ * @param[in] size          - liczba wierzchołków na stosie
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status recomputeStack(RouteTrees *rt, EndpointTree *t, Map *map,
+                             size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        int v = rt->stack[i];
+        t->dist[v] = INFINITY;
+        t->time[v] = 0;
+    }
+    for (size_t i = 0; i < size; ++i) {
+        int v = rt->stack[i];
+        RoadIterator it = iterateRoads(map->graph, v);
+        Road road;
+        while (nextRoad(&it, &road)) {
+            if (rt->dirty[road.end] != rt->epoch) {
+                Road back = {road.length, road.builtYear, road.end, v};
+                CHECK_RET(relaxRoad(rt, t, &back, false));
+            }
+        }
+    }
+    return propagate(rt, t, map, false);
+}
+
+/** @brief Dodaje wierzchołek do stosu, o ile jeszcze go na nim nie ma.
+ * @param[in,out] rt        - pamięć podręczna drzew
+ * @param[in] v             - wierzchołek
+ * @param[in,out] size      - liczba wierzchołków na stosie
+ */
+static void markDirty(RouteTrees *rt, int v, size_t *size) {
+    if (rt->dirty[v] != rt->epoch) {
+        rt->dirty[v] = rt->epoch;
+        rt->stack[(*size)++] = v;
+    }
+}
+
+/** @brief Dodaje do stosu wierzchołki, do których prowadzą optymalne ścieżki
+ * przez wierzchołki stosu od pozycji @p from.
+ * @param[in,out] rt        - pamięć podręczna drzew
+ * @param[in] t             - drzewo
+ * @param[in] map           - mapa dróg
+ * @param[in] from          - pozycja na stosie pierwszego wierzchołka
+ * @param[in,out] size      - liczba wierzchołków na stosie
+ */
+static void markDescendants(RouteTrees *rt, const EndpointTree *t, Map *map,
+                            size_t from, size_t *size) {
+    for (size_t i = from; i < *size; ++i) {
+        RoadIterator it = iterateRoads(map->graph, rt->stack[i]);
+        Road road;
+        while (nextRoad(&it, &road)) {
+            if (onOptimalPath(t, &road)) {
+                markDirty(rt, road.end, size);
+            }
+        }
+    }
+}
+
+/** @brief Buduje drzewo końca drogi krajowej.
+ * @param[in,out] rt        - pamięć podręczna drzew
+ * @param[in] map           - mapa dróg
+ * @param[in] route         - droga krajowa
+ * @param[in] root          - koniec drogi krajowej
+ * @return Wskaźnik na drzewo lub NULL, gdy nie udało się zaalokować pamięci.
+ */
+static EndpointTree *buildTree(RouteTrees *rt, Map *map, List *route,
+                               int root) {
+    size_t cities_no = map->city_to_int.table.size;
+    EndpointTree *t = calloc(1, sizeof(EndpointTree));
+    CHECK_RET(t);
+    t->root = root;
+    if (!reserveTree(t, cities_no) || !beginUpdate(rt, cities_no)) {
+        goto DELETE;
+    }
+    for (Node *n = route->begin->next; n != route->end; n = n->next) {
+        t->excluded[n->value] = n->value != root;
+    }
+    t->dist[root] = 0;
+    t->time[root] = INT_MAX;
+    for (size_t v = 0; v < cities_no; ++v) {
+        rt->dirty[v] = (int)v != root ? rt->epoch : 0;
+    }
+    if (!relaxNeighbours(rt, t, map, root, false) ||
+        !propagate(rt, t, map, false)) {
+        goto DELETE;
+    }
+    return t;
+
+DELETE:
+    deleteTree(t);
+    return NULL;
+}
+
+/** @brief Stwierdza, czy odcinek może należeć do optymalnej ścieżki do celu.
+ * @param[in] t             - drzewo
+ * @param[in] road          - odcinek drogowy
+ * @param[in] threshold     - rok najdawniej zbudowanego odcinka optymalnej
+ * ścieżki do celu
+ * @return @p true jeśli odcinek przedłuża najkrótszą ścieżkę do
+ * @p road.start i zbudowano go nie wcześniej niż w roku @p threshold.
+ */
+static bool isTight(const EndpointTree *t, const Road *road, int threshold) {
+    int x = road->start;
+    return t->dist[x] != INFINITY && !t->excluded[x] &&
+           t->dist[x] + road->length == t->dist[road->end] &&
+           road->builtYear >= threshold;
+}
+
+/** @brief Liczy optymalne ścieżki z korzenia do @p v.
+ * Optymalne są najkrótsze ścieżki, których wszystkie odcinki zbudowano nie
+ * wcześniej niż najdawniejszy odcinek najlepszej ścieżki do @p v. Wierzchołki
+ * tych ścieżek trafiają na stos, a liczby ścieżek do nich - do @p rt->ways.
+ * @param[in,out] rt        - pamięć podręczna drzew
+ * @param[in] t             - drzewo, w którym @p v jest osiągalny
+ * @param[in] map           - mapa dróg
+ * @param[in] v             - cel
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status countWays(RouteTrees *rt, const EndpointTree *t, Map *map,
+                        int v) {
+    CHECK_RET(beginUpdate(rt, map->city_to_int.table.size));
+    int threshold = t->time[v];
+    size_t size = 0;
+    markDirty(rt, v, &size);
+    for (size_t i = 0; i < size; ++i) {
+        RoadIterator it = iterateRoads(map->graph, rt->stack[i]);
+        Road road;
+        while (nextRoad(&it, &road)) {
+            Road back = {road.length, road.builtYear, road.end, road.start};
+            if (isTight(t, &back, threshold)) {
+                markDirty(rt, back.start, &size);
+            }
+        }
+    }
+    for (size_t i = 0; i < size; ++i) {
+        int y = rt->stack[i];
+        CHECK_RET(pushHeap(&rt->heap, (HeapEntry){t->dist[y], t->dist[y], 0, y}));
+    }
+    // poprzednicy na najkrótszych ścieżkach są bliżsi, więc są zdejmowani
+    // z kopca wcześniej
+    while (!isEmptyHeap(&rt->heap)) {
+        int y = topHeap(&rt->heap).vertex;
+        popHeap(&rt->heap);
+        unsigned ways = y == t->root;
+        RoadIterator it = iterateRoads(map->graph, y);
+        Road road;
+        while (nextRoad(&it, &road)) {
+            Road back = {road.length, road.builtYear, road.end, y};
+            if (rt->dirty[back.start] == rt->epoch &&
+                isTight(t, &back, threshold)) {
+                ways += rt->ways[back.start];
+            }
+        }
+        rt->ways[y] = ways < MANY_PATHS ? ways : MANY_PATHS;
+    }
+    return true;
+}
+
+/** @brief Odczytuje jedyną optymalną ścieżkę wyznaczoną przez @ref countWays.
+ * @param[in] rt            - pamięć podręczna drzew
+ * @param[in] t             - drzewo
+ * @param[in] map           - mapa dróg
+ * @param[in] v             - cel, do którego prowadzi jedna optymalna ścieżka
+ * @return Lista kolejnych miast ścieżki od sąsiada korzenia do @p v lub NULL,
+ * gdy nie udało się zaalokować pamięci.
+ */
+static List *uniquePath(const RouteTrees *rt, const EndpointTree *t, Map *map,
+                        int v) {
+    int threshold = t->time[v];
+    List *path = newList();
+    CHECK_RET(path);
+    int y = v;
+    while (y != t->root) {
+        if (!listInsertAfter(path, path->begin, y)) {
+            deleteList(path);
+            free(path);
+            return NULL;
+        }
+        RoadIterator it = iterateRoads(map->graph, y);
+        Road road;
+        while (nextRoad(&it, &road)) {
+            Road back = {road.length, road.builtYear, road.end, y};
+            if (rt->dirty[back.start] == rt->epoch &&
+                isTight(t, &back, threshold) && rt->ways[back.start] > 0) {
+                y = back.start;
+                break;
+            }
+        }
+    }
+    return path;
+}
+
+Status routeTreesNearest(RouteTrees *rt, Map *map, unsigned routeId, int v,
+                         int *nearest, List **path) {
+    List *route = &map->routes[routeId].cities;
+    int ends[2] = {route->begin->next->value, route->end->prev->value};
+    EndpointTree **trees = rt->trees[routeId];
+    for (int k = 0; k < 2; ++k) {
+        if (trees[k] == NULL) {
+            trees[k] = buildTree(rt, map, route, ends[k]);
+            CHECK_RET(trees[k]);
+        }
+    }
+
+    int best = -1;
+    for (int k = 0; k < 2; ++k) {
+        const EndpointTree *t = trees[k];
+        if ((size_t)v >= t->cities_no || t->dist[v] == INFINITY) {
+            continue;
+        }
+        if (best == -1 || better(t->dist[v], t->time[v], trees[best]->dist[v],
+                                 trees[best]->time[v])) {
+            best = k;
+        } else if (!better(trees[best]->dist[v], trees[best]->time[v],
+                           t->dist[v], t->time[v])) {
+            return false;
+        }
+    }
+    CHECK_RET(best != -1);
+    CHECK_RET(countWays(rt, trees[best], map, v));
+    CHECK_RET(rt->ways[v] == 1);
+    *path = uniquePath(rt, trees[best], map, v);
+    CHECK_RET(*path);
+    *nearest = best;
+    return true;
+}
+
+void routeTreesAddRoad(RouteTrees *rt, Map *map, Road road) {
+    size_t cities_no = map->city_to_int.table.size;
+    Road back = {road.length, road.builtYear, road.end, road.start};
+    for (unsigned i = 0; i < ROUTE_MAX; ++i) {
+        for (int k = 0; k < 2; ++k) {
+            EndpointTree *t = rt->trees[i][k];
+            if (t == NULL) {
+                continue;
+            }
+            if (!reserveTree(t, cities_no) || !beginUpdate(rt, cities_no) ||
+                !relaxRoad(rt, t, &road, true) ||
+                !relaxRoad(rt, t, &back, true) ||
+                !propagate(rt, t, map, true)) {
+                deleteTree(t);
+                rt->trees[i][k] = NULL;
+            }
+        }
+    }
+}
+
+void routeTreesRemoveRoad(RouteTrees *rt, Map *map, Road road) {
+    size_t cities_no = map->city_to_int.table.size;
+    Road back = {road.length, road.builtYear, road.end, road.start};
+    for (unsigned i = 0; i < ROUTE_MAX; ++i) {
+        for (int k = 0; k < 2; ++k) {
+            EndpointTree *t = rt->trees[i][k];
+            if (t == NULL) {
+                continue;
+            }
+            if (!reserveTree(t, cities_no) || !beginUpdate(rt, cities_no)) {
+                goto DELETE;
+            }
+            size_t size = 0;
+            if (onOptimalPath(t, &road)) {
+                markDirty(rt, road.end, &size);
+            }
+            if (onOptimalPath(t, &back)) {
+                markDirty(rt, road.start, &size);
+            }
+            markDescendants(rt, t, map, 0, &size);
+            if (size == 0 || recomputeStack(rt, t, map, size)) {
+                continue;
+            }
+        DELETE:
+            deleteTree(t);
+            rt->trees[i][k] = NULL;
+        }
+    }
+}
+
+/** @brief Wyklucza z drzewa nowe miasta drogi krajowej.
+ * @param[in,out] rt        - pamięć podręczna drzew
+ * @param[in,out] t         - drzewo
+ * @param[in] map           - mapa dróg
+ * @param[in] route         - droga krajowa
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status excludeRoute(RouteTrees *rt, EndpointTree *t, Map *map,
+                           List *route) {
+    size_t cities_no = map->city_to_int.table.size;
+    CHECK_RET(reserveTree(t, cities_no));
+    CHECK_RET(beginUpdate(rt, cities_no));
+    size_t size = 0;
+    for (Node *n = route->begin->next; n != route->end; n = n->next) {
+        int v = n->value;
+        if (v != t->root && !t->excluded[v]) {
+            markDirty(rt, v, &size);
+        }
+    }
+    if (size == 0) {
+        return true;
+    }
+    size_t excluded = size;
+    markDescendants(rt, t, map, 0, &size);
+    for (size_t i = 0; i < excluded; ++i) {
+        t->excluded[rt->stack[i]] = true;
+    }
+    return recomputeStack(rt, t, map, size);
+}
+
+void routeTreesUpdateRoute(RouteTrees *rt, Map *map, unsigned routeId) {
+    List *route = &map->routes[routeId].cities;
+    int ends[2] = {route->begin->next->value, route->end->prev->value};
+    for (int k = 0; k < 2; ++k) {
+        EndpointTree *t = rt->trees[routeId][k];
+        if (t != NULL &&
+            (t->root != ends[k] || !excludeRoute(rt, t, map, route))) {
+            deleteTree(t);
+            rt->trees[routeId][k] = NULL;
+        }
+    }
+}
@@ -0,0 +1,86 @@
+/** @file
+ * Drzewa najkrótszych ścieżek zakorzenione w końcach dróg krajowych,
+ * aktualizowane przyrostowo przy zmianach mapy.
+ */
+#ifndef __ROUTE_TREES_H__
+#define __ROUTE_TREES_H__
+
+#include "map_struct.h"
+#include "status.h"
+
+/**
+ * Pamięć podręczna drzew najkrótszych ścieżek z końców dróg krajowych.
+ * Drzewo końca drogi krajowej opisuje wyszukiwania z @ref extendRoute: miasta
+ * drogi krajowej (poza korzeniem) są z niego wykluczone. Drzewa są budowane
+ * przy pierwszym przedłużeniu drogi krajowej, a potem poprawiane tylko
+ * w obszarze, którego dotyczy zmiana mapy lub drogi krajowej.
+ */
+typedef struct RouteTrees RouteTrees;
+
+/** @brief Tworzy pustą pamięć podręczną drzew.
+ * @return Wskaźnik na pamięć podręczną lub NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+RouteTrees *newRouteTrees(void);
+
+/** @brief Zwalnia pamięć podręczną drzew.
+ * @param[in,out] rt        - pamięć podręczna do zwolnienia
+ */
+void deleteRouteTrees(RouteTrees *rt);
+
+/** @brief Wyznacza koniec drogi krajowej najbliższy miastu @p v.
+ * Odpowiada tak jak @ref shortestPathsToNearest z miasta @p v do obu końców
+ * drogi krajowej, której miasta (poza końcami) są wykluczone. W razie
+ * potrzeby buduje drzewa końców drogi krajowej.
+ * @param[in,out] rt        - pamięć podręczna drzew
+ * @param[in] map           - mapa dróg
+ * @param[in] routeId       - numer istniejącej drogi krajowej
+ * @param[in] v             - miasto różne od końców drogi krajowej
+ * @param[out] nearest      - tutaj zapisywany jest indeks najbliższego końca
+ * (0 - początek, 1 - koniec drogi krajowej)
+ * @param[out] path         - tutaj zapisywana jest lista kolejnych miast
+ * ścieżki od sąsiada najbliższego końca do @p v
+ * @return Wartość @p false, jeśli nastąpił błąd alokacji pamięci, żaden
+ * koniec nie jest osiągalny, oba końce są jednakowo bliskie lub do
+ * najbliższego końca prowadzi więcej niż jedna optymalna ścieżka, @p true
+ * wpp.
+ */
+Status routeTreesNearest(RouteTrees *rt, Map *map, unsigned routeId, int v,
+                         int *nearest, List **path);
+
+/** @brief Uwzględnia w drzewach nowy lub naprawiony odcinek drogowy.
+ * Etykiety mogą się tylko poprawić, więc poprawiane są jedynie wierzchołki,
+ * do których odcinek prowadzi równie dobrą lub lepszą ścieżką. Jeśli nie uda
+ * się zaalokować pamięci, usuwa drzewo.
+ * @param[in,out] rt        - pamięć podręczna drzew
+ * @param[in] map           - mapa dróg zawierająca już zmieniony odcinek
+ * @param[in] road          - nowy lub naprawiony odcinek drogowy
+ */
+void routeTreesAddRoad(RouteTrees *rt, Map *map, Road road);
+
+/** @brief Uwzględnia w drzewach usunięcie odcinka drogowego.
+ * Od nowa wyznaczane są jedynie etykiety wierzchołków, do których prowadziła
+ * optymalna ścieżka przez usunięty odcinek. Jeśli nie uda się zaalokować
+ * pamięci, usuwa drzewo.
+ * @param[in,out] rt        - pamięć podręczna drzew
+ * @param[in] map           - mapa dróg bez usuniętego odcinka
+ * @param[in] road          - usunięty odcinek drogowy
+ */
+void routeTreesRemoveRoad(RouteTrees *rt, Map *map, Road road);
+
+/** @brief Uwzględnia zmianę przebiegu drogi krajowej.
+ * Drzewo końca, który przestał być końcem drogi krajowej, jest usuwane,
+ * a z drzewa pozostałego końca wykluczane są nowe miasta drogi krajowej.
+ * @param[in,out] rt        - pamięć podręczna drzew
+ * @param[in] map           - mapa dróg
+ * @param[in] routeId       - numer zmienionej drogi krajowej
+ */
+void routeTreesUpdateRoute(RouteTrees *rt, Map *map, unsigned routeId);
+
+/** @brief Usuwa drzewa drogi krajowej.
+ * @param[in,out] rt        - pamięć podręczna drzew
+ * @param[in] routeId       - numer usuwanej drogi krajowej
+ */
+void routeTreesRemoveRoute(RouteTrees *rt, unsigned routeId);
+
+#endif /* __ROUTE_TREES_H__ */
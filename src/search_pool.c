@@ -0,0 +1,195 @@
+#include <pthread.h>
+
+#include "search_pool.h"
+#include "utils.h"
+
+/**
+ * Stan wątku puli.
+ */
+typedef struct PoolWorker {
+    /// pula, do której należy wątek
+    struct SearchPool *pool;
+    /// wątek systemowy (nieużywany przez wątek wywołujący)
+    pthread_t thread;
+    /// obszar roboczy wyszukiwań wątku
+    SearchWorkspace *ws;
+} PoolWorker;
+
+struct SearchPool {
+    /// liczba wątków
+    unsigned threads;
+    /// stany wątków; wątek 0 to wątek wywołujący zadania
+    PoolWorker *workers;
+    /// liczba uruchomionych wątków systemowych
+    unsigned started;
+    /// blokada chroniąca pozostałe pola
+    pthread_mutex_t lock;
+    /// zmienna warunkowa budząca wątki
+    pthread_cond_t wake;
+    /// zmienna warunkowa sygnalizująca zakończenie pracy wątków
+    pthread_cond_t done;
+    /// numer ostatniej zleconej serii zadań
+    unsigned generation;
+    /// czy wątki mają się zakończyć
+    bool quit;
+
+    /// zadanie bieżącej serii
+    SearchJob job;
+    /// wspólny argument zadań
+    void *arg;
+    /// liczba zadań serii
+    size_t count;
+    /// numer następnego zadania do rozpoczęcia
+    size_t next;
+    /// czy któreś zadanie się nie powiodło
+    bool failed;
+    /// liczba wątków systemowych pracujących nad bieżącą serią
+    unsigned busy;
+};
+
+/** @brief Wykonuje kolejne zadania bieżącej serii, dopóki jakieś zostały.
+ * @param[in,out] w     - stan wątku
+ */
+static void runJobs(PoolWorker *w) {
+    SearchPool *pool = w->pool;
+    while (true) {
+        pthread_mutex_lock(&pool->lock);
+        if (pool->failed || pool->next == pool->count) {
+            pthread_mutex_unlock(&pool->lock);
+            return;
+        }
+        size_t index = pool->next++;
+        pthread_mutex_unlock(&pool->lock);
+        if (!pool->job(pool->arg, w->ws, index)) {
+            pthread_mutex_lock(&pool->lock);
+            pool->failed = true;
+            pthread_mutex_unlock(&pool->lock);
+        }
+    }
+}
+
+/** @brief Główna pętla wątku systemowego puli.
+ * @param[in] arg       - stan wątku
+ * @return NULL
+ */
+static void *workerMain(void *arg) {
+    PoolWorker *w = arg;
+    SearchPool *pool = w->pool;
+    unsigned seen = 0;
+    while (true) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen && !pool->quit) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        seen = pool->generation;
+        bool quit = pool->quit;
+        pthread_mutex_unlock(&pool->lock);
+        if (quit) {
+            return NULL;
+        }
+        runJobs(w);
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+/** @brief Zatrzymuje uruchomione wątki puli.
+ * @param[in,out] pool  - pula
+ */
+static void stopWorkers(SearchPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->quit = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    for (unsigned t = 1; t <= pool->started; ++t) {
+        pthread_join(pool->workers[t].thread, NULL);
+    }
+    pool->started = 0;
+}
+
+SearchPool *newSearchPool(unsigned threads) {
+    CHECK_RET(threads > 0);
+    SearchPool *pool = calloc(1, sizeof(SearchPool));
+    CHECK_RET(pool);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    pool->threads = threads;
+    pool->workers = calloc(threads, sizeof(PoolWorker));
+    if (pool->workers == NULL) {
+        goto DELETE;
+    }
+    for (unsigned t = 0; t < threads; ++t) {
+        pool->workers[t].pool = pool;
+        pool->workers[t].ws = newSearchWorkspace();
+        if (pool->workers[t].ws == NULL) {
+            goto DELETE;
+        }
+    }
+    for (unsigned t = 1; t < threads; ++t) {
+        if (pthread_create(&pool->workers[t].thread, NULL, workerMain,
+                           &pool->workers[t]) != 0) {
+            goto DELETE;
+        }
+        pool->started = t;
+    }
+    return pool;
+
+DELETE:
+    deleteSearchPool(pool);
+    return NULL;
+}
+
+void deleteSearchPool(SearchPool *pool) {
+    if (pool == NULL) {
+        return;
+    }
+    stopWorkers(pool);
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+    for (unsigned t = 0; pool->workers != NULL && t < pool->threads; ++t) {
+        deleteSearchWorkspace(pool->workers[t].ws);
+    }
+    free(pool->workers);
+    free(pool);
+}
+
+Status selectPoolQueue(SearchPool *pool, QueueKind kind) {
+    for (unsigned t = 0; t < pool->threads; ++t) {
+        CHECK_RET(selectSearchQueue(pool->workers[t].ws, kind));
+    }
+    return true;
+}
+
+Status runSearchPool(SearchPool *pool, SearchJob job, void *arg,
+                     size_t count) {
+    pthread_mutex_lock(&pool->lock);
+    pool->job = job;
+    pool->arg = arg;
+    pool->count = count;
+    pool->next = 0;
+    pool->failed = false;
+    pool->busy = pool->started;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    runJobs(&pool->workers[0]);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    Status ret = !pool->failed;
+    pthread_mutex_unlock(&pool->lock);
+    return ret;
+}
+
+void mergePoolStats(SearchStats *total, SearchPool *pool) {
+    for (unsigned t = 0; t < pool->threads; ++t) {
+        mergeSearchStats(total, pool->workers[t].ws);
+    }
+}
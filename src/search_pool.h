@@ -0,0 +1,65 @@
+/** @file
+ * Pula wątków wykonujących współbieżnie niezależne wyszukiwania najkrótszych
+ * ścieżek.
+ */
+#ifndef __SEARCH_POOL_H__
+#define __SEARCH_POOL_H__
+
+#include "shortest_paths.h"
+
+/**
+ * Pula wątków, z których każdy ma własny obszar roboczy wyszukiwań.
+ * Zadania są rozdzielane między wątki dynamicznie, a wyniki zapisywane pod
+ * numerem zadania, więc nie zależą od przeplotu.
+ */
+typedef struct SearchPool SearchPool;
+
+/** @brief Zadanie wykonywane przez pulę.
+ * Może jedynie odczytywać mapę i zapisywać własny wynik.
+ * @param[in,out] arg       - wspólny argument zadań
+ * @param[in,out] ws        - obszar roboczy wątku wykonującego zadanie
+ * @param[in] index         - numer zadania
+ * @return Status powodzenia zadania - po niepowodzeniu pula nie rozpoczyna
+ * kolejnych zadań.
+ */
+typedef Status (*SearchJob)(void *arg, SearchWorkspace *ws, size_t index);
+
+/** @brief Tworzy pulę wątków.
+ * @param[in] threads       - liczba wątków (łącznie z wątkiem wywołującym
+ * zadania), co najmniej 1
+ * @return Wskaźnik na pulę lub NULL, gdy nie udało się zaalokować pamięci lub
+ * uruchomić wątków.
+ */
+SearchPool *newSearchPool(unsigned threads);
+
+/** @brief Zatrzymuje wątki i zwalnia pulę.
+ * @param[in,out] pool      - pula do zwolnienia
+ */
+void deleteSearchPool(SearchPool *pool);
+
+/** @brief Wybiera implementację kolejek priorytetowych obszarów roboczych.
+ * @param[in,out] pool      - pula
+ * @param[in] kind          - implementacja kolejki
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status selectPoolQueue(SearchPool *pool, QueueKind kind);
+
+/** @brief Wykonuje zadania o numerach od 0 do @p count - 1.
+ * Wraca po zakończeniu wszystkich rozpoczętych zadań.
+ * @param[in,out] pool      - pula
+ * @param[in] job           - zadanie
+ * @param[in,out] arg       - wspólny argument zadań
+ * @param[in] count         - liczba zadań
+ * @return Wartość @p true, jeśli wszystkie zadania się powiodły.
+ */
+Status runSearchPool(SearchPool *pool, SearchJob job, void *arg,
+                     size_t count);
+
+/** @brief Przenosi liczniki wyszukiwań z obszarów roboczych puli do
+ * @p total.
+ * @param[in,out] total     - liczniki, do których dodajemy
+ * @param[in,out] pool      - pula
+ */
+void mergePoolStats(SearchStats *total, SearchPool *pool);
+
+#endif /* __SEARCH_POOL_H__ */
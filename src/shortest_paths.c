@@ -2,159 +2,1045 @@
 #include <stdio.h>
 #include <string.h>
 
-#include "queue.h"
+#include "delta_stepping.h"
+#include "landmarks.h"
+#include "priority_queue.h"
+#include "road_graph.h"
 #include "shortest_paths.h"
 #include "utils.h"
 
 #define INFINITY UINT64_MAX
 
-/** @brief Iteruje po sąsiadach.
- * Iterację po sąsiadach wierzchołka należy zacząć od wywołania
- * nextNeighbour(NULL, 0, true). Kolejne wywołania funkcji nextNeighbour (z @p
- * reset false). zwracają kolejne odcinki dróg wychodzących z wierzchołka src.
- * Jeśli pomiędzy wywołaniem nextNeighbour(m, x, false) i nextNeighbour(m, y,
- * false) nie znalazło się wywołanie nextNeighbour(m, x, true), wynik operacji
- * jest nieokreślony.
- * @param map[in]       - mapa dróg
- * @param src[in]       - wierzchołek, którego sąsiadów przeglądamy
- * @param reset[in]     - zacznij od nowa iterację
- * @return kolejny z odcinków drogowych wychodzących z wierzchołka src.
- */
-static Road nextNeighbour(Map *map, int src, bool reset) {
-    static unsigned x;
-    if (reset) {
-        x = 0;
-        return (const Road){0};
-    }
-    Dictionary *neighbours = map->neighbours.arr[src];
-    do {
-        x = (x + 1) % neighbours->array_size;
-    } while (NOT_FOUND(neighbours->array[x]));
-    return *(Road *)(neighbours->array[x].val);
-}
-
-void freeStructures(uint64_t **dist, Queue *queue, bool **is_in_queue,
-                    int **time) {
-    free(queue->array);
-    free(*dist);
-    free(*is_in_queue);
-    free(*time);
-}
-
-static Status allocateStructures(int initial_vertex, size_t cities_no,
-                                 uint64_t **dist, Queue *queue,
-                                 bool **is_in_queue, int **time) {
-    *dist = NULL;
-    *is_in_queue = NULL;
-    *time = NULL;
-    *dist = malloc(cities_no * sizeof(uint64_t));
-    CHECK_RET(*dist);
-    for (size_t i = 0; i < cities_no; ++i) {
-        (*dist)[i] = INFINITY;
-    }
-    (*dist)[initial_vertex] = 0;
-    *is_in_queue = calloc(cities_no, sizeof(bool));
-    if (*is_in_queue == NULL) {
-        goto FREE_MEMORY;
-    }
-    *time = calloc(cities_no, sizeof(int));
-    if (*time == NULL) {
-        goto FREE_MEMORY;
-    }
-    for (size_t i = 0; i < cities_no; ++i) {
-        (*time)[i] = INT_MAX;
-    }
-    *queue = newQueue(cities_no);
-    if (queue->array == NULL) {
-        goto FREE_MEMORY;
-    }
-    pushQueueBegin(queue, initial_vertex);
+/// Dalej liczba ścieżek nie ma znaczenia - wystarczy wiedzieć, że nie jest
+/// jedyna.
+#define MANY_PATHS 2
+
+/**
+ * Struktury pomocnicze wyszukiwania z jednego końca.
+ * Wartości w tablicach są aktualne tylko dla wierzchołków, których znacznik
+ * jest równy pokoleniu bieżącego wyszukiwania - dzięki temu przygotowanie
+ * kolejnego wyszukiwania nie wymaga przeglądania całych tablic.
+ */
+typedef struct SearchState {
+    /// pokolenie bieżącego wyszukiwania
+    unsigned epoch;
+    /// wierzchołek, z którego prowadzone jest wyszukiwanie
+    int source;
+    /// wierzchołek, do którego prowadzone jest wyszukiwanie (nie jest on
+    /// rozwijany)
+    int sink;
+    /// długości najkrótszych ścieżek
+    uint64_t *dist;
+    /// najpóźniejszy możliwy rok najdawniej zbudowanego odcinka na
+    /// najkrótszej ścieżce
+    int *time;
+    /// tablica przodków w najlepszych ścieżkach
+    int *prev;
+    /// dolne ograniczenia odległości do celu
+    uint64_t *bound;
+    /// znaczniki pokolenia, w którym wierzchołek otrzymał etykietę
+    unsigned *labelled;
+    /// znaczniki pokolenia, w którym etykieta wierzchołka stała się ostateczna
+    unsigned *settled;
+    /// znaczniki pokolenia, w którym wierzchołek został zaznaczony jako
+    /// leżący na którejś z optymalnych ścieżek do celu
+    unsigned *in_dag;
+    /// liczba optymalnych ścieżek (obcięta do @ref MANY_PATHS)
+    unsigned char *ways;
+    /// wierzchołki w kolejności ustalania ich etykiet
+    int *order;
+    /// liczba wierzchołków o ustalonych etykietach
+    size_t settled_count;
+    /// liczba wierzchołków, do których dotarło wyszukiwanie
+    size_t touched_count;
+    /// stos wykorzystywany przy przeglądaniu optymalnych ścieżek
+    int *stack;
+    /// kolejka priorytetowa wierzchołków do przetworzenia
+    PriorityQueue queue;
+} SearchState;
+
+/**
+ * Struktura przechowująca stan wyszukiwań, wykorzystywana wielokrotnie.
+ */
+struct SearchWorkspace {
+    /// liczba wierzchołków, dla których zaalokowano tablice
+    size_t capacity;
+    /// pokolenie ostatniego wyszukiwania
+    unsigned epoch;
+    /// pokolenie bieżącego zbioru wykluczonych wierzchołków
+    unsigned exclusion_epoch;
+    /// znaczniki pokolenia, w którym wierzchołek został wykluczony
+    unsigned *excluded;
+    /// wierzchołki wykluczone w bieżącym pokoleniu (być może z powtórzeniami
+    /// i wierzchołkami przywróconymi później do wyszukiwania)
+    int *excluded_list;
+    /// liczba elementów @p excluded_list lub SIZE_MAX, jeśli lista się
+    /// przepełniła
+    size_t excluded_count;
+    /// liczba różnych wierzchołków wykluczonych w bieżącym pokoleniu
+    size_t exclusion_size;
+    /// suma skrótów wierzchołków wykluczonych w bieżącym pokoleniu
+    hash_t exclusion_hash;
+    /// wyszukiwania z początku i z końca ścieżki
+    SearchState sides[2];
+    /// liczniki pracy wykonanej przez wyszukiwania w tym obszarze roboczym
+    SearchStats stats;
+    /// implementacja kolejek priorytetowych wyszukiwań
+    QueueKind queue_kind;
+};
+
+/**
+ * Parametry zapytania o najkrótszą ścieżkę z A do B.
+ */
+typedef struct SearchQuery {
+    /// wierzchołek początkowy
+    int A;
+    /// wierzchołek końcowy
+    int B;
+    /// wykluczone wierzchołki
+    SearchWorkspace *ws;
+    /// czy bezpośrednia droga z A do B jest zabroniona
+    bool fixing;
+    /// indeks punktów orientacyjnych kierujący wyszukiwanie do celu lub NULL
+    const Landmarks *landmarks;
+    /// wierzchołki docelowe wyszukiwania z wieloma celami (nie są one
+    /// rozwijane) lub NULL
+    const int *targets;
+    /// liczba wierzchołków docelowych
+    size_t targets_no;
+} SearchQuery;
+
+/** @brief Zwalnia pamięć zajmowaną przez struktury pomocnicze.
+ * @param[in,out] s     - struktury do zwolnienia
+ */
+static void freeSearchState(SearchState *s) {
+    free(s->dist);
+    free(s->time);
+    free(s->prev);
+    free(s->bound);
+    free(s->labelled);
+    free(s->settled);
+    free(s->in_dag);
+    free(s->ways);
+    free(s->order);
+    free(s->stack);
+    deletePriorityQueue(&s->queue);
+}
+
+/** @brief Powiększa tablicę, nie tracąc jej zawartości.
+ * @param[in,out] array     - wskaźnik na tablicę
+ * @param[in] capacity      - nowa liczba elementów
+ * @param[in] size          - rozmiar elementu
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status growArray(void *array, size_t capacity, size_t size) {
+    void **p = array;
+    void *n = realloc(*p, capacity * size);
+    CHECK_RET(n);
+    *p = n;
+    return true;
+}
+
+/** @brief Powiększa tablice struktur pomocniczych.
+ * Znaczniki nowych wierzchołków są zerowane, więc ich wartości nie są
+ * aktualne w żadnym pokoleniu.
+ * @param[in,out] s         - struktury pomocnicze
+ * @param[in] old           - dotychczasowa pojemność tablic
+ * @param[in] capacity      - nowa pojemność tablic
+ * @param[in] kind          - implementacja kolejki, tworzonej przy pierwszym
+ * powiększeniu
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status growSearchState(SearchState *s, size_t old, size_t capacity,
+                              QueueKind kind) {
+    CHECK_RET(growArray(&s->dist, capacity, sizeof(uint64_t)));
+    CHECK_RET(growArray(&s->time, capacity, sizeof(int)));
+    CHECK_RET(growArray(&s->prev, capacity, sizeof(int)));
+    CHECK_RET(growArray(&s->bound, capacity, sizeof(uint64_t)));
+    CHECK_RET(growArray(&s->labelled, capacity, sizeof(unsigned)));
+    CHECK_RET(growArray(&s->settled, capacity, sizeof(unsigned)));
+    CHECK_RET(growArray(&s->in_dag, capacity, sizeof(unsigned)));
+    CHECK_RET(growArray(&s->ways, capacity, sizeof(unsigned char)));
+    CHECK_RET(growArray(&s->order, capacity, sizeof(int)));
+    CHECK_RET(growArray(&s->stack, capacity, sizeof(int)));
+    if (s->queue.heap.array == NULL) {
+        s->queue = newPriorityQueue(kind);
+        CHECK_RET(s->queue.heap.array);
+    }
+    size_t added = capacity - old;
+    memset(s->labelled + old, 0, added * sizeof(unsigned));
+    memset(s->settled + old, 0, added * sizeof(unsigned));
+    memset(s->in_dag + old, 0, added * sizeof(unsigned));
+    return true;
+}
+
+SearchWorkspace *newSearchWorkspace(void) {
+    SearchWorkspace *ws = calloc(1, sizeof(SearchWorkspace));
+    if (ws != NULL) {
+        ws->queue_kind = DEFAULT_QUEUE_KIND;
+    }
+    return ws;
+}
+
+Status selectSearchQueue(SearchWorkspace *ws, QueueKind kind) {
+    if (ws->queue_kind == kind) {
+        return true;
+    }
+    ws->queue_kind = kind;
+    for (int i = 0; i < 2; ++i) {
+        SearchState *s = &ws->sides[i];
+        if (s->queue.heap.array != NULL) {
+            deletePriorityQueue(&s->queue);
+            s->queue = newPriorityQueue(kind);
+            CHECK_RET(s->queue.heap.array);
+        }
+    }
+    return true;
+}
+
+void deleteSearchWorkspace(SearchWorkspace *ws) {
+    if (ws == NULL) {
+        return;
+    }
+    freeSearchState(&ws->sides[0]);
+    freeSearchState(&ws->sides[1]);
+    free(ws->excluded);
+    free(ws->excluded_list);
+    free(ws);
+}
+
+/** @brief Zapewnia, że tablice obszaru roboczego mieszczą @p cities_no
+ * wierzchołków.
+ * @param[in,out] ws        - obszar roboczy
+ * @param[in] cities_no     - liczba wierzchołków grafu
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status reserveWorkspace(SearchWorkspace *ws, size_t cities_no) {
+    if (cities_no <= ws->capacity) {
+        return true;
+    }
+    size_t capacity = 2 * ws->capacity;
+    if (capacity < cities_no) {
+        capacity = cities_no;
+    }
+    CHECK_RET(growArray(&ws->excluded, capacity, sizeof(unsigned)));
+    CHECK_RET(growArray(&ws->excluded_list, capacity, sizeof(int)));
+    for (int i = 0; i < 2; ++i) {
+        CHECK_RET(growSearchState(&ws->sides[i], ws->capacity, capacity,
+                                  ws->queue_kind));
+    }
+    memset(ws->excluded + ws->capacity, 0,
+           (capacity - ws->capacity) * sizeof(unsigned));
+    ws->capacity = capacity;
+    return true;
+}
+
+Status clearExclusions(SearchWorkspace *ws, size_t cities_no) {
+    CHECK_RET(reserveWorkspace(ws, cities_no));
+    if (++ws->exclusion_epoch == 0) {
+        memset(ws->excluded, 0, ws->capacity * sizeof(unsigned));
+        ws->exclusion_epoch = 1;
+    }
+    ws->excluded_count = 0;
+    ws->exclusion_size = 0;
+    ws->exclusion_hash = 0;
+    return true;
+}
+
+void excludeVertex(SearchWorkspace *ws, int v) {
+    if (ws->excluded[v] == ws->exclusion_epoch) {
+        return;
+    }
+    ws->exclusion_size++;
+    ws->exclusion_hash += hashMix((uint64_t)v);
+    if (ws->excluded_count != SIZE_MAX) {
+        ws->excluded_count = ws->excluded_count < ws->capacity
+                                 ? ws->excluded_count + 1
+                                 : SIZE_MAX;
+        if (ws->excluded_count != SIZE_MAX) {
+            ws->excluded_list[ws->excluded_count - 1] = v;
+        }
+    }
+    ws->excluded[v] = ws->exclusion_epoch;
+}
+
+void includeVertex(SearchWorkspace *ws, int v) {
+    if (ws->excluded[v] == ws->exclusion_epoch) {
+        ws->exclusion_size--;
+        ws->exclusion_hash -= hashMix((uint64_t)v);
+    }
+    ws->excluded[v] = 0;
+}
+
+bool isVertexExcluded(const SearchWorkspace *ws, int v) {
+    return ws->excluded[v] == ws->exclusion_epoch;
+}
+
+size_t excludedVertices(const SearchWorkspace *ws, const int **list) {
+    *list = ws->excluded_list;
+    return ws->excluded_count;
+}
+
+size_t exclusionSignature(const SearchWorkspace *ws, hash_t *hash) {
+    *hash = ws->exclusion_hash;
+    return ws->exclusion_size;
+}
+
+SearchStats *workspaceStats(SearchWorkspace *ws) { return &ws->stats; }
+
+int *searchPrev(SearchWorkspace *ws) { return ws->sides[0].prev; }
+
+void restoreSearchPath(SearchWorkspace *ws, const int *path, size_t length) {
+    int *prev = ws->sides[0].prev;
+    for (size_t i = 0; i < length; ++i) {
+        prev[path[i]] = i == 0 ? -1 : path[i - 1];
+    }
+}
+
+void mergeSearchStats(SearchStats *total, SearchWorkspace *ws) {
+    total->searches += ws->stats.searches;
+    total->settled += ws->stats.settled;
+    total->touched += ws->stats.touched;
+    total->cache_hits += ws->stats.cache_hits;
+    total->cache_misses += ws->stats.cache_misses;
+    ws->stats = (const SearchStats){0};
+}
+
+/** @brief Rozpoczyna nowe pokolenie wyszukiwań.
+ * @param[in,out] ws        - obszar roboczy
+ * @param[in] cities_no     - liczba wierzchołków grafu
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status beginSearch(SearchWorkspace *ws, size_t cities_no) {
+    CHECK_RET(reserveWorkspace(ws, cities_no));
+    if (++ws->epoch == 0) {
+        for (int i = 0; i < 2; ++i) {
+            SearchState *s = &ws->sides[i];
+            memset(s->labelled, 0, ws->capacity * sizeof(unsigned));
+            memset(s->settled, 0, ws->capacity * sizeof(unsigned));
+            memset(s->in_dag, 0, ws->capacity * sizeof(unsigned));
+        }
+        ws->epoch = 1;
+    }
     return true;
-FREE_MEMORY:
-    freeStructures(dist, queue, is_in_queue, time);
-    return false;
-}
-
-Status shortestPathsHelper(Map *map, int A, int B, uint64_t dist[],
-                           Queue *queue, bool is_in_queue[], int time[],
-                           bool visited[], int prev[], uint64_t *d, int *w,
-                           bool fixing, bool insert_begin) {
-    bool ret = false;
-
-    while (!isEmptyQueue(queue)) {
-        int x;
-        if (insert_begin) {
-            x = beginQueue(queue);
-            popQueueBegin(queue);
-        } else {
-            x = endQueue(queue);
-            popQueueEnd(queue);
-        }
-        if (visited[x] == true) {
+}
+
+/** @brief Zwraca długość najlepszej znanej ścieżki do wierzchołka.
+ * @param[in] s         - struktury pomocnicze wyszukiwania
+ * @param[in] v         - wierzchołek
+ * @return Długość ścieżki lub INFINITY, jeśli wyszukiwanie nie dotarło do @p v.
+ */
+static uint64_t distOf(SearchState *s, int v) {
+    return s->labelled[v] == s->epoch ? s->dist[v] : INFINITY;
+}
+
+/** @brief Zwraca rok najdawniej zbudowanego odcinka najlepszej znanej ścieżki.
+ * @param[in] s         - struktury pomocnicze wyszukiwania
+ * @param[in] v         - wierzchołek
+ * @return Rok lub INT_MAX, jeśli wyszukiwanie nie dotarło do @p v.
+ */
+static int timeOf(SearchState *s, int v) {
+    return s->labelled[v] == s->epoch ? s->time[v] : INT_MAX;
+}
+
+/** @brief Stwierdza, czy etykieta wierzchołka jest ostateczna.
+ * @param[in] s         - struktury pomocnicze wyszukiwania
+ * @param[in] v         - wierzchołek
+ * @return @p true jeśli etykieta @p v została ustalona.
+ */
+static bool isSettled(SearchState *s, int v) {
+    return s->settled[v] == s->epoch;
+}
+
+/** @brief Stwierdza, czy wierzchołek leży na którejś z optymalnych ścieżek.
+ * @param[in] s         - struktury pomocnicze wyszukiwania
+ * @param[in] v         - wierzchołek
+ * @return @p true jeśli @p v został zaznaczony przez @ref markOptimalDag.
+ */
+static bool isInDag(SearchState *s, int v) { return s->in_dag[v] == s->epoch; }
+
+/** @brief Nadaje wierzchołkowi etykietę.
+ * @param[in,out] s     - struktury pomocnicze wyszukiwania
+ * @param[in] v         - wierzchołek
+ * @param[in] dist      - długość ścieżki
+ * @param[in] time      - rok najdawniej zbudowanego odcinka ścieżki
+ * @param[in] prev      - poprzednik na ścieżce
+ */
+static void setLabel(SearchState *s, int v, uint64_t dist, int time,
+                     int prev) {
+    if (s->labelled[v] != s->epoch) {
+        s->labelled[v] = s->epoch;
+        s->touched_count++;
+    }
+    s->dist[v] = dist;
+    s->time[v] = time;
+    s->prev[v] = prev;
+}
+
+/** @brief Przygotowuje wyszukiwanie z jednego końca.
+ * @param[in,out] s     - struktury pomocnicze wyszukiwania
+ * @param[in] epoch     - pokolenie wyszukiwania
+ * @param[in] source    - wierzchołek, z którego prowadzimy wyszukiwanie
+ * @param[in] sink      - wierzchołek, do którego prowadzimy wyszukiwanie
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status beginSearchState(SearchState *s, unsigned epoch, int source,
+                               int sink) {
+    s->epoch = epoch;
+    s->source = source;
+    s->sink = sink;
+    s->settled_count = 0;
+    s->touched_count = 0;
+    clearPriorityQueue(&s->queue);
+    setLabel(s, source, 0, INT_MAX, -1);
+    return pushPriorityQueue(&s->queue, (HeapEntry){0, 0, INT_MAX, source});
+}
+
+/** @brief Stwierdza, czy odcinek drogowy jest wykluczony z wyszukiwania.
+ * @param[in] q         - zapytanie
+ * @param[in] road      - sprawdzany odcinek
+ * @return @p true jeśli odcinka nie wolno używać.
+ */
+static bool isForbidden(SearchQuery *q, Road road) {
+    return q->fixing && edgeKey(q->A, q->B) == edgeKey(road.start, road.end);
+}
+
+/** @brief Stwierdza, czy wierzchołek został wykluczony z wyszukiwania.
+ * @param[in] q         - zapytanie
+ * @param[in] v         - wierzchołek
+ * @return @p true jeśli przez @p v nie wolno przechodzić.
+ */
+static bool isExcluded(SearchQuery *q, int v) {
+    return isVertexExcluded(q->ws, v);
+}
+
+/** @brief Wyznacza dolne ograniczenie odległości z wierzchołka do celu
+ * wyszukiwania.
+ * @param[in] q         - zapytanie
+ * @param[in] s         - struktury pomocnicze wyszukiwania
+ * @param[in] v         - wierzchołek
+ * @return Dolne ograniczenie odległości z @p v do celu lub INFINITY, jeśli z
+ * @p v nie da się do niego dojechać.
+ */
+static uint64_t lowerBound(SearchQuery *q, SearchState *s, int v) {
+    if (q->landmarks == NULL) {
+        return 0;
+    }
+    if (q->targets_no == 0) {
+        return landmarkBound(q->landmarks, v, s->sink);
+    }
+    // minimum ograniczeń spełniających nierówność trójkąta również ją spełnia
+    uint64_t bound = INFINITY;
+    for (size_t i = 0; i < q->targets_no; ++i) {
+        uint64_t b = landmarkBound(q->landmarks, v, q->targets[i]);
+        bound = b < bound ? b : bound;
+    }
+    return bound;
+}
+
+/** @brief Wyznacza numer wierzchołka na liście celów zapytania.
+ * @param[in] q         - zapytanie
+ * @param[in] v         - wierzchołek
+ * @return Indeks @p v w @p q->targets lub -1, jeśli nie jest on celem.
+ */
+static int targetIndex(SearchQuery *q, int v) {
+    for (size_t i = 0; i < q->targets_no; ++i) {
+        if (q->targets[i] == v) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+/** @brief Stwierdza, czy wierzchołek jest celem wyszukiwania.
+ * @param[in] q         - zapytanie
+ * @param[in] s         - struktury pomocnicze wyszukiwania
+ * @param[in] v         - wierzchołek
+ * @return @p true jeśli do @p v prowadzimy wyszukiwanie.
+ */
+static bool isTarget(SearchQuery *q, SearchState *s, int v) {
+    return v == s->sink || targetIndex(q, v) != -1;
+}
+
+/** @brief Stwierdza, czy wyszukiwanie może przejść przez wierzchołek @p x.
+ * @param[in] q         - zapytanie
+ * @param[in] s         - struktury pomocnicze wyszukiwania
+ * @param[in] x         - wierzchołek
+ * @return @p true jeśli wolno rozwinąć wierzchołek @p x.
+ */
+static bool canExpand(SearchQuery *q, SearchState *s, int x) {
+    return !isTarget(q, s, x) && !isExcluded(q, x);
+}
+
+/** @brief Zwraca priorytet najbliższego nieprzetworzonego wierzchołka.
+ * Usuwa przy tym z kopca nieaktualne wpisy.
+ * @param[in,out] s     - struktury pomocnicze wyszukiwania
+ * @return Najmniejszy priorytet w kopcu (bez punktów orientacyjnych jest to
+ * odległość), lub INFINITY jeśli kopiec jest pusty.
+ */
+static uint64_t frontier(SearchState *s) {
+    PriorityQueue *queue = &s->queue;
+    while (!isEmptyPriorityQueue(queue) &&
+           isSettled(s, topPriorityQueue(queue).vertex)) {
+        popPriorityQueue(queue);
+    }
+    return isEmptyPriorityQueue(queue) ? INFINITY : topPriorityQueue(queue).key;
+}
+
+/** @brief Dodaje odległości, nie przekraczając INFINITY.
+ * @param[in] a         - pierwsza odległość
+ * @param[in] b         - druga odległość
+ * @return Suma odległości, lub INFINITY jeśli któraś z nich jest nieskończona.
+ */
+static uint64_t addDist(uint64_t a, uint64_t b) {
+    return (a == INFINITY || b == INFINITY) ? INFINITY : a + b;
+}
+
+/** @brief Ustala etykietę najbliższego wierzchołka i rozwija go.
+ * Etykieta (długość, rok) jest tym lepsza, im krótsza jest ścieżka, a przy
+ * równych długościach - im później zbudowano jej najdawniej zbudowany odcinek.
+ * Porządek ten jest zgodny z wydłużaniem ścieżek, więc etykieta wierzchołka
+ * zdjętego z kopca jest ostateczna. Jeśli zapytanie korzysta z punktów
+ * orientacyjnych, priorytetem wierzchołka jest długość ścieżki powiększona o
+ * dolne ograniczenie odległości do celu (wyszukiwanie A*). Ograniczenia
+ * spełniają nierówność trójkąta, więc priorytety nie maleją wzdłuż ścieżek, a
+ * przy równych priorytetach wierzchołek bliższy źródłu jest ustalany
+ * wcześniej - etykiety pozostają ostateczne, a poprzednicy na optymalnych
+ * ścieżkach są ustalani przed następnikami. Wierzchołki, z których nie da się
+ * dojechać do celu, są pomijane. Jeśli podano wyszukiwanie z drugiego
+ * końca, uaktualnia długość najkrótszej znanej ścieżki łączącej oba końce.
+ * Wywołanie wymaga, by funkcja @ref frontier zwróciła skończoną wartość.
+ * @param[in] map           - mapa dróg
+ * @param[in] q             - zapytanie
+ * @param[in,out] s         - struktury pomocnicze wyszukiwania
+ * @param[in] other         - wyszukiwanie z drugiego końca lub NULL
+ * @param[in,out] best      - długość najkrótszej znanej ścieżki
+ * @return Wierzchołek, którego etykieta została ustalona, lub -1 w przypadku
+ * błędu alokacji pamięci.
+ */
+static int settleNext(Map *map, SearchQuery *q, SearchState *s,
+                      SearchState *other, uint64_t *best) {
+    int x = topPriorityQueue(&s->queue).vertex;
+    popPriorityQueue(&s->queue);
+    s->settled[x] = s->epoch;
+    s->order[s->settled_count++] = x;
+    if (!canExpand(q, s, x)) {
+        return x;
+    }
+
+    RoadIterator it = iterateRoads(map->graph, x);
+    Road road;
+    while (nextRoad(&it, &road)) {
+        int y = road.end;
+        if (isSettled(s, y) || (isExcluded(q, y) && !isTarget(q, s, y)) ||
+            isForbidden(q, road)) {
             continue;
         }
-        is_in_queue[x] = false;
-
-        // reset counter
-        Road road = nextNeighbour(map, x, true);
-        Dictionary *neighbours = map->neighbours.arr[x];
-
-        for (size_t i = 0; i < neighbours->size; ++i) {
-            road = nextNeighbour(map, x, false);
-            if (fixing == false || encodeEdgeAsPtr(A, B) !=
-                                       encodeEdgeAsPtr(road.start, road.end)) {
-                bool p1 = dist[road.end] > road.length + dist[x];
-                bool p2 = dist[road.end] == road.length + dist[x];
-                if (p1 ||
-                    (p2 && time[road.end] <= min(time[x], road.builtYear))) {
-                    prev[road.end] = x;
-                    dist[road.end] = road.length + dist[x];
-                    time[road.end] = min(time[x], road.builtYear);
-                    if (is_in_queue[road.end] == false) {
-                        pushQueueEnd(queue, road.end);
-                        is_in_queue[road.end] = true;
-                    }
-                }
+        uint64_t dist = s->dist[x] + road.length;
+        int time = min(s->time[x], road.builtYear);
+        uint64_t old = distOf(s, y);
+        if (dist < old || (dist == old && time > s->time[y])) {
+            uint64_t bound = old == INFINITY ? lowerBound(q, s, y) : s->bound[y];
+            if (bound == INFINITY) {
+                continue;
+            }
+            setLabel(s, y, dist, time, x);
+            s->bound[y] = bound;
+            HeapEntry e = {dist + bound, dist, time, y};
+            if (!pushPriorityQueue(&s->queue, e)) {
+                return -1;
             }
         }
+        if (other != NULL && addDist(dist, distOf(other, y)) < *best) {
+            *best = dist + distOf(other, y);
+        }
     }
-    ret = true;
-    *d = dist[B];
-    *w = time[B];
+    return x;
+}
+
+/** @brief Stwierdza, czy odcinek z @p x do @p y leży na optymalnej ścieżce.
+ * @param[in] q         - zapytanie
+ * @param[in] s         - struktury pomocnicze z wyznaczonymi etykietami
+ * @param[in] road      - odcinek drogowy z @p x do @p y
+ * @param[in] threshold - rok najdawniej zbudowanego odcinka optymalnej ścieżki
+ * @return @p true jeśli odcinek może należeć do optymalnej ścieżki.
+ */
+static bool isTight(SearchQuery *q, SearchState *s, Road road, int threshold) {
+    int x = road.end;
+    int y = road.start;
+    return isSettled(s, x) && canExpand(q, s, x) && !isForbidden(q, road) &&
+           s->dist[x] + road.length == s->dist[y] &&
+           road.builtYear >= threshold;
+}
+
+/** @brief Zaznacza wierzchołki, przez które prowadzą optymalne ścieżki do
+ * @p root.
+ * Optymalne są najkrótsze ścieżki, których wszystkie odcinki zbudowano nie
+ * wcześniej, niż w roku @p threshold.
+ * @param[in] map           - mapa dróg
+ * @param[in] q             - zapytanie
+ * @param[in,out] s         - struktury pomocnicze z wyznaczonymi etykietami
+ * @param[in] root          - wierzchołek, do którego prowadzą ścieżki
+ * @param[in] threshold     - rok najdawniej zbudowanego odcinka
+ */
+static void markOptimalDag(Map *map, SearchQuery *q, SearchState *s, int root,
+                           int threshold) {
+    if (isInDag(s, root)) {
+        return;
+    }
+    size_t stack_size = 0;
+    s->stack[stack_size++] = root;
+    s->in_dag[root] = s->epoch;
+    while (stack_size > 0) {
+        int y = s->stack[--stack_size];
+        RoadIterator it = iterateRoads(map->graph, y);
+        Road road;
+        while (nextRoad(&it, &road)) {
+            int x = road.end;
+            if (isInDag(s, x) || !isTight(q, s, road, threshold)) {
+                continue;
+            }
+            s->in_dag[x] = s->epoch;
+            s->stack[stack_size++] = x;
+        }
+    }
+}
+
+/** @brief Liczy optymalne ścieżki do zaznaczonych wierzchołków.
+ * Przegląda wierzchołki w kolejności ustalania etykiet, sumując liczby ścieżek
+ * prowadzących do poprzedników.
+ * @param[in] map           - mapa dróg
+ * @param[in] q             - zapytanie
+ * @param[in,out] s         - struktury pomocnicze z zaznaczonymi
+ * wierzchołkami (@ref markOptimalDag)
+ * @param[in] threshold     - rok najdawniej zbudowanego odcinka
+ */
+static void countOptimalPaths(Map *map, SearchQuery *q, SearchState *s,
+                              int threshold) {
+    s->ways[s->source] = 1;
+    for (size_t i = 1; i < s->settled_count; ++i) {
+        int y = s->order[i];
+        if (!isInDag(s, y)) {
+            s->ways[y] = 0;
+            continue;
+        }
+        unsigned ways = 0;
+        RoadIterator it = iterateRoads(map->graph, y);
+        Road road;
+        while (nextRoad(&it, &road)) {
+            int x = road.end;
+            if (isInDag(s, x) && isTight(q, s, road, threshold)) {
+                ways += s->ways[x];
+            }
+        }
+        s->ways[y] = ways < MANY_PATHS ? ways : MANY_PATHS;
+    }
+}
+
+/** @brief Dolicza wyszukiwanie do liczników obszaru roboczego.
+ * @param[in,out] ws        - obszar roboczy
+ * @param[in] s             - struktury pomocnicze zakończonego wyszukiwania
+ */
+static void accountSearch(SearchWorkspace *ws, SearchState *s) {
+    ws->stats.settled += s->settled_count;
+    ws->stats.touched += s->touched_count;
+}
+
+/** @brief Odczytuje wynik wyszukiwania z jednego końca.
+ * Wymaga, by etykiety wszystkich wierzchołków bliższych niż B były
+ * ostateczne, a wierzchołki o ustalonych etykietach były uporządkowane
+ * według długości ścieżek.
+ * @param[in] map           - mapa dróg
+ * @param[in] q             - zapytanie
+ * @param[in,out] s         - struktury pomocnicze zakończonego wyszukiwania
+ * @param[out] d            - długość najkrótszej ścieżki do B lub INFINITY
+ * @param[out] w            - rok najdawniej zbudowanego odcinka ścieżki
+ * @return @p false jeśli do B prowadzi więcej niż jedna optymalna ścieżka,
+ * @p true wpp.
+ */
+static Status finishSearch(Map *map, SearchQuery *q, SearchState *s,
+                           uint64_t *d, int *w) {
+    *d = distOf(s, q->B);
+    *w = timeOf(s, q->B);
+    if (*d == INFINITY) {
+        return true;
+    }
+    markOptimalDag(map, q, s, q->B, *w);
+    countOptimalPaths(map, q, s, *w);
+    return s->ways[q->B] == 1;
+}
 
-    freeStructures(&dist, queue, &is_in_queue, &time);
+/** @brief Zwraca indeks punktów orientacyjnych mapy, o ile jest gotowy do
+ * użycia.
+ * @param[in] map           - mapa dróg
+ * @return Indeks punktów orientacyjnych lub NULL.
+ */
+static const Landmarks *usableLandmarks(Map *map) {
+    const Landmarks *lm = map->landmarks;
+    if (lm == NULL || lm->stale ||
+        lm->cities_no < map->city_to_int.table.size) {
+        return NULL;
+    }
+    return lm;
+}
+
+Status shortestPaths(Map *map, SearchWorkspace *ws, int A, int B, uint64_t *d,
+                     int *w, bool fixing) {
+    CHECK_RET(A != B);
+    CHECK_RET(beginSearch(ws, map->city_to_int.table.size));
+    SearchQuery q = {A, B, ws, fixing, usableLandmarks(map), NULL, 0};
+    SearchState *s = &ws->sides[0];
+    ws->stats.searches++;
+    CHECK_RET(beginSearchState(s, ws->epoch, A, B));
+    if (lowerBound(&q, s, A) == INFINITY) {
+        // B leży w innej spójnej składowej niż A
+        clearPriorityQueue(&s->queue);
+    }
+
+    // Wyszukiwanie kończy się w chwili ustalenia etykiety B - wszystkie
+    // wierzchołki, przez które prowadzą optymalne ścieżki do B, mają wówczas
+    // mniejsze priorytety i już ustalone etykiety.
+    Status ret = false;
+    uint64_t best = INFINITY;
+    while (!isSettled(s, B) && frontier(s) != INFINITY) {
+        if (settleNext(map, &q, s, NULL, &best) == -1) {
+            goto ACCOUNT;
+        }
+    }
+    ret = finishSearch(map, &q, s, d, w);
+ACCOUNT:
+    accountSearch(ws, s);
     return ret;
 }
 
-Status shortestPaths(Map *map, int A, int B, bool visited[], int prev[],
-                     uint64_t *d, int *w, bool fixing) {
-    size_t cities_no = map->city_to_int.size;
-    uint64_t *dist;
-    Queue queue;
-    bool *is_in_queue;
-    int *time;
-    int prev_cp[cities_no];
-    CHECK_RET(
-        allocateStructures(A, cities_no, &dist, &queue, &is_in_queue, &time));
-    CHECK_RET(shortestPathsHelper(map, A, B, dist, &queue, is_in_queue, time,
-                                  visited, prev, d, w, fixing, false));
-    for (size_t i = 0; i < cities_no; ++i) {
-        prev_cp[i] = prev[i];
-    }
-    CHECK_RET(
-        allocateStructures(A, cities_no, &dist, &queue, &is_in_queue, &time));
-    CHECK_RET(shortestPathsHelper(map, A, B, dist, &queue, is_in_queue, time,
-                                  visited, prev, d, w, fixing, true));
-    int id1 = B, id2 = B;
-    while (true) {
-        if (id1 != id2) {
-            return false;
-        }
-        if (id1 == -1 && id2 == -1) {
+Status shortestPathsParallel(Map *map, SearchWorkspace *ws,
+                             struct DeltaStepping *ds, int A, int B,
+                             uint64_t *d, int *w, bool fixing) {
+    CHECK_RET(A != B);
+    CHECK_RET(beginSearch(ws, map->city_to_int.table.size));
+    SearchQuery q = {A, B, ws, fixing, NULL, NULL, 0};
+    SearchState *s = &ws->sides[0];
+    ws->stats.searches++;
+    CHECK_RET(beginSearchState(s, ws->epoch, A, B));
+
+    // Etykiety są przepisywane w kolejności długości ścieżek, która jest
+    // zgodna z kolejnością wierzchołków na optymalnych ścieżkach.
+    Status ret = false;
+    const DeltaLabel *labels;
+    size_t count;
+    if (!deltaStepping(ds, map, ws, A, B, fixing, &labels, &count)) {
+        goto ACCOUNT;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        int v = labels[i].vertex;
+        setLabel(s, v, labels[i].dist, labels[i].time, labels[i].prev);
+        s->settled[v] = s->epoch;
+        s->order[s->settled_count++] = v;
+    }
+    ret = finishSearch(map, &q, s, d, w);
+ACCOUNT:
+    accountSearch(ws, s);
+    return ret;
+}
+
+/** @brief Usuwa zaznaczenia optymalnych ścieżek.
+ * Pozwala zaznaczyć optymalne ścieżki do kolejnego wierzchołka w tym samym
+ * drzewie wyszukiwania.
+ * @param[in,out] s     - struktury pomocnicze wyszukiwania
+ */
+static void clearOptimalDag(SearchState *s) {
+    for (size_t i = 0; i < s->settled_count; ++i) {
+        s->in_dag[s->order[i]] = 0;
+    }
+}
+
+Status shortestPathsFrom(Map *map, SearchWorkspace *ws, int A,
+                         const int *targets, size_t count, bool *unique) {
+    for (size_t i = 0; i < count; ++i) {
+        CHECK_RET(targets[i] != A);
+    }
+    CHECK_RET(beginSearch(ws, map->city_to_int.table.size));
+    SearchQuery q = {A, -1, ws, false, NULL, NULL, 0};
+    SearchState *s = &ws->sides[0];
+    ws->stats.searches++;
+    CHECK_RET(beginSearchState(s, ws->epoch, A, -1));
+
+    // Wyszukiwanie kończy się po ustaleniu etykiet wszystkich celów - etykiety
+    // bliższych wierzchołków są wtedy takie same, jak przy wyszukiwaniach do
+    // poszczególnych celów.
+    Status ret = false;
+    uint64_t best = INFINITY;
+    size_t next = 0;
+    while (frontier(s) != INFINITY) {
+        while (next < count && isSettled(s, targets[next])) {
+            next++;
+        }
+        if (next == count) {
             break;
         }
-        id1 = prev[id1];
-        id2 = prev_cp[id2];
+        if (settleNext(map, &q, s, NULL, &best) == -1) {
+            goto ACCOUNT;
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t d;
+        int w;
+        q.B = targets[i];
+        unique[i] = finishSearch(map, &q, s, &d, &w) && d != INFINITY;
+        clearOptimalDag(s);
+    }
+    ret = true;
+ACCOUNT:
+    accountSearch(ws, s);
+    return ret;
+}
+
+/** @brief Porównuje etykiety wierzchołków.
+ * @param[in] s         - struktury pomocnicze wyszukiwania
+ * @param[in] u         - pierwszy wierzchołek
+ * @param[in] v         - drugi wierzchołek
+ * @return @p true jeśli etykiety @p u i @p v są równe.
+ */
+static bool sameLabel(SearchState *s, int u, int v) {
+    return s->dist[u] == s->dist[v] && s->time[u] == s->time[v];
+}
+
+Status shortestPathsToNearest(Map *map, SearchWorkspace *ws, int A,
+                              const int *targets, size_t count, uint64_t *d,
+                              int *w, int *nearest) {
+    for (size_t i = 0; i < count; ++i) {
+        CHECK_RET(targets[i] != A);
+    }
+    CHECK_RET(beginSearch(ws, map->city_to_int.table.size));
+    SearchQuery q = {A, -1, ws, false, usableLandmarks(map), targets, count};
+    SearchState *s = &ws->sides[0];
+    ws->stats.searches++;
+    CHECK_RET(beginSearchState(s, ws->epoch, A, -1));
+    if (lowerBound(&q, s, A) == INFINITY) {
+        // żaden z celów nie leży w spójnej składowej A
+        clearPriorityQueue(&s->queue);
+    }
+
+    // Cele nie są rozwijane, a ograniczenie odległości celu od najbliższego
+    // celu jest równe 0, więc cel ustalony jako pierwszy ma najlepszą
+    // etykietę. Dalsze cele mogą mieć co najwyżej równą etykietę, a wtedy
+    // wybór nie jest jednoznaczny - wyszukiwanie trwa więc tylko dopóki
+    // priorytety nie przekroczą odległości najbliższego celu.
+    Status ret = false;
+    uint64_t best = INFINITY;
+    *nearest = -1;
+    while (frontier(s) != INFINITY &&
+           (*nearest == -1 || frontier(s) <= s->dist[targets[*nearest]])) {
+        int x = settleNext(map, &q, s, NULL, &best);
+        if (x == -1) {
+            goto ACCOUNT;
+        }
+        int i = targetIndex(&q, x);
+        if (i == -1) {
+            continue;
+        }
+        if (*nearest == -1) {
+            *nearest = i;
+        } else if (sameLabel(s, x, targets[*nearest])) {
+            goto ACCOUNT;
+        }
+    }
+    *d = INFINITY;
+    *w = INT_MAX;
+    ret = true;
+    if (*nearest != -1) {
+        q.B = targets[*nearest];
+        ret = finishSearch(map, &q, s, d, w);
+    }
+ACCOUNT:
+    accountSearch(ws, s);
+    return ret;
+}
+
+/**
+ * Odcinek, na którym spotykają się optymalne ścieżki wyszukiwań z obu końców.
+ */
+typedef struct Meeting {
+    /// wierzchołek ustalony przez wyszukiwanie z A
+    int x;
+    /// wierzchołek ustalony przez wyszukiwanie z B
+    int y;
+    /// rok najdawniej zbudowanego odcinka na najlepszej ścieżce przez odcinek
+    int time;
+    /// rok budowy odcinka
+    int builtYear;
+} Meeting;
+
+/**
+ * Tablica dynamiczna odcinków spotkania.
+ */
+typedef struct Meetings {
+    /// tablica odcinków
+    Meeting *array;
+    /// liczba odcinków
+    size_t size;
+    /// pojemność tablicy (zaalokowany rozmiar)
+    size_t capacity;
+} Meetings;
+
+/** @brief Dodaje odcinek spotkania na koniec tablicy.
+ * @param[in,out] meetings  - tablica odcinków
+ * @param[in] m             - odcinek do dodania
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status appendMeeting(Meetings *meetings, Meeting m) {
+    if (meetings->size == meetings->capacity) {
+        size_t capacity = meetings->capacity > 0 ? 2 * meetings->capacity : 4;
+        Meeting *n = realloc(meetings->array, capacity * sizeof(Meeting));
+        CHECK_RET(n);
+        meetings->array = n;
+        meetings->capacity = capacity;
+    }
+    meetings->array[meetings->size++] = m;
+    return true;
+}
+
+/** @brief Wyznacza odcinki, na których mogą się spotkać optymalne ścieżki.
+ * Każda najkrótsza ścieżka z A do B dzieli się jednoznacznie na początek
+ * złożony z wierzchołków bliższych A niż @p forward_radius (ustalonych przez
+ * wyszukiwanie z A), odcinek (x, y) oraz koniec złożony z wierzchołków
+ * ustalonych przez wyszukiwanie z B. Zapisuje w @p meetings wszystkie takie
+ * odcinki (x, y).
+ * @param[in] map               - mapa dróg
+ * @param[in] q                 - zapytanie
+ * @param[in] fwd               - wyszukiwanie z A
+ * @param[in] bwd               - wyszukiwanie z B
+ * @param[in] forward_radius    - odległość, do której wyszukiwanie z A
+ * ustaliło wszystkie etykiety
+ * @param[in] best              - długość najkrótszej ścieżki
+ * @param[out] meetings         - znalezione odcinki spotkania
+ * @return Status powodzenia alokacji pamięci.
+ */
+static Status findMeetings(Map *map, SearchQuery *q, SearchState *fwd,
+                           SearchState *bwd, uint64_t forward_radius,
+                           uint64_t best, Meetings *meetings) {
+    for (size_t i = 0; i < fwd->settled_count; ++i) {
+        int x = fwd->order[i];
+        if (fwd->dist[x] >= forward_radius || !canExpand(q, fwd, x)) {
+            continue;
+        }
+        RoadIterator it = iterateRoads(map->graph, x);
+        Road road;
+        while (nextRoad(&it, &road)) {
+            int y = road.end;
+            uint64_t dist = fwd->dist[x] + road.length;
+            if (!isSettled(bwd, y) || isForbidden(q, road) ||
+                (y != q->B && (isExcluded(q, y) || dist < forward_radius)) ||
+                addDist(dist, bwd->dist[y]) != best) {
+                continue;
+            }
+            int time = min(min(fwd->time[x], road.builtYear), bwd->time[y]);
+            CHECK_RET(appendMeeting(
+                meetings, (Meeting){x, y, time, road.builtYear}));
+        }
     }
     return true;
 }
+
+/** @brief Liczy optymalne ścieżki przechodzące przez odcinki spotkania.
+ * @param[in] map           - mapa dróg
+ * @param[in] q             - zapytanie
+ * @param[in,out] fwd       - wyszukiwanie z A
+ * @param[in,out] bwd       - wyszukiwanie z B
+ * @param[in] meetings      - odcinki spotkania
+ * @param[out] threshold    - rok najdawniej zbudowanego odcinka optymalnej
+ * ścieżki
+ * @param[out] meeting      - odcinek spotkania którejś z optymalnych ścieżek
+ * @return Liczba optymalnych ścieżek, obcięta do @ref MANY_PATHS.
+ */
+static unsigned countMeetingPaths(Map *map, SearchQuery *q, SearchState *fwd,
+                                  SearchState *bwd, Meetings *meetings,
+                                  int *threshold, Meeting *meeting) {
+    *threshold = INT_MIN;
+    for (size_t i = 0; i < meetings->size; ++i) {
+        if (meetings->array[i].time > *threshold) {
+            *threshold = meetings->array[i].time;
+        }
+    }
+    for (size_t i = 0; i < meetings->size; ++i) {
+        Meeting m = meetings->array[i];
+        if (m.builtYear >= *threshold && fwd->time[m.x] >= *threshold &&
+            bwd->time[m.y] >= *threshold) {
+            markOptimalDag(map, q, fwd, m.x, *threshold);
+            markOptimalDag(map, q, bwd, m.y, *threshold);
+        }
+    }
+    countOptimalPaths(map, q, fwd, *threshold);
+    countOptimalPaths(map, q, bwd, *threshold);
+
+    unsigned ways = 0;
+    for (size_t i = 0; i < meetings->size && ways < MANY_PATHS; ++i) {
+        Meeting m = meetings->array[i];
+        if (m.builtYear >= *threshold &&
+            fwd->ways[m.x] * bwd->ways[m.y] > 0) {
+            *meeting = m;
+            ways += fwd->ways[m.x] * bwd->ways[m.y];
+        }
+    }
+    return ways < MANY_PATHS ? ways : MANY_PATHS;
+}
+
+Status shortestPathsBidirectional(Map *map, SearchWorkspace *ws, int A, int B,
+                                  uint64_t *d, int *w, bool fixing) {
+    CHECK_RET(A != B);
+    CHECK_RET(beginSearch(ws, map->city_to_int.table.size));
+    SearchQuery q = {A, B, ws, fixing, NULL, NULL, 0};
+    SearchState *fwd = &ws->sides[0];
+    SearchState *bwd = &ws->sides[1];
+    ws->stats.searches++;
+    CHECK_RET(beginSearchState(fwd, ws->epoch, A, B));
+    CHECK_RET(beginSearchState(bwd, ws->epoch, B, A));
+
+    // Wyszukiwania z obu końców postępują naprzemiennie (rozwijając bliższy
+    // wierzchołek), aż każda ścieżka krótsza niż suma promieni obu
+    // wyszukiwań przekroczy długość najkrótszej znanej ścieżki - wówczas
+    // każdy wierzchołek najkrótszej ścieżki ma ustaloną etykietę z któregoś
+    // końca.
+    Status ret = false;
+    uint64_t best = INFINITY;
+    uint64_t rf = frontier(fwd), rb = frontier(bwd);
+    while (rf != INFINITY && rb != INFINITY && addDist(rf, rb) <= best) {
+        int x = rf <= rb ? settleNext(map, &q, fwd, bwd, &best)
+                         : settleNext(map, &q, bwd, fwd, &best);
+        if (x == -1) {
+            goto ACCOUNT;
+        }
+        rf = frontier(fwd);
+        rb = frontier(bwd);
+    }
+
+    *d = best;
+    *w = INT_MAX;
+    ret = true;
+    if (best != INFINITY) {
+        Meetings meetings = {0};
+        Meeting meeting = {0};
+        if (!findMeetings(map, &q, fwd, bwd, rf, best, &meetings)) {
+            free(meetings.array);
+            ret = false;
+            goto ACCOUNT;
+        }
+        ret = countMeetingPaths(map, &q, fwd, bwd, &meetings, w, &meeting) ==
+              1;
+        free(meetings.array);
+        if (ret) {
+            // przepisanie końca ścieżki (od B) do tablicy przodków
+            int x = meeting.x;
+            int y = meeting.y;
+            while (x != B) {
+                fwd->prev[y] = x;
+                x = y;
+                y = bwd->prev[y];
+            }
+        }
+    }
+ACCOUNT:
+    accountSearch(ws, fwd);
+    accountSearch(ws, bwd);
+    return ret;
+}
@@ -4,15 +4,225 @@
 #ifndef __SHORTEST_PATHS_H__
 #define __SHORTEST_PATHS_H__
 #include "map_struct.h"
+#include "priority_queue.h"
+
+struct DeltaStepping;
+
+/**
+ * Obszar roboczy wyszukiwań, wykorzystywany przez kolejne zapytania.
+ * Przechowuje tablice pomocnicze oraz zbiór wierzchołków wykluczonych z
+ * wyszukiwania. Tablice są oznaczane numerem pokolenia, więc koszt
+ * wyszukiwania zależy od liczby przejrzanych wierzchołków, a nie od rozmiaru
+ * mapy.
+ */
+typedef struct SearchWorkspace SearchWorkspace;
+
+/** @brief Tworzy pusty obszar roboczy wyszukiwań.
+ * @return Wskaźnik na obszar roboczy lub NULL, gdy nie udało się zaalokować
+ * pamięci.
+ */
+SearchWorkspace *newSearchWorkspace(void);
+
+/** @brief Zwalnia obszar roboczy wyszukiwań.
+ * @param[in,out] ws        - obszar roboczy do zwolnienia
+ */
+void deleteSearchWorkspace(SearchWorkspace *ws);
+
+/** @brief Wybiera implementację kolejek priorytetowych wyszukiwań.
+ * Domyślnie używana jest @ref DEFAULT_QUEUE_KIND.
+ * @param[in,out] ws        - obszar roboczy
+ * @param[in] kind          - implementacja kolejki
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status selectSearchQueue(SearchWorkspace *ws, QueueKind kind);
+
+/** @brief Opróżnia zbiór wierzchołków wykluczonych z wyszukiwania.
+ * Zapewnia również, że obszar roboczy mieści @p cities_no wierzchołków.
+ * @param[in,out] ws        - obszar roboczy
+ * @param[in] cities_no     - liczba wierzchołków grafu
+ * @return Status powodzenia alokacji pamięci.
+ */
+Status clearExclusions(SearchWorkspace *ws, size_t cities_no);
+
+/** @brief Wyklucza wierzchołek z wyszukiwania (nie wolno przez niego
+ * przechodzić).
+ * Wymaga wcześniejszego wywołania @ref clearExclusions.
+ * @param[in,out] ws        - obszar roboczy
+ * @param[in] v             - wykluczany wierzchołek
+ */
+void excludeVertex(SearchWorkspace *ws, int v);
+
+/** @brief Przywraca wykluczony wierzchołek do wyszukiwania.
+ * @param[in,out] ws        - obszar roboczy
+ * @param[in] v             - przywracany wierzchołek
+ */
+void includeVertex(SearchWorkspace *ws, int v);
+
+/** @brief Stwierdza, czy wierzchołek jest wykluczony z wyszukiwania.
+ * @param[in] ws            - obszar roboczy
+ * @param[in] v             - wierzchołek
+ * @return @p true jeśli przez @p v nie wolno przechodzić.
+ */
+bool isVertexExcluded(const SearchWorkspace *ws, int v);
+
+/** @brief Zwraca listę wierzchołków wykluczonych z wyszukiwania.
+ * Lista może zawierać powtórzenia oraz wierzchołki przywrócone później przez
+ * @ref includeVertex - należy je sprawdzić funkcją @ref isVertexExcluded.
+ * @param[in] ws            - obszar roboczy
+ * @param[out] list         - tutaj zapisywany jest wskaźnik na listę
+ * @return Długość listy lub SIZE_MAX, jeśli wykluczono więcej wierzchołków,
+ * niż lista może pomieścić.
+ */
+size_t excludedVertices(const SearchWorkspace *ws, const int **list);
+
+/** @brief Zwraca skrót zbioru wierzchołków wykluczonych z wyszukiwania.
+ * Skrót nie zależy od kolejności wykluczania i przywracania wierzchołków.
+ * @param[in] ws            - obszar roboczy
+ * @param[out] hash         - tutaj zapisywany jest skrót zbioru
+ * @return Liczba wykluczonych wierzchołków.
+ */
+size_t exclusionSignature(const SearchWorkspace *ws, hash_t *hash);
+
+/** @brief Zwraca liczniki pracy wykonanej w obszarze roboczym.
+ * Pozwala doliczyć do nich wyszukiwania prowadzone poza tym modułem.
+ * @param[in,out] ws        - obszar roboczy
+ * @return Wskaźnik na liczniki.
+ */
+SearchStats *workspaceStats(SearchWorkspace *ws);
+
+/** @brief Zwraca tablicę przodków ostatniego wyszukiwania.
+ * Najlepsza ścieżka do B pochodzi od prev[B], ta od prev[prev[B]] itd. aż do
+ * wierzchołka początkowego, dla którego prev jest równe -1. Wartości dla
+ * wierzchołków spoza tej ścieżki są nieokreślone, a tablica traci ważność
+ * przy kolejnym wyszukiwaniu.
+ * @param[in] ws            - obszar roboczy
+ * @return Tablica przodków.
+ */
+int *searchPrev(SearchWorkspace *ws);
+
+/** @brief Odtwarza tablicę przodków tak, jakby ostatnie wyszukiwanie
+ * znalazło podaną ścieżkę.
+ * Wymaga wcześniejszego wywołania @ref clearExclusions dla grafu
+ * zawierającego wszystkie wierzchołki ścieżki.
+ * @param[in,out] ws        - obszar roboczy
+ * @param[in] path          - kolejne wierzchołki ścieżki, od początkowego
+ * @param[in] length        - liczba wierzchołków ścieżki
+ */
+void restoreSearchPath(SearchWorkspace *ws, const int *path, size_t length);
+
+/** @brief Przenosi liczniki wyszukiwań z obszaru roboczego do @p total.
+ * @param[in,out] total     - liczniki, do których dodajemy
+ * @param[in,out] ws        - obszar roboczy, którego liczniki są zerowane
+ */
+void mergeSearchStats(SearchStats *total, SearchWorkspace *ws);
 
 /** @brief Znajduje najkrótrze ścieżki między wierzchołkami A i B.
+ * Wyszukiwanie jedynie odczytuje mapę, a cały jego stan przechowywany jest w
+ * obszarze roboczym - wyszukiwania korzystające z różnych obszarów roboczych
+ * mogą przebiegać współbieżnie, o ile mapa nie jest w tym czasie modyfikowana.
+ * Nie przechodzi przez wierzchołki wykluczone w obszarze roboczym (poza B).
+ * @param[in] map           - struktura mapy, na której wykonujemy wyszukania
+ * @param[in,out] ws        - obszar roboczy ze zbiorem wykluczonych
+ * wierzchołków, przygotowanym przez @ref clearExclusions
+ * @param[in] A             - wierzchołek początkowy
+ * @param[in] B             - wierzchołek końcowy
+ * @param[out] d            - tutaj zapisywana jest długość najkrótszej ścieżki;
+ * jeśli taka nie istnieje zwraca UINT64_MAX
+ * @param[out] w            - tutaj zapisywany jest czas ostatniej
+ *  naprawy/budowy drogi na znalezionej ścieżce.
+ * @param[in] fixing        - jeśli @p fixing jest prawdziwy, wzięcie
+ * bezpośredniej drogi z A do B jest zabronione
+ * @return Wartośc logiczna, czy udało się przeprowadzić wyszukiwanie - czy
+ * alokacje pamięci się powiodły, czy źródło jest różne od celu. Ścieżkę
+ * można odczytać z @ref searchPrev.
+ */
+Status shortestPaths(Map *map, SearchWorkspace *ws, int A, int B, uint64_t *d,
+                     int *w, bool fixing);
+
+/** @brief Znajduje najkrótszą ścieżkę z A do najbliższego z wierzchołków
+ * docelowych.
+ * Jedno wyszukiwanie zastępuje osobne wyszukiwania do każdego z celów: cele
+ * nie są rozwijane (ścieżka do jednego celu nie przechodzi przez inny), a
+ * wyszukiwanie kończy się, gdy pozostałe cele nie mogą już mieć równie
+ * dobrej etykiety jak najbliższy. Cel jest najbliższy, jeśli prowadzi do
+ * niego najkrótsza ścieżka, a przy równych długościach - ścieżka o
+ * najpóźniej zbudowanym najdawniejszym odcinku. Nie przechodzi przez
+ * wierzchołki wykluczone w obszarze roboczym (poza celami). Przodkowie na
+ * ścieżce do najbliższego celu są dostępni przez @ref searchPrev.
+ * @param[in] map           - struktura mapy, na której wykonujemy wyszukania
+ * @param[in,out] ws        - obszar roboczy ze zbiorem wykluczonych
+ * wierzchołków, przygotowanym przez @ref clearExclusions
+ * @param[in] A             - wierzchołek początkowy
+ * @param[in] targets       - różne wierzchołki docelowe
+ * @param[in] count         - liczba wierzchołków docelowych
+ * @param[out] d            - tutaj zapisywana jest długość najkrótszej ścieżki
+ * do najbliższego celu; jeśli żaden cel nie jest osiągalny - UINT64_MAX
+ * @param[out] w            - tutaj zapisywany jest czas ostatniej
+ *  naprawy/budowy drogi na znalezionej ścieżce.
+ * @param[out] nearest      - tutaj zapisywany jest indeks najbliższego celu
+ * w @p targets lub -1, jeśli żaden cel nie jest osiągalny
+ * @return Wartość @p false, jeśli nastąpił błąd alokacji pamięci, A jest
+ * jednym z celów, dwa cele są jednakowo bliskie lub do najbliższego celu
+ * prowadzi więcej niż jedna optymalna ścieżka, @p true wpp.
+ */
+Status shortestPathsToNearest(Map *map, SearchWorkspace *ws, int A,
+                              const int *targets, size_t count, uint64_t *d,
+                              int *w, int *nearest);
+
+/** @brief Znajduje najkrótsze ścieżki z A do wielu wierzchołków docelowych.
+ * Jedno drzewo wyszukiwania zastępuje osobne wyszukiwania @ref shortestPaths
+ * do każdego z celów (bez wykluczonych wierzchołków i zabronionych
+ * odcinków); dla każdego celu sprawdzane jest, czy prowadzi do niego
+ * dokładnie jedna optymalna ścieżka. Przodkowie na ścieżkach do wszystkich
+ * celów są dostępni przez @ref searchPrev.
+ * @param[in] map           - struktura mapy, na której wykonujemy wyszukania
+ * @param[in,out] ws        - obszar roboczy z pustym zbiorem wykluczonych
+ * wierzchołków, przygotowanym przez @ref clearExclusions
+ * @param[in] A             - wierzchołek początkowy
+ * @param[in] targets       - wierzchołki docelowe (mogą się powtarzać)
+ * @param[in] count         - liczba wierzchołków docelowych
+ * @param[out] unique       - tutaj zapisywane jest dla każdego celu, czy
+ * jest on osiągalny jedną optymalną ścieżką
+ * @return Wartość @p false, jeśli nastąpił błąd alokacji pamięci lub A jest
+ * jednym z celów, @p true wpp.
+ */
+Status shortestPathsFrom(Map *map, SearchWorkspace *ws, int A,
+                         const int *targets, size_t count, bool *unique);
+
+/** @brief Znajduje najkrótrze ścieżki między wierzchołkami A i B, prowadząc
+ * wyszukiwanie jednocześnie z obu końców.
+ * Parametry i wynik są takie same, jak w przypadku @ref shortestPaths.
+ * Wyszukiwania z A i z B spotykają się w połowie drogi, więc przeglądają mniej
+ * wierzchołków niż wyszukiwanie z jednego końca.
+ * @param[in] map           - struktura mapy, na której wykonujemy wyszukania
+ * @param[in,out] ws        - obszar roboczy ze zbiorem wykluczonych
+ * wierzchołków, przygotowanym przez @ref clearExclusions
+ * @param[in] A             - wierzchołek początkowy
+ * @param[in] B             - wierzchołek końcowy
+ * @param[out] d            - tutaj zapisywana jest długość najkrótszej ścieżki;
+ * jeśli taka nie istnieje zwraca UINT64_MAX
+ * @param[out] w            - tutaj zapisywany jest czas ostatniej
+ *  naprawy/budowy drogi na znalezionej ścieżce.
+ * @param[in] fixing        - jeśli @p fixing jest prawdziwy, wzięcie
+ * bezpośredniej drogi z A do B jest zabronione
+ * @return Wartośc logiczna, czy udało się przeprowadzić wyszukiwanie - czy
+ * alokacje pamięci się powiodły, czy źródło jest różne od celu.
+ */
+Status shortestPathsBidirectional(Map *map, SearchWorkspace *ws, int A, int B,
+                                  uint64_t *d, int *w, bool fixing);
+
+/** @brief Znajduje najkrótrze ścieżki między wierzchołkami A i B,
+ * przeglądając mapę równolegle metodą delta-stepping.
+ * Parametry i wynik są takie same, jak w przypadku @ref shortestPaths.
+ * Przeglądane są wszystkie wierzchołki bliższe niż B, ale wiele wątków
+ * rozwija je jednocześnie, co na bardzo dużych mapach skraca czas
+ * wyszukiwania.
  * @param[in] map           - struktura mapy, na której wykonujemy wyszukania
+ * @param[in,out] ws        - obszar roboczy ze zbiorem wykluczonych
+ * wierzchołków, przygotowanym przez @ref clearExclusions
+ * @param[in,out] ds        - pula wątków wyszukiwania
  * @param[in] A             - wierzchołek początkowy
  * @param[in] B             - wierzchołek końcowy
- * @param[in] visited       - tablica odwiedzonych wierzchołków (przez które nie
- * wolno przechodzić)
- * @param[in,out] prev      - tablica przodków w najlepszych ścieżkach
- * (najlepsza ścieżka do x pochodzi od prev[x])
  * @param[out] d            - tutaj zapisywana jest długość najkrótszej ścieżki;
  * jeśli taka nie istnieje zwraca UINT64_MAX
  * @param[out] w            - tutaj zapisywany jest czas ostatniej
@@ -22,6 +232,7 @@
  * @return Wartośc logiczna, czy udało się przeprowadzić wyszukiwanie - czy
  * alokacje pamięci się powiodły, czy źródło jest różne od celu.
  */
-Status shortestPaths(Map *map, int A, int B, bool visited[], int prev[],
-                     uint64_t *d, int *w, bool fixing);
+Status shortestPathsParallel(Map *map, SearchWorkspace *ws,
+                             struct DeltaStepping *ds, int A, int B,
+                             uint64_t *d, int *w, bool fixing);
 #endif /* __SHORTEST_PATHS_H__ */
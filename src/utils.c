@@ -1,17 +1,168 @@
 #include <inttypes.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <sys/random.h>
+#include <sys/types.h>
+#endif
 
 #include "list.h"
 #include "utils.h"
 
+/// Stałe mieszające funkcji skrótu napisów.
+static const uint64_t HASH_SECRET[4] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL,
+    0x4d5a2da51de1aa47ULL};
+
+/// Ziarno funkcji skrótu napisów, losowane raz na proces.
+static uint64_t hash_seed = 0;
+
+/// Zapewnia jednokrotne wylosowanie ziarna.
+static pthread_once_t hash_seed_once = PTHREAD_ONCE_INIT;
+
+/** @brief Czyta losowe bajty dostarczone przez system operacyjny.
+ * Korzysta z getrandom(2), a jeśli to się nie uda - z /dev/urandom.
+ * @param[out] buf          - bufor na losowe bajty
+ * @param[in] len           - liczba bajtów
+ * @return Wartość @p true, jeśli przeczytano wszystkie bajty, @p false wpp.
+ */
+static bool readSystemRandom(void *buf, size_t len) {
+#ifdef __linux__
+    if (getrandom(buf, len, 0) == (ssize_t)len) {
+        return true;
+    }
+#endif
+    FILE *f = fopen("/dev/urandom", "rb");
+    if (f == NULL) {
+        return false;
+    }
+    bool ok = fread(buf, 1, len, f) == len;
+    fclose(f);
+    return ok;
+}
+
+/** @brief Losuje ziarno funkcji skrótu napisów.
+ * Ziarno pochodzi z systemowego źródła losowości. Jeśli jest ono niedostępne,
+ * ziarno łączy czas uruchomienia z adresami, które przy losowym układzie
+ * przestrzeni adresowej zmieniają się między uruchomieniami.
+ */
+static void drawHashSeed(void) {
+    if (readSystemRandom(&hash_seed, sizeof(hash_seed))) {
+        return;
+    }
+    int local;
+    uint64_t seed = hashMix((uint64_t)time(NULL));
+    seed = hashMix(seed ^ (uint64_t)clock());
+    seed = hashMix(seed ^ (uint64_t)(uintptr_t)&hash_seed);
+    seed = hashMix(seed ^ (uint64_t)(uintptr_t)&local);
+    hash_seed = seed;
+}
+
+void seedStringHash(void) { pthread_once(&hash_seed_once, drawHashSeed); }
+
+/** @brief Mnoży liczby 64-bitowe, wyznaczając pełny 128-bitowy iloczyn.
+ * Jeśli kompilator nie udostępnia typu 128-bitowego, składa iloczyn z
+ * czterech mnożeń 32 x 32 -> 64 bity.
+ * @param[in] a          - pierwszy czynnik
+ * @param[in] b          - drugi czynnik
+ * @param[out] lo        - dolna połowa iloczynu
+ * @param[out] hi        - górna połowa iloczynu
+ */
+static inline void mul128(uint64_t a, uint64_t b, uint64_t *lo, uint64_t *hi) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 r = (unsigned __int128)a * b;
+    *lo = (uint64_t)r;
+    *hi = (uint64_t)(r >> 64);
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi;
+    uint64_t hl = a_hi * b_lo, hh = a_hi * b_hi;
+    uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+    *lo = (mid << 32) | (uint32_t)ll;
+    *hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+/** @brief Mnoży liczby 64-bitowe i składa obie połowy iloczynu.
+ * @param[in] a          - pierwszy czynnik
+ * @param[in] b          - drugi czynnik
+ * @return Alternatywa wykluczająca dolnej i górnej połowy iloczynu.
+ */
+static inline uint64_t mulFold(uint64_t a, uint64_t b) {
+    uint64_t lo, hi;
+    mul128(a, b, &lo, &hi);
+    return lo ^ hi;
+}
+
+/** @brief Czyta 8 bajtów napisu jako liczbę.
+ * @param[in] p          - pierwszy bajt
+ * @return Wczytana liczba.
+ */
+static inline uint64_t read8(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/** @brief Czyta 4 bajty napisu jako liczbę.
+ * @param[in] p          - pierwszy bajt
+ * @return Wczytana liczba.
+ */
+static inline uint64_t read4(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
 hash_t nHashString(void *str, size_t len) {
-    const uint8_t *c = str;
-    hash_t ret = 0;
-    for (size_t i = 0; i < len; ++i) {
-        ret = ret * 149 + c[i];
+    // Wariant funkcji wyhash: każde 16 bajtów jest mieszane z ziarnem przez
+    // mnożenie 64 x 64 -> 128 bitów, więc bez znajomości ziarna nie da się
+    // dobrać napisów o równych skrótach.
+    const uint8_t *p = str;
+    uint64_t seed = hash_seed ^ mulFold(hash_seed ^ HASH_SECRET[0],
+                                         HASH_SECRET[1]);
+    uint64_t a, b;
+    if (len <= 16) {
+        if (len >= 4) {
+            size_t shift = (len >> 3) << 2;
+            a = (read4(p) << 32) | read4(p + shift);
+            b = (read4(p + len - 4) << 32) | read4(p + len - 4 - shift);
+        } else if (len > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) |
+                p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t seed1 = seed, seed2 = seed;
+            do {
+                seed = mulFold(read8(p) ^ HASH_SECRET[1], read8(p + 8) ^ seed);
+                seed1 = mulFold(read8(p + 16) ^ HASH_SECRET[2],
+                                read8(p + 24) ^ seed1);
+                seed2 = mulFold(read8(p + 32) ^ HASH_SECRET[3],
+                                read8(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (i > 16) {
+            seed = mulFold(read8(p) ^ HASH_SECRET[1], read8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = read8(p + i - 16);
+        b = read8(p + i - 8);
     }
-    return ret;
+    mul128(a ^ HASH_SECRET[1], b ^ seed, &a, &b);
+    return mulFold(a ^ HASH_SECRET[0] ^ len, b ^ HASH_SECRET[1]);
 }
 
 hash_t hashString(void *str) { return nHashString(str, strlen((char *)str)); }
@@ -52,15 +203,6 @@ bool possiblyValidRoad(const char *city1, const char *city2) {
     return true;
 }
 
-hash_t hashEdge(void *key) { return (hash_t)key; }
-
-bool cmpEdges(void *e1, void *e2) {
-    if (e1 == NULL || e1 == DELETED || e2 == NULL || e2 == DELETED) {
-        return false;
-    }
-    return e1 == e2;
-}
-
 size_t intLength(int64_t x) {
     // 3 == ceil(log10(256))
     char b[sizeof(x) * 3 + 1];
@@ -68,27 +210,11 @@ size_t intLength(int64_t x) {
     return strlen(b);
 }
 
-void *encodeCityId(int id) {
-    uint64_t ret = id;
-    ret <<= 32;
-    ret |= 3;
-    return (void *)ret;
-}
-
-void *encodeEdgeAsPtr(int a, int b) {
-    uint64_t ret = 0;
-    if (a <= b) {
-        ret |= a;
-        ret |= ((uint64_t)b) << 32;
-    } else {
-        return encodeEdgeAsPtr(b, a);
+uint64_t edgeKey(int a, int b) {
+    if (a > b) {
+        return edgeKey(b, a);
     }
-    return (void *)ret;
-}
-
-int decodeCityId(void *p) {
-    uint64_t x = (uint64_t)p;
-    return x >> 32;
+    return (uint64_t)(unsigned)a | ((uint64_t)(unsigned)b << 32);
 }
 
 inline int min(int a, int b) {
@@ -98,18 +224,11 @@ inline int min(int a, int b) {
     return b;
 }
 
-hash_t hashInt(void *p) {
-    unsigned *c = p;
-    return *c;
-}
-
-bool equalInt(void *p1, void *p2) {
-    CHECK_RET(p1);
-    CHECK_RET(p2);
-    if (p1 == DELETED || p2 == DELETED) {
-        return false;
-    }
-    return 0 == memcmp(p1, p2, sizeof(int));
+hash_t hashMix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
 }
 
 void swap(int *x, int *y) {
@@ -7,6 +7,13 @@
 #include "dictionary.h"
 #include "vector.h"
 
+/** @brief Losuje ziarno funkcji skrótu napisów, o ile jeszcze go nie
+ * wylosowano.
+ * Ziarno jest wspólne dla całego procesu, więc musi być wylosowane przed
+ * utworzeniem pierwszego słownika z napisami jako kluczami.
+ */
+void seedStringHash(void);
+
 /** @brief Skraca stringa podanego na wejściu.
  * Skraca stringa, tak aby można go było umieścić słowniku.
  * @param[in] str      - napis w stylu C do skrócenia.
@@ -16,6 +23,8 @@ hash_t hashString(void *str);
 
 /** @brief Skraca stringa podanego na wejściu, czytając maksymalnie @p len
  * bajtów. Skraca stringa, tak aby można go było umieścić słowniku.
+ * Skrót zależy od ziarna (zob. @ref seedStringHash), więc nie da się z góry
+ * dobrać wielu napisów o tym samym skrócie.
  * @param[in] str      - napis w stylu C do skrócenia.
  * @param[in] len      - maksymalna przeczytana długośc napisu.
  * @return Skrót stringa.
@@ -63,15 +72,6 @@ bool nValidCityName(const char *city, size_t n);
  */
 bool possiblyValidRoad(const char *city1, const char *city2);
 
-/** @brief Porównuje (stwierdza równość bądź różność) krawędzi.
- * Krawędzie są równe, jeśli zbiory ich końców są równe. Nadaje się do
- * stosowania w słowniku.
- * @param[in] e1          - krawędź pierwsza
- * @param[in] e2          - krawędź druga
- * @return Wartość logiczna określająca równość @p e1 i @p e2.
- */
-bool cmpEdges(void *e1, void *e2);
-
 /** @brief Znajduje długość liczby całkowitej w zapisie dziesiętnym.
  * @param[in] x       - liczba, której długości szukamy
  * @return Długośc zapisu dziesiętnego (wraz z ewentualnym znakiem '-')
@@ -79,33 +79,13 @@ bool cmpEdges(void *e1, void *e2);
  */
 size_t intLength(int64_t x);
 
-/** @brief Zakodowuje drogę jako wskaźnik, który można wstawić do słownika.
- * encodeEdgeAsPtr(a, b) == encodeEdgeAsPtr(b, a)
+/** @brief Koduje drogę jako liczbę, której można użyć jako klucza.
+ * edgeKey(a, b) == edgeKey(b, a)
  * @param[in] a       - początek drogi
  * @param[in] b       - koniec drogi
- * @return Wskaźnik reprezentujący drogę z @p a do @p b (i na odwrót).
- */
-void *encodeEdgeAsPtr(int a, int b);
-
-/** @brief Koduje liczbę jako wskaźnik, który można wstawić do słownika.
- * @param[in] id      - liczba do zakodowania
- * @return Wskaźnik unikalnie reprezentujący liczbę @p id
+ * @return Liczba reprezentująca drogę z @p a do @p b (i na odwrót).
  */
-void *encodeCityId(int id);
-
-/** @brief Funkcja odwrotna do @ref encodeCityId.
- * Dekoduje wskaźnik jako liczbę, by móc operować na wartości po wyjęciu ze
- * słownika.
- * @param[in] p       - wskaźnik do dekodowania
- * @return
- */
-int decodeCityId(void *p);
-
-/** @brief Funkcja skrótu dla krawędzi.
- * @param[in] key     - krawędź zakodowana za pomocą @ref encodeEdgeAsPtr
- * @return Skrót (hasz) krawędzi.
- */
-hash_t hashEdge(void *key);
+uint64_t edgeKey(int a, int b);
 
 /** @brief Wybiera mniejszą z dwóch liczb.
  * @param[in] a          - pierwsza z liczb
@@ -114,18 +94,12 @@ hash_t hashEdge(void *key);
  */
 int min(int a, int b);
 
-/** @brief Funkcja skrótu dla liczb całkowitych (int)
- * @param[in] p          - liczba całkowita do skrócenia
- * @return
- */
-hash_t hashInt(void *p);
-
-/** @brief Porównuje dwie liczby
- * @param[in] p1         - pierwsza z liczb do porównania
- * @param[in] p2         - druga z liczb do porównania
- * @return wartośc logiczna czy p1 jest równe p2
+/** @brief Miesza bity liczby, tak by skróty bliskich liczb były niezależne.
+ * Pozwala budować skróty zbiorów jako sumy skrótów elementów.
+ * @param[in] x          - liczba do wymieszania
+ * @return Skrót (hasz) liczby.
  */
-bool equalInt(void *p1, void *p2);
+hash_t hashMix(uint64_t x);
 
 /** @brief Usuwa wektor list, zwalniając przeznaczoną na elementy pamięć.
  * @param[in,out] vector - wektor do opróżnienia